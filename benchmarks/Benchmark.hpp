@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// A minimal benchmark harness. Benchmarks are registered statically with BENCHMARK, and each invocation of the
+/// body is timed as one iteration. Allocations made during the iteration are counted by the harness.
+namespace benchmark
+{
+using Function = std::function<void()>;
+
+struct Registration
+{
+    Registration(const char* name, Function function);
+};
+
+struct Result
+{
+    std::string name;
+    size_t iterations = 0;
+    double nanosecondsPerIteration = 0;
+    double allocationsPerIteration = 0;
+    double allocatedBytesPerIteration = 0;
+};
+
+/// Runs all registered benchmarks whose name contains the filter
+std::vector<Result> runAll(const std::string& filter);
+
+/// Prevents the compiler from optimizing away the computation of a value
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+} // namespace benchmark
+
+#define BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_IMPL(a, b)
+#define BENCHMARK(name) \
+    static void name(); \
+    static benchmark::Registration BENCHMARK_CONCAT(name, _registration)(#name, name); \
+    static void name()
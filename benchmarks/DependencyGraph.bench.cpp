@@ -0,0 +1,51 @@
+#include "Benchmark.hpp"
+#include "LSP/DependencyGraph.hpp"
+
+// Find All References, Rename and incoming calls look up the transitive dependents of a module in the workspace require graph.
+// These benchmarks use a generated 15k-module workspace, where each module requires a few others
+
+static constexpr uint32_t kModuleCount = 15000;
+
+static std::vector<InternedId> dependenciesOf(uint32_t module)
+{
+    std::vector<InternedId> dependencies;
+    for (uint32_t dependency = 1; dependency <= 4; dependency++)
+        dependencies.push_back({(module + dependency * 37) % kModuleCount});
+    return dependencies;
+}
+
+static DependencyGraph& workspaceGraph()
+{
+    static DependencyGraph graph;
+    if (!graph.isPopulated())
+    {
+        for (uint32_t i = 0; i < kModuleCount; i++)
+            graph.setDependencies({i}, dependenciesOf(i));
+        graph.markPopulated();
+    }
+    return graph;
+}
+
+BENCHMARK(dependency_graph_build_15k)
+{
+    DependencyGraph graph;
+    for (uint32_t i = 0; i < kModuleCount; i++)
+        graph.setDependencies({i}, dependenciesOf(i));
+    benchmark::doNotOptimize(graph);
+}
+
+BENCHMARK(dependency_graph_reparse_one_module)
+{
+    // A module is re-parsed after an edit, changing one of its requires and then changing it back
+    auto& graph = workspaceGraph();
+    auto dependencies = dependenciesOf(42);
+    dependencies.back() = {7};
+    graph.setDependencies({42}, dependencies);
+    graph.setDependencies({42}, dependenciesOf(42));
+}
+
+BENCHMARK(dependency_graph_transitive_dependents_15k)
+{
+    // Every module is reachable from every other, so this visits the whole workspace
+    benchmark::doNotOptimize(workspaceGraph().transitiveDependents({1234}));
+}
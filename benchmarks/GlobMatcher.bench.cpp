@@ -0,0 +1,42 @@
+#include "Benchmark.hpp"
+#include "LSP/GlobMatcher.hpp"
+#include "glob/glob.hpp"
+
+// Tests 10k workspace-relative paths against a typical set of ignore globs, as indexing and workspace diagnostics do for every file.
+// The legacy version is what isIgnoredFile did before, building a std::regex from each pattern for every path
+
+static const std::vector<std::string> kPatterns = {"**/_Index/**", "Packages/**", "DevPackages/**", "**/*.spec.luau"};
+
+static const std::vector<std::string>& relativePaths()
+{
+    static std::vector<std::string> paths = []
+    {
+        std::vector<std::string> result;
+        for (size_t i = 0; i < 10000; i++)
+            result.push_back("src/shared/Folder" + std::to_string(i / 100) + "/Module" + std::to_string(i) + (i % 10 == 0 ? ".spec.luau" : ".luau"));
+        return result;
+    }();
+    return paths;
+}
+
+BENCHMARK(glob_ignore_10k_legacy)
+{
+    for (const auto& path : relativePaths())
+    {
+        bool ignored = false;
+        for (const auto& pattern : kPatterns)
+            if (glob::fnmatch_case(path, pattern))
+            {
+                ignored = true;
+                break;
+            }
+        benchmark::doNotOptimize(ignored);
+    }
+}
+
+BENCHMARK(glob_ignore_10k)
+{
+    GlobMatcher matcher(kPatterns);
+    for (const auto& path : relativePaths())
+        benchmark::doNotOptimize(matcher.matches(path));
+}
@@ -0,0 +1,66 @@
+#include "Benchmark.hpp"
+#include "LSP/IndexCache.hpp"
+
+// On startup, every indexed module is looked up in the index cache. These benchmarks restore a generated 15k-module workspace,
+// where each module requires a few others and declares a handful of symbols
+
+static constexpr size_t kModuleCount = 15000;
+
+static std::string moduleName(size_t i)
+{
+    return "game/ReplicatedStorage/Folder" + std::to_string(i / 100) + "/Module" + std::to_string(i);
+}
+
+static const std::unordered_map<std::string, IndexedModule>& workspaceModules()
+{
+    static std::unordered_map<std::string, IndexedModule> modules = []
+    {
+        std::unordered_map<std::string, IndexedModule> result;
+        for (size_t i = 0; i < kModuleCount; i++)
+        {
+            IndexedModule module;
+            module.contentHash = i;
+            for (size_t dependency = 1; dependency <= 4; dependency++)
+                module.requireLocations.emplace_back(moduleName((i + dependency * 37) % kModuleCount),
+                    Luau::Location{{static_cast<unsigned>(dependency), 14}, {static_cast<unsigned>(dependency), 60}});
+            module.exportedTypes = {"State", "Options"};
+            for (size_t symbol = 0; symbol < 8; symbol++)
+                module.symbols.push_back(
+                    {"symbol" + std::to_string(symbol), lsp::SymbolKind::Function, {{static_cast<unsigned>(10 + symbol), 9}, {10, 20}}});
+            result.emplace(moduleName(i), std::move(module));
+        }
+        return result;
+    }();
+    return modules;
+}
+
+static const std::filesystem::path& cachePath()
+{
+    static std::filesystem::path path = []
+    {
+        auto path = std::filesystem::temp_directory_path() / "luau-lsp-benchmark-index.bin";
+        IndexCache::save(path, "benchmark", workspaceModules());
+        return path;
+    }();
+    return path;
+}
+
+BENCHMARK(index_cache_save_15k)
+{
+    benchmark::doNotOptimize(IndexCache::save(std::filesystem::temp_directory_path() / "luau-lsp-benchmark-index-save.bin", "benchmark", workspaceModules()));
+}
+
+BENCHMARK(index_cache_restore_15k)
+{
+    auto cache = IndexCache::load(cachePath(), "benchmark");
+    for (size_t i = 0; i < kModuleCount; i++)
+        benchmark::doNotOptimize(cache.find(moduleName(i), i));
+}
+
+BENCHMARK(index_cache_hash_source_15k)
+{
+    // Roughly the size of a typical module
+    static std::string source(8 * 1024, 'x');
+    for (size_t i = 0; i < kModuleCount; i++)
+        benchmark::doNotOptimize(hashIndexContent(source));
+}
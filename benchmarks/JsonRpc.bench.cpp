@@ -0,0 +1,115 @@
+#include "Benchmark.hpp"
+#include "LSP/JsonRpc.hpp"
+
+#include <sstream>
+
+// Compares framing and parsing of large incoming messages against the previous implementation, which read headers
+// with std::getline, parsed the entire message into a DOM and then copied the params out of it
+
+static std::string makeLargeSource()
+{
+    std::string source;
+    source.reserve(2 * 1024 * 1024);
+    for (size_t i = 0; source.size() < 2 * 1024 * 1024; i++)
+        source += "local value" + std::to_string(i) + " = { name = \"generated\", index = " + std::to_string(i) + " } -- \"quoted\"\n";
+    return source;
+}
+
+static std::string frame(const json& message)
+{
+    std::string buffer;
+    json_rpc::writeRawMessage(buffer, message);
+    return buffer;
+}
+
+static std::istringstream& didOpenInput()
+{
+    static std::istringstream input(frame(json{{"jsonrpc", "2.0"}, {"method", "textDocument/didOpen"},
+        {"params", {{"textDocument", {{"uri", "file:///generated.luau"}, {"languageId", "luau"}, {"version", 1}, {"text", makeLargeSource()}}}}}}));
+    return input;
+}
+
+static std::istringstream& didChangeInput()
+{
+    static std::istringstream input(frame(json{{"jsonrpc", "2.0"}, {"method", "textDocument/didChange"},
+        {"params", {{"textDocument", {{"uri", "file:///generated.luau"}, {"version", 2}}}, {"contentChanges", {{{"text", makeLargeSource()}}}}}}}));
+    return input;
+}
+
+static std::istringstream& rewind(std::istringstream& input)
+{
+    input.clear();
+    input.seekg(0);
+    return input;
+}
+
+static bool legacyReadRawMessage(std::istream& input, std::string& output)
+{
+    unsigned int contentLength = 0;
+    std::string line;
+    while (true)
+    {
+        if (!input)
+            return false;
+        std::getline(input, line);
+        if (Luau::startsWith(line, "Content-Length: "))
+        {
+            std::string len = line.substr(16);
+            trim_end(len);
+            contentLength = std::stoi(len);
+            continue;
+        }
+        trim_end(line);
+        if (line.empty())
+            break;
+    }
+    output.resize(contentLength);
+    input.read(&output[0], contentLength);
+    return true;
+}
+
+static std::optional<json> legacyParseParams(const std::string& jsonString)
+{
+    auto j = json::parse(jsonString);
+    std::optional<json> params;
+    if (j.contains("params"))
+        params = j.at("params");
+    return params;
+}
+
+BENCHMARK(jsonrpc_didOpen_2mb_legacy)
+{
+    std::string body;
+    legacyReadRawMessage(rewind(didOpenInput()), body);
+    benchmark::doNotOptimize(legacyParseParams(body));
+}
+
+BENCHMARK(jsonrpc_didOpen_2mb)
+{
+    auto body = std::make_shared<std::string>();
+    json_rpc::readRawMessage(rewind(didOpenInput()), *body);
+    benchmark::doNotOptimize(json_rpc::parse(std::move(body)).parseParams());
+}
+
+BENCHMARK(jsonrpc_didChange_2mb_legacy)
+{
+    std::string body;
+    legacyReadRawMessage(rewind(didChangeInput()), body);
+    benchmark::doNotOptimize(legacyParseParams(body));
+}
+
+BENCHMARK(jsonrpc_didChange_2mb)
+{
+    auto body = std::make_shared<std::string>();
+    json_rpc::readRawMessage(rewind(didChangeInput()), *body);
+    benchmark::doNotOptimize(json_rpc::parse(std::move(body)).parseParams());
+}
+
+// The cost paid by the input thread before a message is queued: framing, the envelope, and peeking the document version
+BENCHMARK(jsonrpc_didChange_2mb_envelope_only)
+{
+    auto body = std::make_shared<std::string>();
+    json_rpc::readRawMessage(rewind(didChangeInput()), *body);
+    auto message = json_rpc::parse(std::move(body));
+    benchmark::doNotOptimize(message.rawParams->find("textDocument")->find("version")->parse());
+}
@@ -0,0 +1,126 @@
+#include "Benchmark.hpp"
+#include "LSP/JsonRpc.hpp"
+#include "LSP/JsonWriter.hpp"
+
+// Compares serializing large results through a json DOM (the to_json fallback) against streaming them with JsonWriter.
+// Both include framing, as done by the output writer
+
+static const std::vector<lsp::CompletionItem>& completionItems()
+{
+    static std::vector<lsp::CompletionItem> items = []
+    {
+        std::vector<lsp::CompletionItem> items;
+        for (size_t i = 0; i < 5000; i++)
+        {
+            lsp::CompletionItem item;
+            item.label = "Property" + std::to_string(i);
+            item.kind = lsp::CompletionItemKind::Property;
+            item.detail = "(self: Instance, name: string) -> Instance?";
+            item.documentation = lsp::MarkupContent{lsp::MarkupKind::Markdown, "Returns the first child of the Instance found with the given name."};
+            item.sortText = "1";
+            item.insertText = "Property" + std::to_string(i);
+            item.textEdit = lsp::TextEdit{{{10, 4}, {10, 8}}, "Property" + std::to_string(i)};
+            items.push_back(std::move(item));
+        }
+        return items;
+    }();
+    return items;
+}
+
+static const lsp::SemanticTokens& semanticTokens()
+{
+    static lsp::SemanticTokens tokens = []
+    {
+        lsp::SemanticTokens tokens;
+        for (size_t i = 0; i < 50000; i++)
+            tokens.data.insert(tokens.data.end(), {i % 3, (i * 7) % 80, 1 + i % 12, i % 10, i % 4});
+        return tokens;
+    }();
+    return tokens;
+}
+
+static const lsp::WorkspaceDiagnosticReport& workspaceDiagnosticReport()
+{
+    static lsp::WorkspaceDiagnosticReport report = []
+    {
+        lsp::WorkspaceDiagnosticReport report;
+        for (size_t file = 0; file < 500; file++)
+        {
+            lsp::WorkspaceDocumentDiagnosticReport document;
+            document.uri = Uri::parse("file:///project/src/module" + std::to_string(file) + ".luau");
+            document.resultId = std::to_string(file);
+            for (size_t i = 0; i < 20; i++)
+            {
+                lsp::Diagnostic diagnostic;
+                diagnostic.range = {{i, 4}, {i, 12}};
+                diagnostic.severity = lsp::DiagnosticSeverity::Warning;
+                diagnostic.code = "LocalUnused";
+                diagnostic.source = "Luau";
+                diagnostic.message = "Variable 'value' is never used; prefix with '_' to silence";
+                diagnostic.tags = {lsp::DiagnosticTag::Unnecessary};
+                document.items.push_back(std::move(diagnostic));
+            }
+            report.items.push_back(std::move(document));
+        }
+        return report;
+    }();
+    return report;
+}
+
+template<typename T>
+static void serializeWithJson(const T& result)
+{
+    std::string buffer;
+    json msg{
+        {"jsonrpc", "2.0"},
+        {"result", result},
+        {"id", 1},
+    };
+    json_rpc::writeRawMessage(buffer, msg);
+    benchmark::doNotOptimize(buffer);
+}
+
+template<typename T>
+static void serializeWithJsonWriter(const T& result)
+{
+    std::string buffer;
+    std::string body;
+    JsonWriter writer(body);
+    writer.beginObject();
+    writer.field("jsonrpc", "2.0");
+    writer.field("result", result);
+    writer.field("id", 1);
+    writer.endObject();
+    json_rpc::writeFramedBody(buffer, body);
+    benchmark::doNotOptimize(buffer);
+}
+
+BENCHMARK(serialize_completion_5000_json)
+{
+    serializeWithJson(completionItems());
+}
+
+BENCHMARK(serialize_completion_5000)
+{
+    serializeWithJsonWriter(completionItems());
+}
+
+BENCHMARK(serialize_semantic_tokens_250k_json)
+{
+    serializeWithJson(semanticTokens());
+}
+
+BENCHMARK(serialize_semantic_tokens_250k)
+{
+    serializeWithJsonWriter(semanticTokens());
+}
+
+BENCHMARK(serialize_workspace_diagnostics_10k_json)
+{
+    serializeWithJson(workspaceDiagnosticReport());
+}
+
+BENCHMARK(serialize_workspace_diagnostics_10k)
+{
+    serializeWithJsonWriter(workspaceDiagnosticReport());
+}
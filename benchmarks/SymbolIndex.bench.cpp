@@ -0,0 +1,65 @@
+#include "Benchmark.hpp"
+#include "LSP/SymbolIndex.hpp"
+
+// Workspace symbols (Ctrl+T) searches every symbol declared in the workspace. These benchmarks search a generated 15k-module workspace,
+// where each module declares 30 symbols with names built from common words
+
+static constexpr uint32_t kModuleCount = 15000;
+static constexpr size_t kSymbolsPerModule = 30;
+
+static const char* const kWords[] = {"get", "set", "player", "data", "service", "update", "handler", "remote", "event", "state", "render",
+    "character", "input", "camera", "store", "config", "value", "callback", "module", "cache"};
+static constexpr size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+
+static std::vector<IndexedSymbol> moduleSymbols(uint32_t module)
+{
+    std::vector<IndexedSymbol> symbols;
+    for (size_t i = 0; i < kSymbolsPerModule; i++)
+    {
+        size_t seed = module * kSymbolsPerModule + i;
+        std::string name = kWords[seed % kWordCount];
+        std::string second = kWords[(seed / kWordCount + i) % kWordCount];
+        second[0] = static_cast<char>(second[0] - 'a' + 'A');
+        name += second + std::to_string(module % 97);
+        symbols.push_back(IndexedSymbol{std::move(name), lsp::SymbolKind::Function, {{static_cast<unsigned>(i), 0}, {static_cast<unsigned>(i), 20}}});
+    }
+    return symbols;
+}
+
+static SymbolIndex& workspaceIndex()
+{
+    static SymbolIndex index;
+    if (index.size() == 0)
+        for (uint32_t module = 0; module < kModuleCount; module++)
+            index.setModule({module}, moduleSymbols(module));
+    return index;
+}
+
+BENCHMARK(symbol_index_build_15k)
+{
+    SymbolIndex index;
+    for (uint32_t module = 0; module < kModuleCount; module++)
+        index.setModule({module}, moduleSymbols(module));
+    benchmark::doNotOptimize(index.size());
+}
+
+BENCHMARK(symbol_index_reindex_one_module)
+{
+    workspaceIndex().setModule({42}, moduleSymbols(42));
+}
+
+BENCHMARK(symbol_index_search_substring)
+{
+    benchmark::doNotOptimize(workspaceIndex().search("playerState", 256));
+}
+
+BENCHMARK(symbol_index_search_rare)
+{
+    // Few names contain the query, so every name is matched fuzzily as well
+    benchmark::doNotOptimize(workspaceIndex().search("cameraCache9", 256));
+}
+
+BENCHMARK(symbol_index_search_short)
+{
+    benchmark::doNotOptimize(workspaceIndex().search("gp", 256));
+}
@@ -0,0 +1,192 @@
+#include "Benchmark.hpp"
+#include "LSP/TextDocument.hpp"
+
+#include <algorithm>
+
+// Compares applying a single keystroke to a large generated module against the previous implementation, which rebuilt
+// the whole content string and shifted every later line offset on each incremental change
+
+static std::string makeGeneratedModule()
+{
+    std::string source;
+    for (size_t i = 0; i < 20000; i++)
+        source += "local value" + std::to_string(i) + " = { name = \"generated\", index = " + std::to_string(i) + " }\n";
+    return source;
+}
+
+static TextDocument& generatedDocument()
+{
+    static TextDocument document(Uri::file("/generated.luau"), "luau", 0, makeGeneratedModule());
+    return document;
+}
+
+struct LegacyDocument
+{
+    std::string content;
+    std::vector<size_t> lineOffsets;
+
+    explicit LegacyDocument(std::string text)
+        : content(std::move(text))
+    {
+        lineOffsets.push_back(0);
+        for (size_t i = 0; i < content.size(); i++)
+            if (content[i] == '\n')
+                lineOffsets.push_back(i + 1);
+    }
+
+    void replace(size_t line, size_t column, size_t length, const std::string& text)
+    {
+        size_t startOffset = lineOffsets[line] + column;
+        size_t endOffset = startOffset + length;
+        content = content.substr(0, startOffset) + text + content.substr(endOffset, content.size() - endOffset);
+
+        long diff = static_cast<long>(text.size()) - static_cast<long>(length);
+        for (size_t i = line + 1; i < lineOffsets.size(); i++)
+            lineOffsets[i] = lineOffsets[i] + diff;
+    }
+};
+
+static LegacyDocument& legacyGeneratedDocument()
+{
+    static LegacyDocument document(makeGeneratedModule());
+    return document;
+}
+
+BENCHMARK(text_document_keystroke_20k_lines_legacy)
+{
+    auto& document = legacyGeneratedDocument();
+    document.replace(10000, 5, 0, "x");
+    document.replace(10000, 5, 1, "");
+    benchmark::doNotOptimize(document.content);
+}
+
+BENCHMARK(text_document_keystroke_20k_lines)
+{
+    auto& document = generatedDocument();
+    document.update({{lsp::Range{{10000, 5}, {10000, 5}}, "x"}}, document.version() + 1);
+    document.update({{lsp::Range{{10000, 5}, {10000, 6}}, ""}}, document.version() + 1);
+    benchmark::doNotOptimize(document);
+}
+
+// Position conversion, which is performed thousands of times per semantic tokens, references or diagnostics request.
+// The legacy variant copies the line offsets and the prefix of the line before measuring it, as conversions previously did
+
+static std::string makeNonAsciiModule()
+{
+    std::string source;
+    for (size_t i = 0; i < 20000; i++)
+        source += "local value" + std::to_string(i) + " = { name = \"→ généré 🡆\", index = " + std::to_string(i) + " }\n";
+    return source;
+}
+
+static const std::string& nonAsciiSource()
+{
+    static std::string source = makeNonAsciiModule();
+    return source;
+}
+
+static TextDocument& asciiConversionDocument()
+{
+    static TextDocument document(Uri::file("/ascii.luau"), "luau", 0, makeGeneratedModule());
+    return document;
+}
+
+static TextDocument& nonAsciiConversionDocument()
+{
+    static TextDocument document(Uri::file("/non-ascii.luau"), "luau", 0, nonAsciiSource());
+    return document;
+}
+
+static lsp::Position legacyPositionAt(const std::vector<size_t>& lineOffsetsRef, const std::string& content, size_t offset)
+{
+    auto lineOffsets = lineOffsetsRef;
+    size_t line = std::upper_bound(lineOffsets.begin(), lineOffsets.end(), offset) - lineOffsets.begin() - 1;
+    std::string currentContent = content.substr(lineOffsets[line], offset - lineOffsets[line]);
+    return lsp::Position{line, lspLength(currentContent)};
+}
+
+BENCHMARK(text_document_position_at_1000_non_ascii_legacy)
+{
+    static std::vector<size_t> lineOffsets = nonAsciiConversionDocument().getLineOffsets();
+    const auto& content = nonAsciiSource();
+    for (size_t i = 0; i < 1000; i++)
+        benchmark::doNotOptimize(legacyPositionAt(lineOffsets, content, lineOffsets[i * 20] + 40));
+}
+
+BENCHMARK(text_document_position_at_1000_non_ascii)
+{
+    auto& document = nonAsciiConversionDocument();
+    for (size_t i = 0; i < 1000; i++)
+        benchmark::doNotOptimize(document.positionAt(document.getLineOffsets()[i * 20] + 40));
+}
+
+BENCHMARK(text_document_position_at_1000_ascii)
+{
+    auto& document = asciiConversionDocument();
+    for (size_t i = 0; i < 1000; i++)
+        benchmark::doNotOptimize(document.positionAt(document.getLineOffsets()[i * 20] + 40));
+}
+
+BENCHMARK(text_document_convert_position_round_trip_1000_non_ascii)
+{
+    auto& document = nonAsciiConversionDocument();
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+        auto position = document.convertPosition(Luau::Position{i * 20, 40});
+        benchmark::doNotOptimize(document.convertPosition(position));
+    }
+}
+
+BENCHMARK(text_document_position_index_build_20k_lines)
+{
+    auto& document = nonAsciiConversionDocument();
+    // An empty change invalidates the index without changing the text
+    document.update({{lsp::Range{{0, 0}, {0, 0}}, ""}}, document.version() + 1);
+    benchmark::doNotOptimize(document.positionAt(0));
+}
+
+BENCHMARK(text_document_open_20k_lines)
+{
+    TextDocument document(Uri::file("/opened.luau"), "luau", 0, nonAsciiSource());
+    benchmark::doNotOptimize(document.lineCount());
+}
+
+BENCHMARK(lsp_length_1000_lines)
+{
+    const auto& source = nonAsciiSource();
+    const auto& lineOffsets = nonAsciiConversionDocument().getLineOffsets();
+    size_t total = 0;
+    for (size_t i = 0; i < 1000; i++)
+        total += lspLength(std::string_view(source).substr(lineOffsets[i], lineOffsets[i + 1] - lineOffsets[i]));
+    benchmark::doNotOptimize(total);
+}
+
+// Converting the locations of every token in a document, as semantic tokens does
+
+static const std::vector<Luau::Location>& tokenLocations()
+{
+    static std::vector<Luau::Location> locations = []
+    {
+        std::vector<Luau::Location> result;
+        for (unsigned int line = 0; line < 20000; line++)
+            for (unsigned int column : {0u, 6u, 16u, 19u, 24u, 44u, 52u, 60u})
+                result.emplace_back(Luau::Position{line, column}, Luau::Position{line, column + 4});
+        return result;
+    }();
+    return locations;
+}
+
+BENCHMARK(text_document_convert_160k_locations_individually)
+{
+    auto& document = nonAsciiConversionDocument();
+    for (const auto& location : tokenLocations())
+    {
+        benchmark::doNotOptimize(document.convertPosition(location.begin));
+        benchmark::doNotOptimize(document.convertPosition(location.end));
+    }
+}
+
+BENCHMARK(text_document_convert_160k_locations_batched)
+{
+    benchmark::doNotOptimize(nonAsciiConversionDocument().convertLocations(tokenLocations()));
+}
@@ -0,0 +1,120 @@
+#include "Benchmark.hpp"
+#include "LSP/Uri.hpp"
+#include "LSP/WorkspaceFileResolver.hpp"
+#include "Platform/RobloxPlatform.hpp"
+
+#include <regex>
+
+// Module resolution converts between file paths, URIs and sourcemap virtual paths for every require. These benchmarks
+// resolve every module of a generated 10k-module sourcemap, and compare URI parsing against the previous regex implementation
+
+static constexpr size_t kModuleCount = 10000;
+
+static std::filesystem::path workspaceRoot()
+{
+    return std::filesystem::temp_directory_path() / "luau-lsp-benchmark";
+}
+
+static std::string modulePath(size_t i)
+{
+    return "src/shared/Folder" + std::to_string(i / 100) + "/Module" + std::to_string(i) + ".luau";
+}
+
+static const std::vector<std::string>& fileUris()
+{
+    static std::vector<std::string> uris = []
+    {
+        std::vector<std::string> result;
+        for (size_t i = 0; i < kModuleCount; i++)
+            result.push_back(Uri::file(workspaceRoot() / modulePath(i)).toString());
+        return result;
+    }();
+    return uris;
+}
+
+static Uri legacyParse(const std::string& value)
+{
+    const std::regex REGEX_EXPR(R"(^(([^:\/?#]+?):)?(\/\/([^\/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)");
+    std::smatch match;
+    if (std::regex_match(value, match, REGEX_EXPR))
+        return {match[2], match[4], match[5], match[7], match[9]};
+    return {"", "", "", "", ""};
+}
+
+BENCHMARK(uri_parse_10k_legacy)
+{
+    for (const auto& uri : fileUris())
+        benchmark::doNotOptimize(legacyParse(uri));
+}
+
+BENCHMARK(uri_parse_10k)
+{
+    for (const auto& uri : fileUris())
+        benchmark::doNotOptimize(Uri::parse(uri));
+}
+
+BENCHMARK(uri_normalise_path_10k_legacy)
+{
+    auto root = workspaceRoot();
+    for (size_t i = 0; i < kModuleCount; i++)
+        benchmark::doNotOptimize(Uri::parse(Uri::file(root / modulePath(i)).toString()).fsPath());
+}
+
+BENCHMARK(uri_normalise_path_10k)
+{
+    auto root = workspaceRoot();
+    for (size_t i = 0; i < kModuleCount; i++)
+        benchmark::doNotOptimize(Uri::normalisedFile(root / modulePath(i)).fsPath());
+}
+
+struct SourcemapWorkspace
+{
+    WorkspaceFileResolver fileResolver;
+    RobloxPlatform platform{&fileResolver};
+    std::vector<std::string> virtualPaths;
+    std::vector<std::string> realPaths;
+
+    SourcemapWorkspace()
+    {
+        fileResolver.rootUri = Uri::file(workspaceRoot());
+
+        std::string folders;
+        for (size_t folder = 0; folder < kModuleCount / 100; folder++)
+        {
+            std::string children;
+            for (size_t i = folder * 100; i < (folder + 1) * 100; i++)
+            {
+                children += children.empty() ? "" : ",";
+                children += R"({"name":"Module)" + std::to_string(i) + R"(","className":"ModuleScript","filePaths":[")" + modulePath(i) + "\"]}";
+                virtualPaths.push_back("game/ReplicatedStorage/Folder" + std::to_string(folder) + "/Module" + std::to_string(i));
+                realPaths.push_back((workspaceRoot() / modulePath(i)).generic_string());
+            }
+            folders += folders.empty() ? "" : ",";
+            folders += R"({"name":"Folder)" + std::to_string(folder) + R"(","className":"Folder","children":[)" + children + "]}";
+        }
+
+        platform.updateSourceNodeMap(
+            R"({"name":"Game","className":"DataModel","children":[{"name":"ReplicatedStorage","className":"ReplicatedStorage","children":[)" +
+            folders + "]}]}");
+    }
+};
+
+static SourcemapWorkspace& sourcemapWorkspace()
+{
+    static SourcemapWorkspace workspace;
+    return workspace;
+}
+
+BENCHMARK(sourcemap_resolve_to_real_path_10k)
+{
+    auto& workspace = sourcemapWorkspace();
+    for (const auto& virtualPath : workspace.virtualPaths)
+        benchmark::doNotOptimize(workspace.platform.resolveToRealPath(virtualPath));
+}
+
+BENCHMARK(sourcemap_resolve_to_virtual_path_10k)
+{
+    auto& workspace = sourcemapWorkspace();
+    for (const auto& realPath : workspace.realPaths)
+        benchmark::doNotOptimize(workspace.platform.resolveToVirtualPath(realPath));
+}
@@ -0,0 +1,94 @@
+#include "Benchmark.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> allocationCount{0};
+static std::atomic<size_t> allocatedBytes{0};
+
+void* operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace benchmark
+{
+static std::vector<std::pair<const char*, Function>>& registry()
+{
+    static std::vector<std::pair<const char*, Function>> benchmarks;
+    return benchmarks;
+}
+
+Registration::Registration(const char* name, Function function)
+{
+    registry().emplace_back(name, std::move(function));
+}
+
+static Result run(const char* name, const Function& function)
+{
+    using clock = std::chrono::steady_clock;
+    constexpr auto minimumDuration = std::chrono::milliseconds(500);
+
+    // Warm up caches and any lazily initialized state
+    function();
+
+    size_t iterations = 0;
+    size_t allocationsBefore = allocationCount.load();
+    size_t bytesBefore = allocatedBytes.load();
+    auto start = clock::now();
+    auto elapsed = clock::duration::zero();
+    while (elapsed < minimumDuration || iterations < 10)
+    {
+        function();
+        iterations++;
+        elapsed = clock::now() - start;
+    }
+
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.nanosecondsPerIteration = double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / double(iterations);
+    result.allocationsPerIteration = double(allocationCount.load() - allocationsBefore) / double(iterations);
+    result.allocatedBytesPerIteration = double(allocatedBytes.load() - bytesBefore) / double(iterations);
+    return result;
+}
+
+std::vector<Result> runAll(const std::string& filter)
+{
+    std::vector<Result> results;
+    for (const auto& [name, function] : registry())
+    {
+        if (std::string(name).find(filter) == std::string::npos)
+            continue;
+
+        auto& result = results.emplace_back(run(name, function));
+        printf("%-48s %10zu iters %14.0f ns/iter %12.1f allocs/iter %14.0f bytes/iter\n", result.name.c_str(), result.iterations,
+            result.nanosecondsPerIteration, result.allocationsPerIteration, result.allocatedBytesPerIteration);
+        fflush(stdout);
+    }
+    return results;
+}
+} // namespace benchmark
+
+int main(int argc, char** argv)
+{
+    benchmark::runAll(argc > 1 ? argv[1] : "");
+    return 0;
+}
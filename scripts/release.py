@@ -8,7 +8,7 @@ import subprocess
 from datetime import datetime
 
 CHANGELOG_FILE = "CHANGELOG.md"
-MAIN_CPP_FILE = "src/main.cpp"
+VERSION_HPP_FILE = "src/include/LSP/Version.hpp"
 PACKAGE_JSON_FILE = "editors/code/package.json"
 PACKAGE_LOCK_JSON_FILE = "editors/code/package-lock.json"
 
@@ -32,23 +32,19 @@ with open(CHANGELOG_FILE, "r") as file:
 with open(CHANGELOG_FILE, "w") as file:
     file.writelines(new_changelog_lines)
 
-# Update version in main.cpp
-new_main_cpp_lines: list[str] = []
-with open(MAIN_CPP_FILE, "r") as file:
+# Update version in Version.hpp
+new_version_hpp_lines: list[str] = []
+with open(VERSION_HPP_FILE, "r") as file:
     lines = file.readlines()
 
     for line in lines:
-        if line.strip().startswith('argparse::ArgumentParser program("luau-lsp", '):
-            new_line = (
-                line[0 : line.find(line.strip())]
-                + f'argparse::ArgumentParser program("luau-lsp", "{VERSION}");\n'
-            )
-            new_main_cpp_lines.append(new_line)
+        if line.startswith("#define LSP_VERSION "):
+            new_version_hpp_lines.append(f'#define LSP_VERSION "{VERSION}"\n')
         else:
-            new_main_cpp_lines.append(line)
+            new_version_hpp_lines.append(line)
 
-with open(MAIN_CPP_FILE, "w") as file:
-    file.writelines(new_main_cpp_lines)
+with open(VERSION_HPP_FILE, "w") as file:
+    file.writelines(new_version_hpp_lines)
 
 # Update version in package.json
 package_json_data = None
@@ -73,7 +69,7 @@ subprocess.run(
         "git",
         "add",
         CHANGELOG_FILE,
-        MAIN_CPP_FILE,
+        VERSION_HPP_FILE,
         PACKAGE_JSON_FILE,
         PACKAGE_LOCK_JSON_FILE,
     ],
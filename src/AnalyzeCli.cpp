@@ -15,7 +15,8 @@
 #include "LSP/LuauExt.hpp"
 #include "LSP/WorkspaceFileResolver.hpp"
 #include "LSP/Utils.hpp"
-#include "glob/glob.hpp"
+#include "LSP/GlobMatcher.hpp"
+#include "LSP/FileWalker.hpp"
 #include <iostream>
 #include <filesystem>
 #include <memory>
@@ -57,7 +58,7 @@ static void report(ReportFormat format, const char* name, const Luau::Location&
     }
 }
 
-static bool isIgnoredFile(const std::filesystem::path& rootUriPath, const std::filesystem::path& path, std::vector<std::string>& ignoreGlobPatterns)
+static bool isIgnoredFile(const std::filesystem::path& rootUriPath, const std::filesystem::path& path, const GlobMatcher& ignoreGlobs)
 {
     auto relativePath = path.lexically_relative(rootUriPath).generic_string(); // HACK: we convert to generic string so we get '/' separators
 
@@ -65,15 +66,11 @@ static bool isIgnoredFile(const std::filesystem::path& rootUriPath, const std::f
     if (relativePath.empty())
         relativePath = path.generic_string();
 
-    for (auto& pattern : ignoreGlobPatterns)
-        if (glob::fnmatch_case(relativePath, pattern))
-            return true;
-
-    return false;
+    return ignoreGlobs.matches(relativePath);
 }
 
 static bool reportError(
-    const Luau::Frontend& frontend, ReportFormat format, const Luau::TypeError& error, std::vector<std::string>& ignoreGlobPatterns)
+    const Luau::Frontend& frontend, ReportFormat format, const Luau::TypeError& error, const GlobMatcher& ignoreGlobs)
 {
     auto* fileResolver = static_cast<WorkspaceFileResolver*>(frontend.fileResolver);
     std::filesystem::path rootUriPath = fileResolver->rootUri.fsPath();
@@ -86,7 +83,7 @@ static bool reportError(
 
     std::string humanReadableName = fileResolver->getHumanReadableModuleName(errorFriendlyName);
 
-    if (isIgnoredFile(rootUriPath, *path, ignoreGlobPatterns))
+    if (isIgnoredFile(rootUriPath, *path, ignoreGlobs))
         return false;
 
     if (const auto* syntaxError = Luau::get_if<Luau::SyntaxError>(&error.data))
@@ -104,7 +101,7 @@ static void reportWarning(ReportFormat format, const char* name, const Luau::Lin
 }
 
 static bool analyzeFile(
-    Luau::Frontend& frontend, const std::filesystem::path& path, ReportFormat format, bool annotate, std::vector<std::string>& ignoreGlobPatterns)
+    Luau::Frontend& frontend, const std::filesystem::path& path, ReportFormat format, bool annotate, const GlobMatcher& ignoreGlobs)
 {
     Luau::CheckResult cr;
     Luau::ModuleName name = path.generic_string();
@@ -120,7 +117,7 @@ static bool analyzeFile(
 
     unsigned int reportedErrors = 0;
     for (auto& error : cr.errors)
-        reportedErrors += reportError(frontend, format, error, ignoreGlobPatterns);
+        reportedErrors += reportError(frontend, format, error, ignoreGlobs);
 
     // For the human readable module name, we use a relative version
     auto errorFriendlyName = std::filesystem::proximate(path).generic_string();
@@ -151,12 +148,18 @@ int startAnalyze(const argparse::ArgumentParser& program)
     bool annotate = program.is_used("--annotate");
     auto sourcemapPath = program.present<std::filesystem::path>("--sourcemap");
     auto definitionsPaths = program.get<std::vector<std::filesystem::path>>("--definitions");
-    auto ignoreGlobPatterns = program.get<std::vector<std::string>>("--ignore");
+    GlobMatcher ignoreGlobs(program.get<std::vector<std::string>>("--ignore"));
     auto baseLuaurc = program.present<std::filesystem::path>("--base-luaurc");
     auto settingsPath = program.present<std::filesystem::path>("--settings");
     std::vector<std::filesystem::path> files{};
     FFlag::DebugLuauTimeTracing.value = program.is_used("--timetrace");
 
+    // Directories containing only ignored files do not need to be walked, as errors will not be reported for them
+    FileWalkerOptions walkerOptions;
+    walkerOptions.ignoreGlobs = ignoreGlobs;
+    walkerOptions.ignoreGlobsRoot = std::filesystem::current_path();
+    walkerOptions.respectGitignore = program.is_used("--respect-gitignore");
+
     if (auto filesArg = program.present<std::vector<std::string>>("files"))
     {
         for (const auto& pathString : *filesArg)
@@ -174,25 +177,12 @@ int startAnalyze(const argparse::ArgumentParser& program)
 
             if (std::filesystem::is_directory(path))
             {
-                for (std::filesystem::recursive_directory_iterator next(path, std::filesystem::directory_options::skip_permission_denied), end;
-                    next != end; ++next)
-                {
-                    try
-                    {
-                        if (next->is_regular_file() && next->path().has_extension())
-                        {
-                            auto ext = next->path().extension();
-                            if (ext == ".lua" || ext == ".luau")
-                            {
-                                files.push_back(next->path());
-                            }
-                        }
-                    }
-                    catch (const std::filesystem::filesystem_error& e)
+                auto found = findSourceFiles(path, walkerOptions,
+                    [](const std::string& error)
                     {
-                        std::cerr << "warning: Failed to visit directory: " << e.what() << "\n";
-                    }
-                }
+                        std::cerr << "warning: " << error << "\n";
+                    });
+                files.insert(files.end(), found.begin(), found.end());
             }
             else
             {
@@ -380,7 +370,7 @@ int startAnalyze(const argparse::ArgumentParser& program)
     int failed = 0;
 
     for (const std::filesystem::path& path : files)
-        failed += !analyzeFile(frontend, path, format, annotate, ignoreGlobPatterns);
+        failed += !analyzeFile(frontend, path, format, annotate, ignoreGlobs);
 
     if (!client.diagnostics.empty())
     {
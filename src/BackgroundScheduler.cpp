@@ -0,0 +1,89 @@
+#include "LSP/BackgroundScheduler.hpp"
+
+#include <algorithm>
+
+void BackgroundScheduler::schedule(const std::string& key, BackgroundTask task)
+{
+    for (auto& entry : tasks)
+    {
+        if (entry.key == key)
+        {
+            entry.step = std::move(task);
+            return;
+        }
+    }
+
+    tasks.push_back(Entry{key, std::move(task)});
+}
+
+void BackgroundScheduler::cancel(const std::string& keyPrefix)
+{
+    tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
+                    [&](const Entry& entry)
+                    {
+                        return entry.key.compare(0, keyPrefix.size(), keyPrefix) == 0;
+                    }),
+        tasks.end());
+}
+
+bool BackgroundScheduler::empty() const
+{
+    return tasks.empty();
+}
+
+size_t BackgroundScheduler::size() const
+{
+    return tasks.size();
+}
+
+void BackgroundScheduler::runStep()
+{
+    if (tasks.empty())
+        return;
+
+    // The entry is taken off the queue whilst it runs, as the step may schedule (or replace) other tasks
+    auto entry = std::move(tasks.front());
+    tasks.pop_front();
+
+    if (!entry.step())
+        return;
+
+    // If the task was rescheduled whilst it was running, the new task takes precedence
+    for (const auto& other : tasks)
+        if (other.key == entry.key)
+            return;
+
+    tasks.push_back(std::move(entry));
+}
+
+bool BackgroundScheduler::runStep(const std::string& key)
+{
+    auto it = std::find_if(tasks.begin(), tasks.end(),
+        [&](const Entry& entry)
+        {
+            return entry.key == key;
+        });
+    if (it == tasks.end())
+        return false;
+
+    auto position = static_cast<size_t>(it - tasks.begin());
+    auto entry = std::move(*it);
+    tasks.erase(it);
+
+    if (!entry.step())
+        return false;
+
+    // If the task was rescheduled whilst it was running, the new task takes precedence
+    for (const auto& other : tasks)
+        if (other.key == entry.key)
+            return true;
+
+    tasks.insert(tasks.begin() + static_cast<std::ptrdiff_t>(std::min(position, tasks.size())), std::move(entry));
+    return true;
+}
+
+void BackgroundScheduler::runAll()
+{
+    while (!tasks.empty())
+        runStep();
+}
@@ -1,4 +1,6 @@
 #include "LSP/Client.hpp"
+#include "LSP/OutputWriter.hpp"
+#include "LSP/JsonWriter.hpp"
 
 #include <iostream>
 #include <optional>
@@ -17,7 +19,7 @@ void Client::sendRequest(
     if (handler)
         responseHandler.emplace(id, *handler);
 
-    sendRawMessage(msg);
+    sendRawMessage(std::move(msg));
 }
 
 void Client::sendResponse(const id_type& id, const json& result)
@@ -28,7 +30,42 @@ void Client::sendResponse(const id_type& id, const json& result)
         {"id", id},
     };
 
-    sendRawMessage(msg);
+    sendRawMessage(std::move(msg));
+}
+
+// Defined below
+static OutputWriter& getOutputWriter();
+
+template<typename T>
+static void sendSerializedResponse(const id_type& id, T result)
+{
+    // The result is serialized on the writer thread
+    getOutputWriter().push(
+        [id, result = std::move(result)](std::string& body)
+        {
+            JsonWriter writer(body);
+            writer.beginObject();
+            writer.field("jsonrpc", "2.0");
+            writer.field("result", result);
+            writer.field("id", id);
+            writer.endObject();
+        },
+        Client::bytesOutCounter);
+}
+
+void Client::sendResponse(const id_type& id, lsp::SemanticTokens result)
+{
+    sendSerializedResponse(id, std::move(result));
+}
+
+void Client::sendResponse(const id_type& id, std::vector<lsp::CompletionItem> result)
+{
+    sendSerializedResponse(id, std::move(result));
+}
+
+void Client::sendResponse(const id_type& id, lsp::WorkspaceDiagnosticReport result)
+{
+    sendSerializedResponse(id, std::move(result));
 }
 
 void Client::sendError(const std::optional<id_type>& id, const JsonRpcException& e)
@@ -39,7 +76,7 @@ void Client::sendError(const std::optional<id_type>& id, const JsonRpcException&
         {"error", {{"code", e.code}, {"message", e.message}, {"data", e.data}}},
     };
 
-    sendRawMessage(msg);
+    sendRawMessage(std::move(msg));
 }
 
 void Client::sendNotification(const std::string& method, const std::optional<json>& params)
@@ -50,7 +87,7 @@ void Client::sendNotification(const std::string& method, const std::optional<jso
         {"params", params},
     };
 
-    sendRawMessage(msg);
+    sendRawMessage(std::move(msg));
 }
 
 void Client::sendLogMessage(const lsp::MessageType& type, const std::string& message)
@@ -85,6 +122,17 @@ void Client::registerCapability(const std::string& registrationId, const std::st
     sendRequest(nextRequestId++, "client/registerCapability", lsp::RegistrationParams{{registration}});
 }
 
+std::optional<lsp::ProgressToken> Client::createWorkDoneProgress()
+{
+    if (!capabilities.window || !capabilities.window->workDoneProgress)
+        return std::nullopt;
+
+    // Progress can be reported straight away: the client handles the create request before any notifications sent after it
+    lsp::ProgressToken token = "luau-lsp/progress/" + std::to_string(nextProgressToken++);
+    sendRequest(nextRequestId++, "window/workDoneProgress/create", lsp::WorkDoneProgressCreateParams{token});
+    return token;
+}
+
 void Client::unregisterCapability(const std::string& registrationId, const std::string& method)
 {
     lsp::Unregistration unregistration{registrationId, method};
@@ -222,7 +270,30 @@ void Client::handleResponse(const JsonRpcMessage& message)
     }
 }
 
-void Client::sendRawMessage(const json& message)
+// Intentionally leaked: the writer must outlive any thread which may still send messages during exit
+static std::ostream* outputStream = &std::cout;
+
+static OutputWriter& getOutputWriter()
+{
+    static OutputWriter* writer = new OutputWriter(*outputStream);
+    return *writer;
+}
+
+thread_local OutputWriter::ByteCounter Client::bytesOutCounter = nullptr;
+
+void Client::sendRawMessage(json message)
+{
+    getOutputWriter().push(std::move(message), bytesOutCounter);
+}
+
+void Client::flushOutput()
+{
+    getOutputWriter().flush();
+}
+
+void Client::discardOutput()
 {
-    json_rpc::sendRawMessage(std::cout, message);
+    // A stream without a buffer silently drops everything written to it
+    static std::ostream discarded(nullptr);
+    outputStream = &discarded;
 }
@@ -0,0 +1,125 @@
+#include "LSP/DependencyGraph.hpp"
+
+#include <algorithm>
+#include <utility>
+
+void DependencyGraph::grow(InternedId module)
+{
+    if (module.value >= dependencies.size())
+    {
+        dependencies.resize(module.value + 1);
+        dependents.resize(module.value + 1);
+        visited.resize(module.value + 1);
+    }
+}
+
+void DependencyGraph::setDependencies(InternedId module, std::vector<InternedId> moduleDependencies)
+{
+    grow(module);
+    for (auto dependency : moduleDependencies)
+        grow(dependency);
+
+    std::sort(moduleDependencies.begin(), moduleDependencies.end());
+    moduleDependencies.erase(std::unique(moduleDependencies.begin(), moduleDependencies.end()), moduleDependencies.end());
+
+    // Only the edges which differ from the previous requires are touched
+    const auto& previous = dependencies[module.value];
+    auto oldIt = previous.begin();
+    auto newIt = moduleDependencies.begin();
+    while (oldIt != previous.end() || newIt != moduleDependencies.end())
+    {
+        if (newIt == moduleDependencies.end() || (oldIt != previous.end() && *oldIt < *newIt))
+        {
+            auto& reverse = dependents[oldIt->value];
+            auto it = std::find(reverse.begin(), reverse.end(), module);
+            if (it != reverse.end())
+            {
+                *it = reverse.back();
+                reverse.pop_back();
+            }
+            ++oldIt;
+        }
+        else if (oldIt == previous.end() || *newIt < *oldIt)
+        {
+            dependents[newIt->value].push_back(module);
+            ++newIt;
+        }
+        else
+        {
+            ++oldIt;
+            ++newIt;
+        }
+    }
+
+    dependencies[module.value] = std::move(moduleDependencies);
+}
+
+void DependencyGraph::invalidate(InternedId module)
+{
+    std::lock_guard lock(staleMutex);
+    stale.insert(module);
+}
+
+std::vector<InternedId> DependencyGraph::takeStale()
+{
+    std::vector<InternedId> result;
+    {
+        std::lock_guard lock(staleMutex);
+        result.assign(stale.begin(), stale.end());
+        stale.clear();
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+void DependencyGraph::clear()
+{
+    dependencies.clear();
+    dependents.clear();
+    visited.clear();
+    populated = false;
+
+    std::lock_guard lock(staleMutex);
+    stale.clear();
+}
+
+const std::vector<InternedId>& DependencyGraph::directDependencies(InternedId module) const
+{
+    static const std::vector<InternedId> empty;
+    return module.value < dependencies.size() ? dependencies[module.value] : empty;
+}
+
+const std::vector<InternedId>& DependencyGraph::directDependents(InternedId module) const
+{
+    static const std::vector<InternedId> empty;
+    return module.value < dependents.size() ? dependents[module.value] : empty;
+}
+
+std::vector<InternedId> DependencyGraph::transitiveDependents(InternedId module)
+{
+    grow(module);
+
+    if (++generation == 0)
+    {
+        // The stamps have wrapped around, so old stamps could be mistaken for the current generation
+        std::fill(visited.begin(), visited.end(), 0);
+        generation = 1;
+    }
+
+    std::vector<InternedId> result{module};
+    visited[module.value] = generation;
+    for (size_t i = 0; i < result.size(); i++)
+    {
+        for (auto dependent : dependents[result[i].value])
+        {
+            if (visited[dependent.value] != generation)
+            {
+                visited[dependent.value] = generation;
+                result.push_back(dependent);
+            }
+        }
+    }
+
+    return result;
+}
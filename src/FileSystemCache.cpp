@@ -0,0 +1,57 @@
+#include "LSP/FileSystemCache.hpp"
+
+std::filesystem::file_type FileSystemCache::type(const std::filesystem::path& path)
+{
+    // A single stat answers both exists() and isDirectory()
+    std::error_code ec;
+    if (!caching)
+        return std::filesystem::status(path, ec).type();
+
+    auto key = path.generic_string();
+    if (auto cached = types.get(key))
+        return *cached;
+
+    auto result = std::filesystem::status(path, ec).type();
+    types.put(key, result);
+    return result;
+}
+
+bool FileSystemCache::exists(const std::filesystem::path& path)
+{
+    auto result = type(path);
+    return result != std::filesystem::file_type::none && result != std::filesystem::file_type::not_found;
+}
+
+bool FileSystemCache::isDirectory(const std::filesystem::path& path)
+{
+    return type(path) == std::filesystem::file_type::directory;
+}
+
+std::optional<std::filesystem::path> FileSystemCache::weaklyCanonical(const std::filesystem::path& path)
+{
+    auto key = path.generic_string();
+    if (caching)
+        if (auto cached = canonicalPaths.get(key))
+            return *cached;
+
+    std::error_code ec;
+    std::optional<std::filesystem::path> result = std::filesystem::weakly_canonical(path, ec);
+    if (ec)
+        result = std::nullopt;
+    if (caching)
+        canonicalPaths.put(key, result);
+    return result;
+}
+
+void FileSystemCache::clear()
+{
+    types.clear();
+    canonicalPaths.clear();
+}
+
+void FileSystemCache::setCaching(bool enabled)
+{
+    caching = enabled;
+    if (!enabled)
+        clear();
+}
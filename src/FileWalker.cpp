@@ -0,0 +1,310 @@
+#include "LSP/FileWalker.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+
+#include "LSP/ThreadPool.hpp"
+
+static std::string_view trimTrailingWhitespace(std::string_view line)
+{
+    while (!line.empty() && (line.back() == ' ' || line.back() == '\t' || line.back() == '\r'))
+        line.remove_suffix(1);
+    return line;
+}
+
+GitignoreRules::GitignoreRules(std::shared_ptr<const GitignoreRules> parent, std::string base, std::string_view contents)
+    : parent(std::move(parent))
+    , base(std::move(base))
+{
+    while (!contents.empty())
+    {
+        auto newline = contents.find('\n');
+        auto line = trimTrailingWhitespace(contents.substr(0, newline));
+        contents = newline == std::string_view::npos ? std::string_view() : contents.substr(newline + 1);
+
+        if (line.empty() || line.front() == '#')
+            continue;
+
+        Rule rule;
+        if (line.front() == '!')
+        {
+            rule.negated = true;
+            line.remove_prefix(1);
+        }
+        else if (line.front() == '\\')
+        {
+            line.remove_prefix(1);
+        }
+
+        if (!line.empty() && line.back() == '/')
+        {
+            rule.directoryOnly = true;
+            line.remove_suffix(1);
+        }
+
+        std::string pattern(line);
+        if (pattern.empty())
+            continue;
+
+        // A leading `**/` matches in any directory, which is the same as not being anchored
+        if (pattern.rfind("**/", 0) == 0 && pattern.find('/', 3) == std::string::npos)
+            pattern.erase(0, 3);
+
+        rule.anchored = pattern.find('/') != std::string::npos;
+        if (pattern.front() == '/')
+            pattern.erase(0, 1);
+
+        // `a/**/b` also matches `a/b`
+        std::vector<std::string> patterns{pattern};
+        for (size_t pos = pattern.find("/**/"); pos != std::string::npos; pos = pattern.find("/**/", pos + 1))
+            patterns.push_back(pattern.substr(0, pos) + pattern.substr(pos + 3));
+        if (pattern.rfind("**/", 0) == 0)
+            patterns.push_back(pattern.substr(3));
+
+        rule.matcher = GlobMatcher(std::move(patterns));
+        rules.push_back(std::move(rule));
+    }
+}
+
+bool GitignoreRules::isIgnored(std::string_view relativePath, bool isDirectory) const
+{
+    auto slash = relativePath.rfind('/');
+    auto name = slash == std::string_view::npos ? relativePath : relativePath.substr(slash + 1);
+
+    // Later rules take precedence over earlier ones, and a directory's rules over its parents'
+    for (auto rules = this; rules; rules = rules->parent.get())
+    {
+        auto path = relativePath;
+        if (!rules->base.empty())
+        {
+            if (path.size() <= rules->base.size() || path.compare(0, rules->base.size(), rules->base) != 0 || path[rules->base.size()] != '/')
+                continue;
+            path.remove_prefix(rules->base.size() + 1);
+        }
+
+        for (auto rule = rules->rules.rbegin(); rule != rules->rules.rend(); ++rule)
+        {
+            if (rule->directoryOnly && !isDirectory)
+                continue;
+
+            if (rule->matcher.matches(rule->anchored ? path : name))
+                return !rule->negated;
+        }
+    }
+
+    return false;
+}
+
+bool isSourceFile(const std::filesystem::path& path)
+{
+    auto ext = path.extension();
+    return ext == ".lua" || ext == ".luau";
+}
+
+namespace
+{
+/// What a worker found whilst walking its share of a step
+struct WalkResult
+{
+    std::vector<std::filesystem::path> files;
+    std::vector<SourceFileWalk::PendingDirectory> directories;
+    std::vector<std::string> errors;
+};
+} // namespace
+
+static std::optional<std::string> readGitignore(const std::filesystem::path& directory)
+{
+    std::ifstream stream(directory / ".gitignore", std::ios::in | std::ios::binary);
+    if (!stream)
+        return std::nullopt;
+
+    std::stringstream buffer;
+    buffer << stream.rdbuf();
+    return buffer.str();
+}
+
+static void walkDirectory(const SourceFileWalk::PendingDirectory& directory, const FileWalkerOptions& options, WalkResult& result)
+{
+    auto gitignore = directory.gitignore;
+    if (options.respectGitignore)
+        if (auto contents = readGitignore(directory.path))
+            gitignore = std::make_shared<const GitignoreRules>(gitignore, directory.relativePath, *contents);
+
+    std::error_code ec;
+    std::filesystem::directory_iterator next(directory.path, std::filesystem::directory_options::skip_permission_denied, ec), end;
+    for (; !ec && next != end; next.increment(ec))
+    {
+        const auto& entry = *next;
+        auto name = entry.path().filename().string();
+        auto relativePath = directory.relativePath.empty() ? name : directory.relativePath + "/" + name;
+
+        std::error_code entryEc;
+        // Like `recursive_directory_iterator`, don't follow symlinks to directories, which may form cycles
+        bool isDirectory = entry.is_directory(entryEc) && !entry.is_symlink(entryEc);
+        if (entryEc)
+        {
+            result.errors.push_back("failed to visit " + entry.path().string() + ": " + entryEc.message());
+            continue;
+        }
+
+        if (isDirectory)
+        {
+            if (options.respectGitignore && (name == ".git" || (gitignore && gitignore->isIgnored(relativePath, true))))
+                continue;
+
+            if (!options.ignoreGlobs.empty())
+            {
+                auto globPath = options.ignoreGlobsRoot.empty() ? relativePath
+                                                                : entry.path().lexically_relative(options.ignoreGlobsRoot).generic_string();
+                if (options.ignoreGlobs.matchesEverythingUnder(globPath))
+                    continue;
+            }
+
+            result.directories.push_back(SourceFileWalk::PendingDirectory{entry.path(), std::move(relativePath), gitignore});
+        }
+        else if (isSourceFile(entry.path()) && entry.is_regular_file(entryEc))
+        {
+            if (options.respectGitignore && gitignore && gitignore->isIgnored(relativePath, false))
+                continue;
+
+            result.files.push_back(entry.path());
+        }
+    }
+
+    if (ec)
+        result.errors.push_back("failed to visit directory " + directory.path.string() + ": " + ec.message());
+}
+
+SourceFileWalk::SourceFileWalk(const std::filesystem::path& root, FileWalkerOptions options)
+    : options(std::move(options))
+    , pending{PendingDirectory{root, "", nullptr}}
+{
+}
+
+bool SourceFileWalk::step(ThreadPool& pool, size_t maxDirectories, const std::function<void(const std::string&)>& onError)
+{
+    // The batch is taken from the end of the pending directories, which are walked in any order as the files are sorted at the end
+    size_t count = std::min(maxDirectories, pending.size());
+    auto first = pending.end() - static_cast<std::ptrdiff_t>(count);
+    std::vector<PendingDirectory> batch(std::make_move_iterator(first), std::make_move_iterator(pending.end()));
+    pending.erase(first, pending.end());
+
+    std::vector<WalkResult> results(pool.size());
+    pool.parallelFor(batch.size(),
+        [&](size_t index, size_t worker)
+        {
+            walkDirectory(batch[index], options, results[worker]);
+        });
+
+    for (auto& result : results)
+    {
+        std::move(result.files.begin(), result.files.end(), std::back_inserter(files));
+        std::move(result.directories.begin(), result.directories.end(), std::back_inserter(pending));
+        if (onError)
+            for (const auto& error : result.errors)
+                onError(error);
+    }
+
+    return !pending.empty();
+}
+
+std::vector<std::filesystem::path> SourceFileWalk::takeFiles()
+{
+    std::sort(files.begin(), files.end());
+    return std::move(files);
+}
+
+std::vector<std::filesystem::path> findSourceFiles(
+    const std::filesystem::path& root, const FileWalkerOptions& options, const std::function<void(const std::string&)>& onError)
+{
+    ThreadPool pool(options.threads);
+
+    // Each step walks every directory found by the previous one, i.e. a level of the tree at a time
+    SourceFileWalk walk(root, options);
+    while (walk.step(pool, SIZE_MAX, onError))
+    {
+    }
+
+    return walk.takeFiles();
+}
+
+const std::vector<std::filesystem::path>& WorkspaceFiles::get(
+    const std::filesystem::path& root, const FileWalkerOptions& options, const std::function<void(const std::string&)>& onError)
+{
+    if (!isPopulated(root, options))
+        set(root, options, findSourceFiles(root, options, onError));
+
+    return files;
+}
+
+bool WorkspaceFiles::isPopulated(const std::filesystem::path& root, const FileWalkerOptions& options) const
+{
+    return populated && this->root == root && this->options.ignoreGlobs.getPatterns() == options.ignoreGlobs.getPatterns() &&
+           this->options.ignoreGlobsRoot == options.ignoreGlobsRoot && this->options.respectGitignore == options.respectGitignore;
+}
+
+void WorkspaceFiles::set(const std::filesystem::path& root, const FileWalkerOptions& options, std::vector<std::filesystem::path> walkedFiles)
+{
+    this->root = root;
+    this->options = options;
+    files = std::move(walkedFiles);
+    populated = true;
+}
+
+void WorkspaceFiles::clear()
+{
+    populated = false;
+    files.clear();
+}
+
+void WorkspaceFiles::onCreated(const std::filesystem::path& path)
+{
+    if (!populated)
+        return;
+
+    // Finding out what a new directory contains, or whether a `.gitignore` applies to a new file, needs a walk anyway
+    std::error_code ec;
+    if (options.respectGitignore || std::filesystem::is_directory(path, ec))
+    {
+        clear();
+        return;
+    }
+
+    if (!isSourceFile(path))
+        return;
+
+    auto relativePath = path.lexically_relative(root);
+    if (relativePath.empty() || *relativePath.begin() == "..")
+        return;
+
+    if (!options.ignoreGlobs.empty())
+    {
+        const auto& globRoot = options.ignoreGlobsRoot.empty() ? root : options.ignoreGlobsRoot;
+        for (auto directory = path.parent_path(); directory != root && directory.has_relative_path(); directory = directory.parent_path())
+            if (options.ignoreGlobs.matchesEverythingUnder(directory.lexically_relative(globRoot).generic_string()))
+                return;
+    }
+
+    auto it = std::lower_bound(files.begin(), files.end(), path);
+    if (it == files.end() || *it != path)
+        files.insert(it, path);
+}
+
+void WorkspaceFiles::onDeleted(const std::filesystem::path& path)
+{
+    if (!populated)
+        return;
+
+    // Paths compare element by element, so everything inside a directory sorts directly after it
+    auto first = std::lower_bound(files.begin(), files.end(), path);
+    auto last = std::find_if(first, files.end(),
+        [&](const std::filesystem::path& file)
+        {
+            return std::mismatch(path.begin(), path.end(), file.begin(), file.end()).first != path.end();
+        });
+    files.erase(first, last);
+}
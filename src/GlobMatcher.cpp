@@ -0,0 +1,237 @@
+#include "LSP/GlobMatcher.hpp"
+
+#include <numeric>
+#include <regex>
+
+#include "glob/glob.hpp"
+
+GlobMatcher::GlobMatcher(std::vector<std::string> patterns)
+    : sources(std::move(patterns))
+{
+    for (const auto& pattern : sources)
+        compile(pattern);
+}
+
+void GlobMatcher::compile(const std::string& pattern)
+{
+    Pattern compiled;
+    compiled.start = static_cast<uint32_t>(tokens.size());
+
+    // Tokenize the same way as glob::translate, so that patterns mean the same thing
+    size_t i = 0;
+    size_t n = pattern.size();
+    while (i < n)
+    {
+        char c = pattern[i];
+        i += 1;
+
+        Token token;
+        if (c == '*')
+        {
+            token.kind = TokenKind::Star;
+        }
+        else if (c == '?')
+        {
+            token.kind = TokenKind::Any;
+        }
+        else if (c == '[')
+        {
+            size_t j = i;
+            if (j < n && pattern[j] == '!')
+                j += 1;
+            if (j < n && pattern[j] == ']')
+                j += 1;
+            while (j < n && pattern[j] != ']')
+                j += 1;
+
+            if (j >= n)
+            {
+                token.literal = '[';
+            }
+            else
+            {
+                // Rather than reimplementing the quirks of glob's character classes, evaluate the class it would produce against every byte
+                std::bitset<256> members;
+                try
+                {
+                    std::regex regex(glob::translate(pattern.substr(i - 1, j - i + 2)), std::regex::ECMAScript);
+                    for (int byte = 0; byte < 256; byte++)
+                        if (byte != '\r' && byte != '\n')
+                            members[byte] = std::regex_match(std::string(1, static_cast<char>(byte)), regex);
+                }
+                catch (const std::regex_error&)
+                {
+                    // An invalid class (such as `[z-a]`) matches nothing
+                }
+
+                token.kind = TokenKind::Class;
+                token.classIndex = static_cast<uint32_t>(classes.size());
+                classes.push_back(members);
+                i = j + 1;
+            }
+        }
+        else
+        {
+            token.literal = c;
+        }
+        tokens.push_back(token);
+    }
+
+    Token accept;
+    accept.kind = TokenKind::Accept;
+    tokens.push_back(accept);
+
+    // A trailing run of stars accepts anything
+    for (size_t index = tokens.size() - 1; index-- > compiled.start && tokens[index].kind == TokenKind::Star;)
+        tokens[index].acceptsAnything = true;
+
+    // Find the literal prefix, literal suffix and longest literal run
+    size_t end = tokens.size() - 1;
+    size_t runStart = compiled.start;
+    for (size_t index = compiled.start; index <= end; index++)
+    {
+        if (index < end && tokens[index].kind == TokenKind::Literal)
+            continue;
+
+        if (index - runStart > compiled.required.size())
+        {
+            compiled.required.clear();
+            for (size_t k = runStart; k < index; k++)
+                compiled.required += tokens[k].literal;
+        }
+        if (runStart == compiled.start)
+            for (size_t k = runStart; k < index; k++)
+                compiled.prefix += tokens[k].literal;
+        if (index == end)
+            for (size_t k = runStart; k < index; k++)
+                compiled.suffix += tokens[k].literal;
+
+        runStart = index + 1;
+    }
+
+    patterns.push_back(std::move(compiled));
+}
+
+const std::vector<uint32_t>& GlobMatcher::run(std::string_view text, const std::vector<uint32_t>& startPatterns) const
+{
+    // Scratch space is reused between calls, so matching does not allocate
+    thread_local std::vector<uint32_t> current;
+    thread_local std::vector<uint32_t> next;
+    thread_local std::vector<uint32_t> stamps;
+    thread_local uint32_t generation = 0;
+
+    if (stamps.size() < tokens.size())
+        stamps.resize(tokens.size(), 0);
+
+    auto nextGeneration = [&]()
+    {
+        if (++generation == 0)
+        {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+    };
+
+    // Adds a state, along with the states reachable by a `*` matching nothing
+    auto add = [&](std::vector<uint32_t>& states, uint32_t state)
+    {
+        while (stamps[state] != generation)
+        {
+            stamps[state] = generation;
+            states.push_back(state);
+            if (tokens[state].kind != TokenKind::Star)
+                break;
+            state++;
+        }
+    };
+
+    nextGeneration();
+    current.clear();
+    for (auto pattern : startPatterns)
+        add(current, patterns[pattern].start);
+
+    for (char c : text)
+    {
+        if (current.empty())
+            break;
+
+        nextGeneration();
+        next.clear();
+        bool lineBreak = c == '\r' || c == '\n';
+        for (auto state : current)
+        {
+            const Token& token = tokens[state];
+            switch (token.kind)
+            {
+            case TokenKind::Literal:
+                if (token.literal == c)
+                    add(next, state + 1);
+                break;
+            case TokenKind::Any:
+                if (!lineBreak)
+                    add(next, state + 1);
+                break;
+            case TokenKind::Star:
+                if (!lineBreak)
+                    add(next, state);
+                break;
+            case TokenKind::Class:
+                if (classes[token.classIndex][static_cast<unsigned char>(c)])
+                    add(next, state + 1);
+                break;
+            case TokenKind::Accept:
+                break;
+            }
+        }
+        std::swap(current, next);
+    }
+
+    return current;
+}
+
+bool GlobMatcher::matches(std::string_view path) const
+{
+    thread_local std::vector<uint32_t> live;
+    live.clear();
+
+    for (size_t i = 0; i < patterns.size(); i++)
+    {
+        const auto& pattern = patterns[i];
+        if (path.size() < pattern.prefix.size() || path.size() < pattern.suffix.size())
+            continue;
+        if (path.compare(0, pattern.prefix.size(), pattern.prefix) != 0)
+            continue;
+        if (path.compare(path.size() - pattern.suffix.size(), pattern.suffix.size(), pattern.suffix) != 0)
+            continue;
+        if (!pattern.required.empty() && path.find(pattern.required) == std::string_view::npos)
+            continue;
+        live.push_back(static_cast<uint32_t>(i));
+    }
+
+    if (live.empty())
+        return false;
+
+    for (auto state : run(path, live))
+        if (tokens[state].kind == TokenKind::Accept)
+            return true;
+    return false;
+}
+
+bool GlobMatcher::matchesEverythingUnder(std::string_view directory) const
+{
+    if (patterns.empty())
+        return false;
+
+    std::vector<uint32_t> all(patterns.size());
+    std::iota(all.begin(), all.end(), 0);
+
+    std::string prefix;
+    prefix.reserve(directory.size() + 1);
+    prefix.append(directory);
+    prefix += '/';
+
+    for (auto state : run(prefix, all))
+        if (tokens[state].acceptsAnything)
+            return true;
+    return false;
+}
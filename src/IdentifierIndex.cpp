@@ -0,0 +1,65 @@
+#include "LSP/IdentifierIndex.hpp"
+
+#include <algorithm>
+#include <utility>
+
+void IdentifierIndex::setModule(InternedId module, const std::vector<std::string_view>& identifiers)
+{
+    std::vector<InternedId> ids;
+    ids.reserve(identifiers.size());
+    for (auto name : identifiers)
+        ids.push_back(names.intern(name));
+
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    ids.shrink_to_fit();
+
+    if (module.value >= modules.size())
+        modules.resize(module.value + 1);
+    modules[module.value] = std::move(ids);
+}
+
+bool IdentifierIndex::isIndexed(InternedId module) const
+{
+    return module.value < modules.size() && modules[module.value].has_value();
+}
+
+bool IdentifierIndex::mentions(InternedId module, std::string_view name) const
+{
+    if (!isIndexed(module))
+        return false;
+
+    auto id = names.find(name);
+    if (!id)
+        return false;
+
+    const auto& ids = *modules[module.value];
+    return std::binary_search(ids.begin(), ids.end(), *id);
+}
+
+void IdentifierIndex::invalidate(InternedId module)
+{
+    std::lock_guard lock(staleMutex);
+    stale.insert(module);
+}
+
+void IdentifierIndex::dropStale()
+{
+    std::unordered_set<InternedId> invalidated;
+    {
+        std::lock_guard lock(staleMutex);
+        invalidated.swap(stale);
+    }
+
+    for (auto module : invalidated)
+        if (module.value < modules.size())
+            modules[module.value] = std::nullopt;
+}
+
+void IdentifierIndex::clear()
+{
+    modules.clear();
+
+    std::lock_guard lock(staleMutex);
+    stale.clear();
+}
@@ -0,0 +1,394 @@
+#include "LSP/IndexCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "LSP/Utils.hpp"
+
+// All records are made of 32-bit fields (hashes are split in two) so that they have no padding, and are read with memcpy so that
+// the buffer does not need to be aligned. Integers are stored in native byte order: the cache is never shared between machines
+namespace
+{
+constexpr char kMagic[8] = {'L', 'U', 'A', 'U', 'I', 'D', 'X', '\0'};
+
+struct Header
+{
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t keyHashLow;
+    uint32_t keyHashHigh;
+    uint32_t moduleCount;
+    uint32_t requireCount;
+    uint32_t exportCount;
+    uint32_t symbolCount;
+    uint32_t stringRequireCount;
+    uint32_t stringBytes;
+};
+
+struct StringRef
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct LocationRecord
+{
+    uint32_t beginLine;
+    uint32_t beginColumn;
+    uint32_t endLine;
+    uint32_t endColumn;
+};
+
+struct ModuleRecord
+{
+    StringRef name;
+    uint32_t contentHashLow;
+    uint32_t contentHashHigh;
+    uint32_t firstRequire;
+    uint32_t requireCount;
+    uint32_t firstExport;
+    uint32_t exportCount;
+    uint32_t firstSymbol;
+    uint32_t symbolCount;
+    uint32_t firstStringRequire;
+    uint32_t stringRequireCount;
+};
+
+struct RequireRecord
+{
+    StringRef name;
+    LocationRecord location;
+};
+
+struct StringRequireRecord
+{
+    StringRef requiredString;
+    StringRef resolvedName;
+};
+
+struct SymbolRecord
+{
+    StringRef name;
+    uint32_t kind;
+    LocationRecord location;
+};
+
+LocationRecord toRecord(const Luau::Location& location)
+{
+    return {location.begin.line, location.begin.column, location.end.line, location.end.column};
+}
+
+Luau::Location fromRecord(const LocationRecord& record)
+{
+    return {{record.beginLine, record.beginColumn}, {record.endLine, record.endColumn}};
+}
+
+/// Offsets of each table within the file
+struct Layout
+{
+    size_t moduleTable;
+    size_t requireTable;
+    size_t exportTable;
+    size_t symbolTable;
+    size_t stringRequireTable;
+    size_t stringPool;
+    size_t end;
+
+    explicit Layout(const Header& header)
+        : moduleTable(sizeof(Header))
+        , requireTable(moduleTable + size_t(header.moduleCount) * sizeof(ModuleRecord))
+        , exportTable(requireTable + size_t(header.requireCount) * sizeof(RequireRecord))
+        , symbolTable(exportTable + size_t(header.exportCount) * sizeof(StringRef))
+        , stringRequireTable(symbolTable + size_t(header.symbolCount) * sizeof(SymbolRecord))
+        , stringPool(stringRequireTable + size_t(header.stringRequireCount) * sizeof(StringRequireRecord))
+        , end(stringPool + header.stringBytes)
+    {
+    }
+};
+} // namespace
+
+uint64_t hashIndexContent(std::string_view content)
+{
+    // FNV-1a over 8 byte words, with an extra shift so that the high bits of each word affect the low bits of the hash
+    constexpr uint64_t kPrime = 0x100000001b3ull;
+    uint64_t hash = 0xcbf29ce484222325ull ^ content.size();
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= content.size(); i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, content.data() + i, sizeof(word));
+        hash = (hash ^ word) * kPrime;
+        hash ^= hash >> 29;
+    }
+    for (; i < content.size(); i++)
+        hash = (hash ^ static_cast<unsigned char>(content[i])) * kPrime;
+
+    return hash;
+}
+
+template<typename Record>
+Record IndexCache::record(size_t offset) const
+{
+    Record result;
+    memcpy(&result, data.data() + offset, sizeof(Record));
+    return result;
+}
+
+std::string_view IndexCache::moduleName(size_t index) const
+{
+    auto header = record<Header>(0);
+    Layout layout(header);
+    auto module = record<ModuleRecord>(layout.moduleTable + index * sizeof(ModuleRecord));
+    if (size_t(module.name.offset) + module.name.length > header.stringBytes)
+        return {};
+    return std::string_view(data).substr(layout.stringPool + module.name.offset, module.name.length);
+}
+
+IndexCache IndexCache::load(const std::filesystem::path& path, std::string_view key)
+{
+    IndexCache cache;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return cache;
+
+    auto size = static_cast<std::streamoff>(file.tellg());
+    if (size < static_cast<std::streamoff>(sizeof(Header)))
+        return cache;
+
+    std::string data(static_cast<size_t>(size), '\0');
+    file.seekg(0);
+    if (!file.read(data.data(), size))
+        return cache;
+
+    Header header;
+    memcpy(&header, data.data(), sizeof(Header));
+
+    uint64_t keyHash = hashIndexContent(key);
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.formatVersion != kFormatVersion ||
+        header.keyHashLow != static_cast<uint32_t>(keyHash) || header.keyHashHigh != static_cast<uint32_t>(keyHash >> 32))
+        return cache;
+
+    // Every string reference is checked against the string pool when it is read, so the table sizes are all that need to be checked here
+    if (Layout(header).end != data.size())
+        return cache;
+
+    cache.data = std::move(data);
+    cache.moduleCount = header.moduleCount;
+    return cache;
+}
+
+std::optional<IndexedModule> IndexCache::find(std::string_view name, uint64_t contentHash) const
+{
+    if (moduleCount == 0)
+        return std::nullopt;
+
+    auto header = record<Header>(0);
+    Layout layout(header);
+
+    auto readString = [&](const StringRef& ref) -> std::optional<std::string>
+    {
+        if (size_t(ref.offset) + ref.length > header.stringBytes)
+            return std::nullopt;
+        return data.substr(layout.stringPool + ref.offset, ref.length);
+    };
+
+    // Binary search the modules, which are sorted by name
+    size_t low = 0;
+    size_t high = moduleCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (moduleName(middle) < name)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == moduleCount || moduleName(low) != name)
+        return std::nullopt;
+
+    auto module = record<ModuleRecord>(layout.moduleTable + low * sizeof(ModuleRecord));
+    if (module.contentHashLow != static_cast<uint32_t>(contentHash) || module.contentHashHigh != static_cast<uint32_t>(contentHash >> 32))
+        return std::nullopt;
+
+    if (size_t(module.firstRequire) + module.requireCount > header.requireCount ||
+        size_t(module.firstExport) + module.exportCount > header.exportCount ||
+        size_t(module.firstSymbol) + module.symbolCount > header.symbolCount ||
+        size_t(module.firstStringRequire) + module.stringRequireCount > header.stringRequireCount)
+        return std::nullopt;
+
+    IndexedModule result;
+    result.contentHash = contentHash;
+
+    result.requireLocations.reserve(module.requireCount);
+    for (size_t i = module.firstRequire; i < size_t(module.firstRequire) + module.requireCount; i++)
+    {
+        auto require = record<RequireRecord>(layout.requireTable + i * sizeof(RequireRecord));
+        auto requireName = readString(require.name);
+        if (!requireName)
+            return std::nullopt;
+        result.requireLocations.emplace_back(std::move(*requireName), fromRecord(require.location));
+    }
+
+    result.exportedTypes.reserve(module.exportCount);
+    for (size_t i = module.firstExport; i < size_t(module.firstExport) + module.exportCount; i++)
+    {
+        auto exportedType = readString(record<StringRef>(layout.exportTable + i * sizeof(StringRef)));
+        if (!exportedType)
+            return std::nullopt;
+        result.exportedTypes.emplace_back(std::move(*exportedType));
+    }
+
+    result.symbols.reserve(module.symbolCount);
+    for (size_t i = module.firstSymbol; i < size_t(module.firstSymbol) + module.symbolCount; i++)
+    {
+        auto symbol = record<SymbolRecord>(layout.symbolTable + i * sizeof(SymbolRecord));
+        auto symbolName = readString(symbol.name);
+        if (!symbolName)
+            return std::nullopt;
+        result.symbols.push_back(IndexedSymbol{std::move(*symbolName), static_cast<lsp::SymbolKind>(symbol.kind), fromRecord(symbol.location)});
+    }
+
+    result.stringRequires.reserve(module.stringRequireCount);
+    for (size_t i = module.firstStringRequire; i < size_t(module.firstStringRequire) + module.stringRequireCount; i++)
+    {
+        auto stringRequire = record<StringRequireRecord>(layout.stringRequireTable + i * sizeof(StringRequireRecord));
+        auto requiredString = readString(stringRequire.requiredString);
+        auto resolvedName = readString(stringRequire.resolvedName);
+        if (!requiredString || !resolvedName)
+            return std::nullopt;
+        result.stringRequires.emplace_back(std::move(*requiredString), std::move(*resolvedName));
+    }
+
+    return result;
+}
+
+bool IndexCache::save(const std::filesystem::path& path, std::string_view key, const std::unordered_map<std::string, IndexedModule>& modules)
+{
+    std::vector<std::pair<std::string_view, const IndexedModule*>> sorted;
+    sorted.reserve(modules.size());
+    for (const auto& [name, module] : modules)
+        sorted.emplace_back(name, &module);
+    std::sort(sorted.begin(), sorted.end(),
+        [](const auto& a, const auto& b)
+        {
+            return a.first < b.first;
+        });
+
+    std::vector<ModuleRecord> moduleRecords;
+    std::vector<RequireRecord> requireRecords;
+    std::vector<StringRef> exportRecords;
+    std::vector<SymbolRecord> symbolRecords;
+    std::vector<StringRequireRecord> stringRequireRecords;
+    std::string strings;
+
+    // Module names are repeated across requires, so each distinct string is only stored once
+    std::unordered_map<std::string_view, StringRef> stringRefs;
+    auto addString = [&](std::string_view string)
+    {
+        if (auto it = stringRefs.find(string); it != stringRefs.end())
+            return it->second;
+
+        StringRef ref{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(string.size())};
+        strings.append(string);
+        stringRefs.emplace(string, ref);
+        return ref;
+    };
+
+    moduleRecords.reserve(sorted.size());
+    for (const auto& [name, module] : sorted)
+    {
+        ModuleRecord record{};
+        record.name = addString(name);
+        record.contentHashLow = static_cast<uint32_t>(module->contentHash);
+        record.contentHashHigh = static_cast<uint32_t>(module->contentHash >> 32);
+
+        record.firstRequire = static_cast<uint32_t>(requireRecords.size());
+        record.requireCount = static_cast<uint32_t>(module->requireLocations.size());
+        for (const auto& [requireName, location] : module->requireLocations)
+            requireRecords.push_back({addString(requireName), toRecord(location)});
+
+        record.firstExport = static_cast<uint32_t>(exportRecords.size());
+        record.exportCount = static_cast<uint32_t>(module->exportedTypes.size());
+        for (const auto& exportedType : module->exportedTypes)
+            exportRecords.push_back(addString(exportedType));
+
+        record.firstSymbol = static_cast<uint32_t>(symbolRecords.size());
+        record.symbolCount = static_cast<uint32_t>(module->symbols.size());
+        for (const auto& symbol : module->symbols)
+            symbolRecords.push_back({addString(symbol.name), static_cast<uint32_t>(symbol.kind), toRecord(symbol.location)});
+
+        record.firstStringRequire = static_cast<uint32_t>(stringRequireRecords.size());
+        record.stringRequireCount = static_cast<uint32_t>(module->stringRequires.size());
+        for (const auto& [requiredString, resolvedName] : module->stringRequires)
+            stringRequireRecords.push_back({addString(requiredString), addString(resolvedName)});
+
+        moduleRecords.push_back(record);
+    }
+
+    if (strings.size() > UINT32_MAX)
+        return false;
+
+    uint64_t keyHash = hashIndexContent(key);
+    Header header{};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.formatVersion = kFormatVersion;
+    header.keyHashLow = static_cast<uint32_t>(keyHash);
+    header.keyHashHigh = static_cast<uint32_t>(keyHash >> 32);
+    header.moduleCount = static_cast<uint32_t>(moduleRecords.size());
+    header.requireCount = static_cast<uint32_t>(requireRecords.size());
+    header.exportCount = static_cast<uint32_t>(exportRecords.size());
+    header.symbolCount = static_cast<uint32_t>(symbolRecords.size());
+    header.stringRequireCount = static_cast<uint32_t>(stringRequireRecords.size());
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+
+    // Written to a temporary file first, so that another server starting up never reads a partially written cache
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+
+        auto write = [&](const auto& records)
+        {
+            file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(records[0])));
+        };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write(moduleRecords);
+        write(requireRecords);
+        write(exportRecords);
+        write(symbolRecords);
+        write(stringRequireRecords);
+        file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+        if (!file)
+            return false;
+    }
+
+    std::filesystem::rename(temporaryPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temporaryPath, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::filesystem::path> IndexCache::pathForWorkspace(const std::filesystem::path& root)
+{
+    auto cacheDirectory = getCacheDirectory();
+    if (!cacheDirectory)
+        return std::nullopt;
+
+    std::ostringstream name;
+    name << "index-" << std::hex << std::setw(16) << std::setfill('0') << hashIndexContent(root.generic_string()) << ".bin";
+    return *cacheDirectory / "luau-lsp" / name.str();
+}
@@ -0,0 +1,42 @@
+#include "LSP/Interner.hpp"
+
+#include <mutex>
+
+InternedId StringInterner::intern(std::string_view string)
+{
+    {
+        std::shared_lock lock(mutex);
+        if (auto it = ids.find(string); it != ids.end())
+            return it->second;
+    }
+
+    std::unique_lock lock(mutex);
+    // Another thread may have interned the string whilst the lock was released
+    if (auto it = ids.find(string); it != ids.end())
+        return it->second;
+
+    InternedId id{static_cast<uint32_t>(strings.size())};
+    const std::string& stored = strings.emplace_back(string);
+    ids.emplace(std::string_view(stored), id);
+    return id;
+}
+
+std::optional<InternedId> StringInterner::find(std::string_view string) const
+{
+    std::shared_lock lock(mutex);
+    if (auto it = ids.find(string); it != ids.end())
+        return it->second;
+    return std::nullopt;
+}
+
+const std::string& StringInterner::lookup(InternedId id) const
+{
+    std::shared_lock lock(mutex);
+    return strings.at(id.value);
+}
+
+size_t StringInterner::size() const
+{
+    std::shared_lock lock(mutex);
+    return strings.size();
+}
@@ -1,5 +1,6 @@
 #include "LSP/JsonRpc.hpp"
 
+#include <cstring>
 #include <string>
 #include <variant>
 
@@ -11,92 +12,263 @@ using json = nlohmann::json;
 
 namespace json_rpc
 {
-JsonRpcMessage parse(const std::string& jsonString)
+namespace
+{
+[[noreturn]] void throwMalformed()
 {
-    auto j = json::parse(jsonString);
-    std::string jsonrpc_version = j.at("jsonrpc").get<std::string>();
+    throw JsonRpcException(lsp::ErrorCode::ParseError, "malformed json-rpc message");
+}
 
-    if (jsonrpc_version != "2.0")
-        throw JsonRpcException(lsp::ErrorCode::ParseError, "not a json-rpc 2.0 message");
+size_t skipWhitespace(std::string_view text, size_t pos)
+{
+    while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+        pos++;
+    return pos;
+}
 
-    // Parse id - if no id, then this is a notification
-    std::optional<id_type> id;
-    if (j.contains("id"))
+/// Returns the position after the closing quote of the string starting at pos
+size_t skipString(std::string_view text, size_t pos)
+{
+    // Strings such as document contents make up the majority of large messages, so search for quotes with memchr
+    // rather than walking every character, and only then check whether the quote was escaped
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    const char* cursor = begin + pos + 1;
+    while (cursor < end)
     {
-        if (j.at("id").is_string())
-        {
-            id = j.at("id").get<std::string>();
-        }
-        else if (j.at("id").is_number())
+        auto quote = static_cast<const char*>(std::memchr(cursor, '"', size_t(end - cursor)));
+        if (!quote)
+            break;
+
+        size_t backslashes = 0;
+        for (const char* c = quote - 1; c >= begin + pos + 1 && *c == '\\'; c--)
+            backslashes++;
+
+        if (backslashes % 2 == 0)
+            return size_t(quote - begin) + 1;
+        cursor = quote + 1;
+    }
+    throwMalformed();
+}
+
+/// Returns the position after the end of the value starting at pos.
+/// Values are only validated by their structure: they are fully validated once parsed
+size_t skipValue(std::string_view text, size_t pos)
+{
+    if (pos >= text.size())
+        throwMalformed();
+
+    if (text[pos] == '"')
+        return skipString(text, pos);
+
+    if (text[pos] == '{' || text[pos] == '[')
+    {
+        size_t depth = 0;
+        while (pos < text.size())
         {
-            id = j.at("id").get<int>();
+            char c = text[pos];
+            if (c == '"')
+            {
+                pos = skipString(text, pos);
+                continue;
+            }
+            else if (c == '{' || c == '[')
+                depth++;
+            else if (c == '}' || c == ']')
+            {
+                if (--depth == 0)
+                    return pos + 1;
+            }
+            pos++;
         }
+        throwMalformed();
     }
 
-    // Parse method - if no method then this is a response
-    std::optional<std::string> method;
-    if (j.contains("method"))
-        j.at("method").get_to(method);
+    // Number or literal
+    size_t start = pos;
+    while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' && text[pos] != ' ' && text[pos] != '\t' &&
+           text[pos] != '\n' && text[pos] != '\r')
+        pos++;
+    if (pos == start)
+        throwMalformed();
+    return pos;
+}
 
-    // Parse params (if present)
-    std::optional<json> params;
-    if (j.contains("params"))
-        params = j.at("params");
+/// Calls the callback with the raw key and the span of the value of each member of the object, until the callback returns false.
+/// Keys are compared unescaped, which is sufficient for the keys defined by the protocol
+template<typename Callback>
+void forEachMember(std::string_view text, Callback&& callback)
+{
+    size_t pos = skipWhitespace(text, 0);
+    if (pos >= text.size() || text[pos] != '{')
+        throwMalformed();
 
-    // Parse result if present
-    std::optional<json> result;
-    if (j.contains("result"))
-        result = j.at("result");
+    pos = skipWhitespace(text, pos + 1);
+    if (pos < text.size() && text[pos] == '}')
+        return;
 
-    // Parse error if present
-    std::optional<JsonRpcException> error;
-    if (j.contains("error"))
+    while (true)
     {
-        auto err = j.at("error");
-        auto code = err.at("code").get<lsp::ErrorCode>();
-        auto message = err.at("message").get<std::string>();
-        if (err.contains("data"))
-        {
-            error = JsonRpcException(code, message, err.at("data"));
-        }
+        if (pos >= text.size() || text[pos] != '"')
+            throwMalformed();
+        size_t keyEnd = skipString(text, pos);
+        std::string_view key = text.substr(pos + 1, keyEnd - pos - 2);
+
+        pos = skipWhitespace(text, keyEnd);
+        if (pos >= text.size() || text[pos] != ':')
+            throwMalformed();
+
+        size_t valueStart = skipWhitespace(text, pos + 1);
+        size_t valueEnd = skipValue(text, valueStart);
+        if (!callback(key, valueStart, valueEnd - valueStart))
+            return;
+
+        pos = skipWhitespace(text, valueEnd);
+        if (pos < text.size() && text[pos] == ',')
+            pos = skipWhitespace(text, pos + 1);
+        else if (pos < text.size() && text[pos] == '}')
+            return;
         else
-        {
-            error = JsonRpcException(code, message);
-        }
+            throwMalformed();
     }
+}
+
+JsonRpcException parseError(const json& err)
+{
+    auto code = err.at("code").get<lsp::ErrorCode>();
+    auto message = err.at("message").get<std::string>();
+    if (err.contains("data"))
+        return JsonRpcException(code, message, err.at("data"));
+    return JsonRpcException(code, message);
+}
+} // namespace
 
-    return JsonRpcMessage{id, method, params, result, error};
+json RawJson::parse() const
+{
+    auto text = view();
+    return json::parse(text.begin(), text.end());
+}
+
+std::optional<RawJson> RawJson::find(std::string_view key) const
+{
+    auto text = view();
+    size_t pos = skipWhitespace(text, 0);
+    if (pos >= text.size() || text[pos] != '{')
+        return std::nullopt;
+
+    std::optional<RawJson> result;
+    forEachMember(text,
+        [&](std::string_view memberKey, size_t valueOffset, size_t valueLength)
+        {
+            if (memberKey != key)
+                return true;
+            result = RawJson(source, offset + valueOffset, valueLength);
+            return false;
+        });
+    return result;
+}
+
+JsonRpcMessage parse(std::shared_ptr<const std::string> body)
+{
+    // Only the envelope is parsed here. Params are left as a span of the body, so that large payloads (e.g. didOpen)
+    // are parsed once, when handled, and never for messages which are cancelled or superseded before then
+    JsonRpcMessage message;
+    message.contentLength = body->size();
+    bool isJsonRpc2 = false;
+
+    std::string_view text = *body;
+    forEachMember(text,
+        [&](std::string_view key, size_t valueOffset, size_t valueLength)
+        {
+            auto value = text.substr(valueOffset, valueLength);
+            if (key == "jsonrpc")
+                isJsonRpc2 = value == "\"2.0\"";
+            else if (key == "id")
+            {
+                // If no id, then this is a notification
+                auto id = json::parse(value.begin(), value.end());
+                if (id.is_string())
+                    message.id = id.get<std::string>();
+                else if (id.is_number())
+                    message.id = id.get<int>();
+            }
+            else if (key == "method")
+                message.method = json::parse(value.begin(), value.end()).get<std::string>();
+            else if (key == "params")
+                message.rawParams = RawJson(body, valueOffset, valueLength);
+            else if (key == "result")
+                message.result = json::parse(value.begin(), value.end());
+            else if (key == "error")
+                message.error = parseError(json::parse(value.begin(), value.end()));
+            return true;
+        });
+
+    if (!isJsonRpc2)
+        throw JsonRpcException(lsp::ErrorCode::ParseError, "not a json-rpc 2.0 message");
+
+    return message;
+}
+
+JsonRpcMessage parse(const std::string& jsonString)
+{
+    return parse(std::make_shared<const std::string>(jsonString));
 }
 
 /// Reads a JSON-RPC message from input
 bool readRawMessage(std::istream& input, std::string& output)
 {
-    unsigned int contentLength = 0;
-    std::string line;
+    // Headers are read directly from the stream buffer, so that framing does not allocate.
+    // Only the body is allocated, as it is referenced by the message until it is handled
+    auto* buffer = input.rdbuf();
+    constexpr std::string_view contentLengthHeader = "Content-Length:";
+
+    size_t contentLength = 0;
+    bool foundContentLength = false;
 
-    // Read the headers
     while (true)
     {
-        if (!input)
-            return false;
-        std::getline(input, line);
-
-        if (Luau::startsWith(line, "Content-Length: "))
+        // Read a single header line, only retaining as much as is required to match the Content-Length header
+        char line[32];
+        size_t lineLength = 0;
+        size_t totalLength = 0;
+        while (true)
         {
-            if (contentLength != 0)
+            auto c = buffer->sbumpc();
+            if (c == std::char_traits<char>::eof())
             {
-                std::cerr << "Duplicate content-length header found. Discarding old value";
+                input.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+                return false;
             }
-            std::string len = line.substr(16);
-            trim_end(len);
-            contentLength = std::stoi(len);
-            continue;
+            if (c == '\n')
+                break;
+            if (lineLength < sizeof(line))
+                line[lineLength++] = static_cast<char>(c);
+            totalLength++;
         }
 
-        // Trim line and check if its empty (i.e., we have ended the header block)
-        trim_end(line);
-        if (line.empty())
+        std::string_view header(line, lineLength);
+        while (!header.empty() && (header.back() == '\r' || header.back() == ' '))
+            header.remove_suffix(1);
+
+        // An empty line ends the header block
+        if (header.empty() && totalLength == lineLength)
             break;
+
+        if (Luau::startsWith(header, contentLengthHeader))
+        {
+            if (foundContentLength)
+                std::cerr << "Duplicate content-length header found. Discarding old value";
+
+            contentLength = 0;
+            foundContentLength = true;
+            for (char c : header.substr(contentLengthHeader.size()))
+            {
+                if (c >= '0' && c <= '9')
+                    contentLength = contentLength * 10 + static_cast<size_t>(c - '0');
+                else if (c != ' ')
+                    break;
+            }
+        }
     }
 
     // Check if no Content-Length found
@@ -109,17 +281,35 @@ bool readRawMessage(std::istream& input, std::string& output)
 
     // Read the JSON message into output
     output.resize(contentLength);
-    input.read(&output[0], contentLength);
+    auto read = buffer->sgetn(&output[0], static_cast<std::streamsize>(contentLength));
+    if (read != static_cast<std::streamsize>(contentLength))
+    {
+        input.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+        return false;
+    }
     return true;
 }
 
+void writeFramedBody(std::string& buffer, std::string_view body)
+{
+    buffer.append("Content-Length: ");
+    buffer.append(std::to_string(body.length()));
+    buffer.append("\r\n\r\n");
+    buffer.append(body);
+}
+
+void writeRawMessage(std::string& buffer, const json& message)
+{
+    // Invalid UTF-8 (e.g. from user source code) is replaced rather than failing the whole message
+    writeFramedBody(buffer, message.dump(-1, ' ', false, json::error_handler_t::replace));
+}
+
 /// Sends a raw JSON-RPC message to output stream
 void sendRawMessage(std::ostream& output, const json& message)
 {
-    std::string s = message.dump();
-    output << "Content-Length: " << s.length() << "\r\n";
-    output << "\r\n";
-    output << s;
+    std::string buffer;
+    writeRawMessage(buffer, message);
+    output << buffer;
     output.flush();
 }
 
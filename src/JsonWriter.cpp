@@ -0,0 +1,333 @@
+#include "LSP/JsonWriter.hpp"
+
+#include <cassert>
+#include <charconv>
+
+void JsonWriter::separator()
+{
+    if (afterKey)
+    {
+        afterKey = false;
+        return;
+    }
+
+    if (depth == 0)
+        return;
+
+    uint64_t bit = uint64_t(1) << (depth - 1);
+    if (hasValue & bit)
+        buffer.push_back(',');
+    else
+        hasValue |= bit;
+}
+
+void JsonWriter::beginObject()
+{
+    separator();
+    buffer.push_back('{');
+    depth++;
+    assert(depth <= 64);
+    hasValue &= ~(uint64_t(1) << (depth - 1));
+}
+
+void JsonWriter::endObject()
+{
+    buffer.push_back('}');
+    depth--;
+}
+
+void JsonWriter::beginArray()
+{
+    separator();
+    buffer.push_back('[');
+    depth++;
+    assert(depth <= 64);
+    hasValue &= ~(uint64_t(1) << (depth - 1));
+}
+
+void JsonWriter::endArray()
+{
+    buffer.push_back(']');
+    depth--;
+}
+
+void JsonWriter::key(std::string_view key)
+{
+    separator();
+    writeString(key);
+    buffer.push_back(':');
+    afterKey = true;
+}
+
+/// Returns the length of the valid UTF-8 sequence starting at pos, or 0 if it is invalid
+static size_t validUtf8SequenceLength(std::string_view str, size_t pos)
+{
+    auto byte = [&](size_t i)
+    {
+        return static_cast<unsigned char>(str[i]);
+    };
+    auto isContinuation = [&](size_t i)
+    {
+        return i < str.size() && (byte(i) & 0xC0) == 0x80;
+    };
+
+    unsigned char lead = byte(pos);
+    if (lead >= 0xC2 && lead <= 0xDF)
+        return isContinuation(pos + 1) ? 2 : 0;
+    if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        if (!isContinuation(pos + 1) || !isContinuation(pos + 2))
+            return 0;
+        // Reject overlong encodings and surrogates
+        if ((lead == 0xE0 && byte(pos + 1) < 0xA0) || (lead == 0xED && byte(pos + 1) > 0x9F))
+            return 0;
+        return 3;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        if (!isContinuation(pos + 1) || !isContinuation(pos + 2) || !isContinuation(pos + 3))
+            return 0;
+        if ((lead == 0xF0 && byte(pos + 1) < 0x90) || (lead == 0xF4 && byte(pos + 1) > 0x8F))
+            return 0;
+        return 4;
+    }
+    return 0;
+}
+
+void JsonWriter::writeString(std::string_view str)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+
+    buffer.push_back('"');
+
+    size_t runStart = 0;
+    size_t pos = 0;
+    while (pos < str.size())
+    {
+        unsigned char c = static_cast<unsigned char>(str[pos]);
+        if (c >= 0x20 && c != '"' && c != '\\' && c < 0x80)
+        {
+            pos++;
+            continue;
+        }
+
+        if (c >= 0x80)
+        {
+            if (size_t length = validUtf8SequenceLength(str, pos))
+            {
+                pos += length;
+                continue;
+            }
+        }
+
+        // Flush the run of characters which do not need escaping
+        buffer.append(str.data() + runStart, pos - runStart);
+
+        switch (c)
+        {
+        case '"':
+            buffer.append("\\\"");
+            break;
+        case '\\':
+            buffer.append("\\\\");
+            break;
+        case '\b':
+            buffer.append("\\b");
+            break;
+        case '\f':
+            buffer.append("\\f");
+            break;
+        case '\n':
+            buffer.append("\\n");
+            break;
+        case '\r':
+            buffer.append("\\r");
+            break;
+        case '\t':
+            buffer.append("\\t");
+            break;
+        default:
+            if (c < 0x20)
+            {
+                char escaped[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                buffer.append(escaped, sizeof(escaped));
+            }
+            else
+            {
+                // Invalid UTF-8: replace with U+FFFD
+                buffer.append("\xEF\xBF\xBD");
+            }
+            break;
+        }
+
+        pos++;
+        runStart = pos;
+    }
+
+    buffer.append(str.data() + runStart, str.size() - runStart);
+    buffer.push_back('"');
+}
+
+void JsonWriter::value(std::string_view str)
+{
+    separator();
+    writeString(str);
+}
+
+void JsonWriter::value(bool b)
+{
+    separator();
+    buffer.append(b ? "true" : "false");
+}
+
+void JsonWriter::value(int64_t number)
+{
+    separator();
+    char digits[24];
+    auto result = std::to_chars(std::begin(digits), std::end(digits), number);
+    buffer.append(digits, result.ptr);
+}
+
+void JsonWriter::value(uint64_t number)
+{
+    separator();
+    char digits[24];
+    auto result = std::to_chars(std::begin(digits), std::end(digits), number);
+    buffer.append(digits, result.ptr);
+}
+
+void JsonWriter::value(std::nullptr_t)
+{
+    separator();
+    buffer.append("null");
+}
+
+void JsonWriter::value(const json& j)
+{
+    separator();
+    buffer.append(j.dump(-1, ' ', false, json::error_handler_t::replace));
+}
+
+void write(JsonWriter& writer, const std::variant<std::string, int>& value)
+{
+    if (auto str = std::get_if<std::string>(&value))
+        writer.value(*str);
+    else
+        writer.value(std::get<int>(value));
+}
+
+namespace lsp
+{
+void write(JsonWriter& writer, const Position& position)
+{
+    writer.beginObject();
+    writer.field("line", position.line);
+    writer.field("character", position.character);
+    writer.endObject();
+}
+
+void write(JsonWriter& writer, const Range& range)
+{
+    writer.beginObject();
+    writer.field("start", range.start);
+    writer.field("end", range.end);
+    writer.endObject();
+}
+
+void write(JsonWriter& writer, const TextEdit& edit)
+{
+    writer.beginObject();
+    writer.field("range", edit.range);
+    writer.field("newText", edit.newText);
+    writer.endObject();
+}
+
+void write(JsonWriter& writer, const MarkupContent& content)
+{
+    writer.beginObject();
+    writer.field("kind", content.kind);
+    writer.field("value", content.value);
+    writer.endObject();
+}
+
+void write(JsonWriter& writer, const CompletionItem& item)
+{
+    writer.beginObject();
+    writer.field("label", item.label);
+    // An object with no fields set is serialized as null by to_json, and therefore omitted
+    if (item.labelDetails && (item.labelDetails->detail || item.labelDetails->description))
+    {
+        writer.key("labelDetails");
+        writer.beginObject();
+        writer.optionalField("detail", item.labelDetails->detail);
+        writer.optionalField("description", item.labelDetails->description);
+        writer.endObject();
+    }
+    writer.optionalField("kind", item.kind);
+    writer.optionalField("tags", item.tags);
+    writer.optionalField("detail", item.detail);
+    writer.optionalField("documentation", item.documentation);
+    writer.field("deprecated", item.deprecated);
+    writer.field("preselect", item.preselect);
+    writer.optionalField("sortText", item.sortText);
+    writer.optionalField("filterText", item.filterText);
+    writer.optionalField("insertText", item.insertText);
+    writer.field("insertTextFormat", item.insertTextFormat);
+    writer.optionalField("insertTextMode", item.insertTextMode);
+    writer.optionalField("textEdit", item.textEdit);
+    writer.optionalField("textEditString", item.textEditString);
+    writer.field("additionalTextEdits", item.additionalTextEdits);
+    writer.optionalField("commitCharacters", item.commitCharacters);
+    writer.optionalField("command", item.command);
+    writer.endObject();
+}
+
+void write(JsonWriter& writer, const SemanticTokens& tokens)
+{
+    writer.beginObject();
+    writer.optionalField("resultId", tokens.resultId);
+    writer.field("data", tokens.data);
+    writer.endObject();
+}
+
+void write(JsonWriter& writer, const Diagnostic& diagnostic)
+{
+    writer.beginObject();
+    writer.field("range", diagnostic.range);
+    writer.optionalField("severity", diagnostic.severity);
+    writer.optionalField("code", diagnostic.code);
+    writer.optionalField("codeDescription", diagnostic.codeDescription);
+    writer.optionalField("source", diagnostic.source);
+    writer.field("message", diagnostic.message);
+    writer.field("tags", diagnostic.tags);
+    writer.field("relatedInformation", diagnostic.relatedInformation);
+    writer.endObject();
+}
+
+void write(JsonWriter& writer, const WorkspaceDocumentDiagnosticReport& report)
+{
+    // Serialized with NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT, so missing optionals are written as null
+    writer.beginObject();
+    writer.field("kind", report.kind);
+    writer.key("resultId");
+    if (report.resultId)
+        writer.value(*report.resultId);
+    else
+        writer.value(nullptr);
+    writer.field("items", report.items);
+    writer.field("uri", report.uri.toString());
+    writer.key("version");
+    if (report.version)
+        writer.value(uint64_t(*report.version));
+    else
+        writer.value(nullptr);
+    writer.endObject();
+}
+
+void write(JsonWriter& writer, const WorkspaceDiagnosticReport& report)
+{
+    writer.beginObject();
+    writer.field("items", report.items);
+    writer.endObject();
+}
+} // namespace lsp
@@ -6,6 +6,10 @@
 #include <variant>
 #include <exception>
 #include <algorithm>
+#include <thread>
+#include <chrono>
+#include <unordered_set>
+#include <utility>
 
 #include "LSP/Uri.hpp"
 #include "LSP/DocumentationParser.hpp"
@@ -108,7 +112,282 @@ lsp::ServerCapabilities LanguageServer::getServerCapabilities()
     return capabilities;
 }
 
-void LanguageServer::onRequest(const id_type& id, const std::string& method, std::optional<json> baseParams)
+namespace
+{
+/// Records the call count, latency and output of a method whilst in scope
+struct MethodCountersScope
+{
+    MethodCounters& counters;
+    std::chrono::steady_clock::time_point start;
+    OutputWriter::ByteCounter previousBytesOutCounter;
+    bool recordLatency = true;
+
+    MethodCountersScope(const MethodCountersPtr& countersPtr, size_t contentLength)
+        : counters(*countersPtr)
+        , start(std::chrono::steady_clock::now())
+        , previousBytesOutCounter(Client::bytesOutCounter)
+    {
+        counters.count.fetch_add(1, std::memory_order_relaxed);
+        counters.bytesIn.fetch_add(contentLength, std::memory_order_relaxed);
+        Client::bytesOutCounter = OutputWriter::ByteCounter(countersPtr, &counters.bytesOut);
+    }
+
+    ~MethodCountersScope()
+    {
+        if (recordLatency)
+            counters.latency.record(std::chrono::steady_clock::now() - start);
+        Client::bytesOutCounter = std::move(previousBytesOutCounter);
+    }
+
+    MethodCountersScope(const MethodCountersScope&) = delete;
+    MethodCountersScope& operator=(const MethodCountersScope&) = delete;
+};
+} // namespace
+
+void LanguageServer::registerRequest(const std::string& method, RequestHandler handler)
+{
+    requestHandlers.insert_or_assign(method, RegisteredRequest{std::move(handler), std::make_shared<MethodCounters>()});
+}
+
+void LanguageServer::registerNotification(const std::string& method, NotificationHandler handler)
+{
+    notificationHandlers.insert_or_assign(method, RegisteredNotification{std::move(handler), std::make_shared<MethodCounters>()});
+}
+
+void LanguageServer::registerHandlers()
+{
+    registerRequest("initialize",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, onInitialize(JSON_REQUIRED_PARAMS(params, "initialize")));
+        });
+    registerRequest("shutdown",
+        [this](const id_type& id, std::optional<json>, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, onShutdown(id));
+        });
+    registerRequest("textDocument/completion",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, completion(JSON_REQUIRED_PARAMS(params, "textDocument/completion")));
+        });
+    registerRequest("textDocument/documentLink",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, documentLink(JSON_REQUIRED_PARAMS(params, "textDocument/documentLink")));
+        });
+    registerRequest("textDocument/hover",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, hover(JSON_REQUIRED_PARAMS(params, "textDocument/hover")));
+        });
+    registerRequest("textDocument/signatureHelp",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, signatureHelp(JSON_REQUIRED_PARAMS(params, "textDocument/signatureHelp")));
+        });
+    registerRequest("textDocument/definition",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, gotoDefinition(JSON_REQUIRED_PARAMS(params, "textDocument/definition")));
+        });
+    registerRequest("textDocument/typeDefinition",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, gotoTypeDefinition(JSON_REQUIRED_PARAMS(params, "textDocument/typeDefinition")));
+        });
+    registerRequest("textDocument/references",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken& cancellationToken)
+        {
+            client->sendResponse(id, references(JSON_REQUIRED_PARAMS(params, "textDocument/references"), cancellationToken));
+        });
+    registerRequest("textDocument/rename",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken& cancellationToken)
+        {
+            client->sendResponse(id, rename(JSON_REQUIRED_PARAMS(params, "textDocument/rename"), cancellationToken));
+        });
+    registerRequest("textDocument/documentSymbol",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, documentSymbol(JSON_REQUIRED_PARAMS(params, "textDocument/documentSymbol")));
+        });
+    registerRequest("textDocument/codeAction",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, codeAction(JSON_REQUIRED_PARAMS(params, "textDocument/codeAction")));
+        });
+    registerRequest("textDocument/semanticTokens/full",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            if (auto tokens = semanticTokens(JSON_REQUIRED_PARAMS(params, "textDocument/semanticTokens/full")))
+                client->sendResponse(id, std::move(*tokens));
+            else
+                client->sendResponse(id, nullptr);
+        });
+    registerRequest("textDocument/inlayHint",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, inlayHint(JSON_REQUIRED_PARAMS(params, "textDocument/inlayHint")));
+        });
+    registerRequest("textDocument/documentColor",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, documentColor(JSON_REQUIRED_PARAMS(params, "textDocument/documentColor")));
+        });
+    registerRequest("textDocument/colorPresentation",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, colorPresentation(JSON_REQUIRED_PARAMS(params, "textDocument/colorPresentation")));
+        });
+    registerRequest("textDocument/prepareCallHierarchy",
+        [this](const id_type& id, std::optional<json> baseParams, const LSPCancellationToken&)
+        {
+            ASSERT_PARAMS(baseParams, "textDocument/prepareCallHierarchy")
+            auto params = baseParams->get<lsp::CallHierarchyPrepareParams>();
+            auto workspace = findWorkspace(params.textDocument.uri);
+            client->sendResponse(id, workspace->prepareCallHierarchy(params));
+        });
+    registerRequest("callHierarchy/incomingCalls",
+        [this](const id_type& id, std::optional<json> baseParams, const LSPCancellationToken& cancellationToken)
+        {
+            ASSERT_PARAMS(baseParams, "callHierarchy/incomingCalls")
+            auto params = baseParams->get<lsp::CallHierarchyIncomingCallsParams>();
+            auto workspace = findWorkspace(params.item.uri);
+            client->sendResponse(id, workspace->callHierarchyIncomingCalls(params, cancellationToken));
+        });
+    registerRequest("callHierarchy/outgoingCalls",
+        [this](const id_type& id, std::optional<json> baseParams, const LSPCancellationToken&)
+        {
+            ASSERT_PARAMS(baseParams, "callHierarchy/outgoingCalls")
+            auto params = baseParams->get<lsp::CallHierarchyOutgoingCallsParams>();
+            auto workspace = findWorkspace(params.item.uri);
+            client->sendResponse(id, workspace->callHierarchyOutgoingCalls(params));
+        });
+    registerRequest("textDocument/foldingRange",
+        [this](const id_type& id, std::optional<json> baseParams, const LSPCancellationToken&)
+        {
+            ASSERT_PARAMS(baseParams, "textDocument/foldingRange")
+            auto params = baseParams->get<lsp::FoldingRangeParams>();
+            auto workspace = findWorkspace(params.textDocument.uri);
+            client->sendResponse(id, workspace->foldingRange(params));
+        });
+    registerRequest("textDocument/diagnostic",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, documentDiagnostic(JSON_REQUIRED_PARAMS(params, "textDocument/diagnostic")));
+        });
+    registerRequest("workspace/diagnostic",
+        [this](const id_type& id, std::optional<json> params, const LSPCancellationToken& cancellationToken)
+        {
+            // The response (or streamed progress) is sent from the background as the workspace is checked
+            workspaceDiagnostic(id, JSON_REQUIRED_PARAMS(params, "workspace/diagnostic"), cancellationToken);
+        });
+    registerRequest("workspace/symbol",
+        [this](const id_type& id, std::optional<json> baseParams, const LSPCancellationToken&)
+        {
+            ASSERT_PARAMS(baseParams, "workspace/symbol")
+            auto params = baseParams->get<lsp::WorkspaceSymbolParams>();
+
+            std::vector<lsp::WorkspaceSymbol> result;
+            for (auto& workspace : workspaceFolders)
+            {
+                auto report = workspace->workspaceSymbol(params);
+                if (report)
+                    result.insert(result.end(), std::make_move_iterator(report->begin()), std::make_move_iterator(report->end()));
+            }
+            client->sendResponse(id, result);
+        });
+    registerRequest("luau-lsp/bytecode",
+        [this](const id_type& id, std::optional<json> baseParams, const LSPCancellationToken&)
+        {
+            ASSERT_PARAMS(baseParams, "luau-lsp/bytecode")
+            auto params = baseParams->get<lsp::BytecodeParams>();
+            auto workspace = findWorkspace(params.textDocument.uri);
+            client->sendResponse(id, workspace->bytecode(params));
+        });
+    registerRequest("luau-lsp/compilerRemarks",
+        [this](const id_type& id, std::optional<json> baseParams, const LSPCancellationToken&)
+        {
+            ASSERT_PARAMS(baseParams, "luau-lsp/compilerRemarks")
+            auto params = baseParams->get<lsp::CompilerRemarksParams>();
+            auto workspace = findWorkspace(params.textDocument.uri);
+            client->sendResponse(id, workspace->compilerRemarks(params));
+        });
+    registerRequest("luau-lsp/stats",
+        [this](const id_type& id, std::optional<json>, const LSPCancellationToken&)
+        {
+            client->sendResponse(id, stats());
+        });
+
+    registerNotification("exit",
+        [this](std::optional<json>)
+        {
+            // Exit the process loop, ensuring any queued responses are written first
+            Client::flushOutput();
+            std::exit(shutdownRequested ? 0 : 1);
+        });
+    registerNotification("initialized",
+        [this](std::optional<json> params)
+        {
+            onInitialized(JSON_REQUIRED_PARAMS(params, "initialized"));
+        });
+    registerNotification("$/setTrace",
+        [this](std::optional<json> params)
+        {
+            client->setTrace(JSON_REQUIRED_PARAMS(params, "$/setTrace"));
+        });
+    registerNotification("$/cancelRequest",
+        [](std::optional<json>)
+        {
+            // NO-OP: cancellation is handled by the input thread as soon as the notification is read,
+            // so that it can reach requests which are already in-flight
+        });
+    registerNotification("$/flushTimeTrace",
+        [](std::optional<json>)
+        {
+#if defined(LUAU_ENABLE_TIME_TRACE)
+            Luau::TimeTrace::getThreadContext().flushEvents();
+#endif
+        });
+    registerNotification("textDocument/didOpen",
+        [this](std::optional<json> params)
+        {
+            onDidOpenTextDocument(JSON_REQUIRED_PARAMS(params, "textDocument/didOpen"));
+        });
+    registerNotification("textDocument/didChange",
+        [this](std::optional<json> params)
+        {
+            onDidChangeTextDocument(JSON_REQUIRED_PARAMS(params, "textDocument/didChange"));
+        });
+    registerNotification("textDocument/didSave",
+        [](std::optional<json>)
+        {
+            // NO-OP
+        });
+    registerNotification("textDocument/didClose",
+        [this](std::optional<json> params)
+        {
+            onDidCloseTextDocument(JSON_REQUIRED_PARAMS(params, "textDocument/didClose"));
+        });
+    registerNotification("workspace/didChangeConfiguration",
+        [this](std::optional<json> params)
+        {
+            onDidChangeConfiguration(JSON_REQUIRED_PARAMS(params, "workspace/didChangeConfiguration"));
+        });
+    registerNotification("workspace/didChangeWorkspaceFolders",
+        [this](std::optional<json> params)
+        {
+            onDidChangeWorkspaceFolders(JSON_REQUIRED_PARAMS(params, "workspace/didChangeWorkspaceFolders"));
+        });
+    registerNotification("workspace/didChangeWatchedFiles",
+        [this](std::optional<json> params)
+        {
+            onDidChangeWatchedFiles(JSON_REQUIRED_PARAMS(params, "workspace/didChangeWatchedFiles"));
+        });
+}
+
+void LanguageServer::onRequest(const id_type& id, const std::string& method, std::optional<json> params,
+    const LSPCancellationToken& cancellationToken, size_t contentLength)
 {
     LUAU_TIMETRACE_SCOPE("LanguageServer::onRequest", "LSP");
     LUAU_TIMETRACE_ARGUMENT("method", method.c_str());
@@ -121,160 +400,54 @@ void LanguageServer::onRequest(const id_type& id, const std::string& method, std
     if (shutdownRequested)
         throw JsonRpcException(lsp::ErrorCode::InvalidRequest, "server is shutting down");
 
-    Response response;
+    auto it = requestHandlers.find(method);
+    if (it == requestHandlers.end())
+        throw JsonRpcException(lsp::ErrorCode::MethodNotFound, "method not found / supported: " + method);
 
-    if (method == "initialize")
-    {
-        response = onInitialize(JSON_REQUIRED_PARAMS(baseParams, "initialize"));
-    }
-    else if (method == "shutdown")
-    {
-        response = onShutdown(id);
-    }
-    else if (method == "textDocument/completion")
-    {
-        response = completion(JSON_REQUIRED_PARAMS(baseParams, "textDocument/completion"));
-    }
-    else if (method == "textDocument/documentLink")
-    {
-        response = documentLink(JSON_REQUIRED_PARAMS(baseParams, "textDocument/documentLink"));
-    }
-    else if (method == "textDocument/hover")
-    {
-        response = hover(JSON_REQUIRED_PARAMS(baseParams, "textDocument/hover"));
-    }
-    else if (method == "textDocument/signatureHelp")
-    {
-        response = signatureHelp(JSON_REQUIRED_PARAMS(baseParams, "textDocument/signatureHelp"));
-    }
-    else if (method == "textDocument/definition")
-    {
-        response = gotoDefinition(JSON_REQUIRED_PARAMS(baseParams, "textDocument/definition"));
-    }
-    else if (method == "textDocument/typeDefinition")
-    {
-        response = gotoTypeDefinition(JSON_REQUIRED_PARAMS(baseParams, "textDocument/typeDefinition"));
-    }
-    else if (method == "textDocument/references")
-    {
-        response = references(JSON_REQUIRED_PARAMS(baseParams, "textDocument/references"));
-    }
-    else if (method == "textDocument/rename")
-    {
-        response = rename(JSON_REQUIRED_PARAMS(baseParams, "textDocument/rename"));
-    }
-    else if (method == "textDocument/documentSymbol")
-    {
-        response = documentSymbol(JSON_REQUIRED_PARAMS(baseParams, "textDocument/documentSymbol"));
-    }
-    else if (method == "textDocument/codeAction")
-    {
-        response = codeAction(JSON_REQUIRED_PARAMS(baseParams, "textDocument/codeAction"));
-    }
-    // else if (method == "codeAction/resolve")
-    // {
-    //     response = codeActionResolve(JSON_REQUIRED_PARAMS(params, "codeAction/resolve"));
-    // }
-    else if (method == "textDocument/semanticTokens/full")
-    {
-        response = semanticTokens(JSON_REQUIRED_PARAMS(baseParams, "textDocument/semanticTokens/full"));
-    }
-    else if (method == "textDocument/inlayHint")
-    {
-        response = inlayHint(JSON_REQUIRED_PARAMS(baseParams, "textDocument/inlayHint"));
-    }
-    else if (method == "textDocument/documentColor")
-    {
-        response = documentColor(JSON_REQUIRED_PARAMS(baseParams, "textDocument/documentColor"));
-    }
-    else if (method == "textDocument/colorPresentation")
-    {
-        response = colorPresentation(JSON_REQUIRED_PARAMS(baseParams, "textDocument/colorPresentation"));
-    }
-    else if (method == "textDocument/prepareCallHierarchy")
-    {
-        ASSERT_PARAMS(baseParams, "textDocument/prepareCallHierarchy")
-        auto params = baseParams->get<lsp::CallHierarchyPrepareParams>();
-        auto workspace = findWorkspace(params.textDocument.uri);
-        response = workspace->prepareCallHierarchy(params);
-    }
-    else if (method == "callHierarchy/incomingCalls")
-    {
-        ASSERT_PARAMS(baseParams, "callHierarchy/incomingCalls")
-        auto params = baseParams->get<lsp::CallHierarchyIncomingCallsParams>();
-        auto workspace = findWorkspace(params.item.uri);
-        response = workspace->callHierarchyIncomingCalls(params);
-    }
-    else if (method == "callHierarchy/outgoingCalls")
-    {
-        ASSERT_PARAMS(baseParams, "callHierarchy/outgoingCalls")
-        auto params = baseParams->get<lsp::CallHierarchyOutgoingCallsParams>();
-        auto workspace = findWorkspace(params.item.uri);
-        response = workspace->callHierarchyOutgoingCalls(params);
-    }
-    else if (method == "textDocument/foldingRange")
+    MethodCountersScope countersScope(it->second.counters, contentLength);
+    activeRequest = ActiveRequest{it->second.counters, countersScope.start};
+    try
     {
-        ASSERT_PARAMS(baseParams, "textDocument/foldingRange")
-        auto params = baseParams->get<lsp::FoldingRangeParams>();
-        auto workspace = findWorkspace(params.textDocument.uri);
-        response = workspace->foldingRange(params);
+        it->second.handler(id, std::move(params), cancellationToken);
     }
-    else if (method == "textDocument/diagnostic")
+    catch (...)
     {
-        response = documentDiagnostic(JSON_REQUIRED_PARAMS(baseParams, "textDocument/diagnostic"));
+        activeRequest = std::nullopt;
+        throw;
     }
-    else if (method == "workspace/diagnostic")
+
+    countersScope.recordLatency = !activeRequest->deferred;
+    activeRequest = std::nullopt;
+}
+
+BackgroundTask LanguageServer::deferResponse(BackgroundTask step)
+{
+    LUAU_ASSERT(activeRequest);
+    activeRequest->deferred = true;
+
+    return [counters = activeRequest->counters, start = activeRequest->start, step = std::move(step)]()
     {
-        // This request has partial request support.
-        // If workspaceDiagnostic returns nothing, then we don't signal a response (as data will be sent as progress notifications)
-        if (auto report = workspaceDiagnostic(JSON_REQUIRED_PARAMS(baseParams, "workspace/diagnostic")))
+        auto previousBytesOutCounter = std::exchange(Client::bytesOutCounter, OutputWriter::ByteCounter(counters, &counters->bytesOut));
+        bool more = false;
+        try
         {
-            response = report;
+            more = step();
         }
-        else
+        catch (...)
         {
-            client->workspaceDiagnosticsRequestId = id;
-            return;
+            Client::bytesOutCounter = std::move(previousBytesOutCounter);
+            counters->latency.record(std::chrono::steady_clock::now() - start);
+            throw;
         }
-    }
-    else if (method == "workspace/symbol")
-    {
-        ASSERT_PARAMS(baseParams, "workspace/symbol")
-        auto params = baseParams->get<lsp::WorkspaceSymbolParams>();
-
-        std::vector<lsp::WorkspaceSymbol> result;
-        for (auto& workspace : workspaceFolders)
-        {
-            auto report = workspace->workspaceSymbol(params);
-            if (report)
-                result.insert(result.end(), std::make_move_iterator(report->begin()), std::make_move_iterator(report->end()));
-        }
-        response = result;
-    }
-    else if (method == "luau-lsp/bytecode")
-    {
-        ASSERT_PARAMS(baseParams, "luau-lsp/bytecode")
-        auto params = baseParams->get<lsp::BytecodeParams>();
-        auto workspace = findWorkspace(params.textDocument.uri);
-        response = workspace->bytecode(params);
-    }
 
-    else if (method == "luau-lsp/compilerRemarks")
-    {
-        ASSERT_PARAMS(baseParams, "luau-lsp/compilerRemarks")
-        auto params = baseParams->get<lsp::CompilerRemarksParams>();
-        auto workspace = findWorkspace(params.textDocument.uri);
-        response = workspace->compilerRemarks(params);
-    }
-    else
-    {
-        throw JsonRpcException(lsp::ErrorCode::MethodNotFound, "method not found / supported: " + method);
-    }
-
-    client->sendResponse(id, response);
+        Client::bytesOutCounter = std::move(previousBytesOutCounter);
+        if (!more)
+            counters->latency.record(std::chrono::steady_clock::now() - start);
+        return more;
+    };
 }
 
-void LanguageServer::onNotification(const std::string& method, std::optional<json> params)
+void LanguageServer::onNotification(const std::string& method, std::optional<json> params, size_t contentLength)
 {
     LUAU_TIMETRACE_SCOPE("LanguageServer::onNotification", "LSP");
     LUAU_TIMETRACE_ARGUMENT("method", method.c_str());
@@ -285,68 +458,32 @@ void LanguageServer::onNotification(const std::string& method, std::optional<jso
     if ((!isInitialized || shutdownRequested) && method != "exit")
         return;
 
-    if (method == "exit")
+    if (auto it = notificationHandlers.find(method); it != notificationHandlers.end())
     {
-        // Exit the process loop
-        std::exit(shutdownRequested ? 0 : 1);
-    }
-    else if (method == "initialized")
-    {
-        onInitialized(JSON_REQUIRED_PARAMS(params, "initialized"));
-    }
-    else if (method == "$/setTrace")
-    {
-        client->setTrace(JSON_REQUIRED_PARAMS(params, "$/setTrace"));
-    }
-    else if (method == "$/cancelRequest")
-    {
-        // NO-OP
-        // TODO: support cancellation
-    }
-    else if (method == "$/flushTimeTrace")
-    {
-#if defined(LUAU_ENABLE_TIME_TRACE)
-        Luau::TimeTrace::getThreadContext().flushEvents();
-#endif
-    }
-    else if (method == "textDocument/didOpen")
-    {
-        onDidOpenTextDocument(JSON_REQUIRED_PARAMS(params, "textDocument/didOpen"));
-    }
-    else if (method == "textDocument/didChange")
-    {
-        onDidChangeTextDocument(JSON_REQUIRED_PARAMS(params, "textDocument/didChange"));
-    }
-    else if (method == "textDocument/didSave")
-    {
-        // NO-OP
-    }
-    else if (method == "textDocument/didClose")
-    {
-        onDidCloseTextDocument(JSON_REQUIRED_PARAMS(params, "textDocument/didClose"));
-    }
-    else if (method == "workspace/didChangeConfiguration")
-    {
-        onDidChangeConfiguration(JSON_REQUIRED_PARAMS(params, "workspace/didChangeConfiguration"));
-    }
-    else if (method == "workspace/didChangeWorkspaceFolders")
-    {
-        onDidChangeWorkspaceFolders(JSON_REQUIRED_PARAMS(params, "workspace/didChangeWorkspaceFolders"));
+        MethodCountersScope countersScope(it->second.counters, contentLength);
+        it->second.handler(std::move(params));
+        return;
     }
-    else if (method == "workspace/didChangeWatchedFiles")
+
+    for (auto& workspace : workspaceFolders)
     {
-        onDidChangeWatchedFiles(JSON_REQUIRED_PARAMS(params, "workspace/didChangeWatchedFiles"));
+        if (workspace->platform && workspace->platform->handleNotification(method, params))
+            return;
     }
-    else
-    {
-        for (auto& workspace : workspaceFolders)
-        {
-            if (workspace->platform && workspace->platform->handleNotification(method, params))
-                return;
-        }
 
-        client->sendLogMessage(lsp::MessageType::Warning, "unknown notification method: " + method);
-    }
+    client->sendLogMessage(lsp::MessageType::Warning, "unknown notification method: " + method);
+}
+
+lsp::StatsResult LanguageServer::stats() const
+{
+    lsp::StatsResult result;
+    for (const auto& [method, registered] : requestHandlers)
+        if (registered.counters->count.load(std::memory_order_relaxed) > 0)
+            result.methods.emplace(method, registered.counters->snapshot());
+    for (const auto& [method, registered] : notificationHandlers)
+        if (registered.counters->count.load(std::memory_order_relaxed) > 0)
+            result.methods.emplace(method, registered.counters->snapshot());
+    return result;
 }
 
 bool LanguageServer::allWorkspacesConfigured() const
@@ -360,8 +497,27 @@ bool LanguageServer::allWorkspacesConfigured() const
     return true;
 }
 
-void LanguageServer::handleMessage(const json_rpc::JsonRpcMessage& msg)
+void LanguageServer::respondSuperseded(const json_rpc::JsonRpcMessage& msg)
+{
+    client->sendTrace("request superseded by a later message, skipping: " + msg.method.value());
+
+    // Pull diagnostics are retriggered by the client on ServerCancelled, so they are never left stale
+    if (msg.method == "textDocument/diagnostic")
+    {
+        lsp::DiagnosticServerCancellationData cancellationData{/*retriggerRequest: */ true};
+        client->sendError(msg.id, JsonRpcException(lsp::ErrorCode::ServerCancelled, "document changed", cancellationData));
+    }
+    else
+    {
+        client->sendError(msg.id, JsonRpcException(lsp::ErrorCode::ContentModified, "document changed"));
+    }
+}
+
+void LanguageServer::handleMessage(const QueuedMessage& queuedMessage)
 {
+    const auto& msg = queuedMessage.message;
+    const auto& cancellationToken = queuedMessage.cancellationToken;
+
     try
     {
         if (msg.is_request())
@@ -369,11 +525,21 @@ void LanguageServer::handleMessage(const json_rpc::JsonRpcMessage& msg)
             if (isInitialized && !allWorkspacesConfigured())
             {
                 client->sendTrace("workspaces not configured, postponing message: " + msg.method.value());
-                configPostponedMessages.emplace_back(msg);
+                configPostponedMessages.emplace_back(queuedMessage);
                 return;
             }
 
-            onRequest(msg.id.value(), msg.method.value(), msg.params);
+            // The document may have been changed, or the same request made again, whilst the request was queued
+            if (messageQueue.isSuperseded(queuedMessage))
+            {
+                respondSuperseded(msg);
+                return;
+            }
+
+            // The request may have been cancelled whilst it was still queued
+            throwIfCancelled(cancellationToken);
+
+            onRequest(msg.id.value(), msg.method.value(), msg.parseParams(), cancellationToken, msg.contentLength);
         }
         else if (msg.is_response())
         {
@@ -381,7 +547,7 @@ void LanguageServer::handleMessage(const json_rpc::JsonRpcMessage& msg)
         }
         else if (msg.is_notification())
         {
-            onNotification(msg.method.value(), msg.params);
+            onNotification(msg.method.value(), msg.parseParams(), msg.contentLength);
         }
         else
         {
@@ -392,38 +558,48 @@ void LanguageServer::handleMessage(const json_rpc::JsonRpcMessage& msg)
     {
         client->sendError(msg.id, e);
     }
+    catch (const json::parse_error& e)
+    {
+        // Params are only parsed once the message is handled
+        client->sendError(msg.id, JsonRpcException(lsp::ErrorCode::ParseError, e.what()));
+    }
     catch (const std::exception& e)
     {
         client->sendError(msg.id, JsonRpcException(lsp::ErrorCode::InternalError, e.what()));
     }
 }
 
-void LanguageServer::processInputLoop()
+void LanguageServer::readInputLoop()
 {
-    std::string jsonString;
     while (std::cin)
     {
-        if (configPostponedMessages.size() > 0 && allWorkspacesConfigured())
+        // The body is owned by the message, as its params are only parsed once it is handled
+        auto jsonString = std::make_shared<std::string>();
+        if (client->readRawMessage(*jsonString))
         {
-            client->sendTrace("workspaces configured, handling postponed messages");
-            for (const auto& msg : configPostponedMessages)
-                handleMessage(msg);
-
-            configPostponedMessages.clear();
-            client->sendTrace("workspaces configured, handling postponed COMPLETED");
-        }
+            if (recorder)
+                recorder->record(*jsonString);
 
-        if (client->readRawMessage(jsonString))
-        {
-            // sendTrace(jsonString, std::nullopt);
             std::optional<id_type> id = std::nullopt;
             try
             {
                 // Parse the input
-                auto msg = json_rpc::parse(jsonString);
+                auto msg = json_rpc::parse(std::move(jsonString));
                 id = msg.id;
 
-                handleMessage(msg);
+                // Handle cancellation immediately, so that it can reach requests which are queued or already in-flight
+                if (msg.is_notification() && msg.method == "$/cancelRequest")
+                {
+                    if (auto params = msg.parseParams())
+                        messageQueue.cancel(params->get<lsp::CancelParams>().id);
+                    continue;
+                }
+
+                messageQueue.push(std::move(msg));
+            }
+            catch (const JsonRpcException& e)
+            {
+                client->sendError(id, e);
             }
             catch (const json::exception& e)
             {
@@ -431,6 +607,92 @@ void LanguageServer::processInputLoop()
             }
         }
     }
+
+    messageQueue.close();
+}
+
+void LanguageServer::processInputLoop()
+{
+    // Reading happens on a separate thread so that cancellation requests are seen whilst a request is being handled.
+    // The thread is detached as it may be blocked reading stdin when the server exits
+    std::thread(&LanguageServer::readInputLoop, this).detach();
+
+    while (true)
+    {
+        // Interactive messages always take priority. Background work is only stepped whilst there are no messages waiting,
+        // one module at a time, so a newly arrived request is held up by at most a single step
+        auto queuedMessage = backgroundScheduler.empty() ? messageQueue.pop() : messageQueue.tryPop();
+        if (!queuedMessage)
+        {
+            if (backgroundScheduler.empty())
+                break;
+
+            runBackgroundStep();
+            continue;
+        }
+
+        handleMessage(*queuedMessage);
+        handlePostponedMessages();
+    }
+}
+
+void LanguageServer::handlePostponedMessages()
+{
+    if (configPostponedMessages.size() > 0 && allWorkspacesConfigured())
+    {
+        client->sendTrace("workspaces configured, handling postponed messages");
+        for (const auto& postponed : configPostponedMessages)
+            handleMessage(postponed);
+
+        configPostponedMessages.clear();
+        client->sendTrace("workspaces configured, handling postponed COMPLETED");
+    }
+}
+
+void LanguageServer::setRecorder(std::unique_ptr<SessionRecorder> sessionRecorder)
+{
+    recorder = std::move(sessionRecorder);
+}
+
+void LanguageServer::replayMessage(json_rpc::JsonRpcMessage message)
+{
+    // Messages are handled one at a time as if the server keeps up with the client, so a replay is not affected by timing.
+    // Requests therefore can only be cancelled (or superseded) before they are handled, never whilst in-flight
+    if (message.is_notification() && message.method == "$/cancelRequest")
+    {
+        if (auto params = message.parseParams())
+            messageQueue.cancel(params->get<lsp::CancelParams>().id);
+        return;
+    }
+
+    messageQueue.push(std::move(message));
+    while (auto queuedMessage = messageQueue.tryPop())
+    {
+        handleMessage(*queuedMessage);
+        handlePostponedMessages();
+    }
+
+    while (!backgroundScheduler.empty())
+        runBackgroundStep();
+}
+
+void LanguageServer::runBackgroundStep()
+{
+    try
+    {
+        backgroundScheduler.runStep();
+    }
+    catch (const std::exception& e)
+    {
+        client->sendLogMessage(lsp::MessageType::Error, std::string("background task failed: ") + e.what());
+    }
+}
+
+WorkspaceFolderPtr LanguageServer::createWorkspace(const std::string& name, const lsp::DocumentUri& uri)
+{
+    auto workspace = std::make_shared<WorkspaceFolder>(client, name, uri, defaultConfig);
+    workspace->scheduler = &backgroundScheduler;
+    return workspace;
 }
 
 bool LanguageServer::requestedShutdown()
@@ -479,12 +741,12 @@ lsp::InitializeResult LanguageServer::onInitialize(const lsp::InitializeParams&
     {
         for (auto& folder : params.workspaceFolders.value())
         {
-            workspaceFolders.push_back(std::make_shared<WorkspaceFolder>(client, folder.name, folder.uri, defaultConfig));
+            workspaceFolders.push_back(createWorkspace(folder.name, folder.uri));
         }
     }
     else if (params.rootUri.has_value())
     {
-        workspaceFolders.push_back(std::make_shared<WorkspaceFolder>(client, "$ROOT", params.rootUri.value(), defaultConfig));
+        workspaceFolders.push_back(createWorkspace("$ROOT", params.rootUri.value()));
     }
 
     isInitialized = true;
@@ -562,6 +824,7 @@ void LanguageServer::onInitialized([[maybe_unused]] const lsp::InitializedParams
         std::vector<lsp::FileSystemWatcher> watchers{};
         watchers.push_back(lsp::FileSystemWatcher{"**/.luaurc"});
         watchers.push_back(lsp::FileSystemWatcher{"**/*.{lua,luau}"});
+        watchers.push_back(lsp::FileSystemWatcher{"**/.gitignore"});
         client->registerCapability(
             "didChangedWatchedFilesCapability", "workspace/didChangeWatchedFiles", lsp::DidChangeWatchedFilesRegistrationOptions{watchers});
     }
@@ -622,13 +885,26 @@ void LanguageServer::onDidChangeTextDocument(const lsp::DidChangeTextDocumentPar
         auto diagnostics = workspace->documentDiagnostics(lsp::DocumentDiagnosticParams{{params.textDocument.uri}});
         client->publishDiagnostics(lsp::PublishDiagnosticsParams{params.textDocument.uri, params.textDocument.version, diagnostics.items});
 
+        if (!diagnostics.relatedDocuments.empty())
+        {
+            for (const auto& [uri, relatedDiagnostics] : diagnostics.relatedDocuments)
+            {
+                if (relatedDiagnostics.kind == lsp::DocumentDiagnosticReportKind::Full)
+                {
+                    client->publishDiagnostics(lsp::PublishDiagnosticsParams{Uri::parse(uri), std::nullopt, relatedDiagnostics.items});
+                }
+            }
+        }
+
         // Compute diagnostics for reverse dependencies
+        // These are re-checked in the background one module at a time, so that interactive requests made whilst typing
+        // are not held up behind a potentially large number of dependents. A later change to the same document replaces the task
         // TODO: should we put this inside documentDiagnostics so it works in the pull based model as well? (its a reverse BFS which is expensive)
         // TODO: maybe this should only be done onSave
         auto config = client->getConfiguration(workspace->rootUri);
         if (config.diagnostics.includeDependents || config.diagnostics.workspace)
         {
-            std::unordered_map<std::string, lsp::SingleDocumentDiagnosticReport> reverseDependencyDiagnostics{};
+            auto dependents = std::make_shared<std::vector<Uri>>();
             for (auto& module : markedDirty)
             {
                 auto filePath = workspace->platform->resolveToRealPath(module);
@@ -636,26 +912,43 @@ void LanguageServer::onDidChangeTextDocument(const lsp::DidChangeTextDocumentPar
                 {
                     auto uri = Uri::file(*filePath);
                     if (uri != params.textDocument.uri && !contains(diagnostics.relatedDocuments, uri.toString()) &&
-                        !workspace->isIgnoredFile(*filePath, config))
-                    {
-                        auto dependencyDiags = workspace->documentDiagnostics(lsp::DocumentDiagnosticParams{{uri}});
-                        diagnostics.relatedDocuments.emplace(uri.toString(),
-                            lsp::SingleDocumentDiagnosticReport{dependencyDiags.kind, dependencyDiags.resultId, dependencyDiags.items});
-                        diagnostics.relatedDocuments.merge(dependencyDiags.relatedDocuments);
-                    }
+                        !workspace->isIgnoredFile(*filePath))
+                        dependents->emplace_back(std::move(uri));
                 }
             }
-        }
 
-        if (!diagnostics.relatedDocuments.empty())
-        {
-            for (const auto& [uri, relatedDiagnostics] : diagnostics.relatedDocuments)
-            {
-                if (relatedDiagnostics.kind == lsp::DocumentDiagnosticReportKind::Full)
+            if (dependents->empty())
+                return;
+
+            // Documents which have already been published, either directly or as a related document
+            auto published = std::make_shared<std::unordered_set<std::string>>();
+            published->insert(params.textDocument.uri.toString());
+            for (const auto& [uri, _] : diagnostics.relatedDocuments)
+                published->insert(uri);
+
+            workspace->runInBackground("dependents:" + params.textDocument.uri.toString(),
+                [this, workspace, dependents, published, index = size_t(0)]() mutable
                 {
-                    client->publishDiagnostics(lsp::PublishDiagnosticsParams{Uri::parse(uri), std::nullopt, relatedDiagnostics.items});
-                }
-            }
+                    while (index < dependents->size() && published->count(dependents->at(index).toString()) > 0)
+                        index++;
+                    if (index >= dependents->size())
+                        return false;
+
+                    const auto& uri = dependents->at(index++);
+                    published->insert(uri.toString());
+
+                    auto dependencyDiags = workspace->documentDiagnostics(lsp::DocumentDiagnosticParams{{uri}});
+                    if (dependencyDiags.kind == lsp::DocumentDiagnosticReportKind::Full)
+                        client->publishDiagnostics(lsp::PublishDiagnosticsParams{uri, std::nullopt, dependencyDiags.items});
+
+                    for (const auto& [relatedUri, relatedDiagnostics] : dependencyDiags.relatedDocuments)
+                    {
+                        if (relatedDiagnostics.kind == lsp::DocumentDiagnosticReportKind::Full && published->insert(relatedUri).second)
+                            client->publishDiagnostics(lsp::PublishDiagnosticsParams{Uri::parse(relatedUri), std::nullopt, relatedDiagnostics.items});
+                    }
+
+                    return index < dependents->size();
+                });
         }
     }
 }
@@ -693,6 +986,10 @@ void LanguageServer::onDidChangeConfiguration(const lsp::DidChangeConfigurationP
         {
             client->sendLogMessage(lsp::MessageType::Error, std::string("failed to refresh global configuration: ") + e.what());
         }
+
+        nullWorkspace->applyIgnoreGlobs(client->getConfiguration(nullWorkspace->rootUri));
+        for (auto& workspace : workspaceFolders)
+            workspace->applyIgnoreGlobs(client->getConfiguration(workspace->rootUri));
     }
 }
 
@@ -708,10 +1005,11 @@ void LanguageServer::onDidChangeWorkspaceFolders(const lsp::DidChangeWorkspaceFo
                     return w.name == name;
                 }) != std::end(params.event.removed))
         {
-            it = workspaceFolders.erase(it);
-
-            // Remove the configuration information for this folder
+            // Remove the configuration information and any pending background work for this folder
             client->removeConfiguration((*it)->rootUri);
+            backgroundScheduler.cancel((*it)->backgroundTaskPrefix());
+
+            it = workspaceFolders.erase(it);
         }
         else
         {
@@ -723,7 +1021,7 @@ void LanguageServer::onDidChangeWorkspaceFolders(const lsp::DidChangeWorkspaceFo
     std::vector<lsp::DocumentUri> configItems{};
     for (auto& folder : params.event.added)
     {
-        workspaceFolders.emplace_back(std::make_shared<WorkspaceFolder>(client, folder.name, folder.uri, defaultConfig));
+        workspaceFolders.emplace_back(createWorkspace(folder.name, folder.uri));
         configItems.emplace_back(folder.uri);
     }
     client->requestConfiguration(configItems);
@@ -0,0 +1,223 @@
+#include "LSP/MessageQueue.hpp"
+
+void throwIfCancelled(const LSPCancellationToken& cancellationToken)
+{
+    if (cancellationToken && cancellationToken->requested())
+        throw json_rpc::JsonRpcException(lsp::ErrorCode::RequestCancelled, "request cancelled");
+}
+
+bool isCoalescableRequest(const std::string& method)
+{
+    return method == "textDocument/semanticTokens/full" || method == "textDocument/inlayHint" || method == "textDocument/diagnostic" ||
+           method == "textDocument/documentColor" || method == "textDocument/documentLink" || method == "textDocument/documentSymbol" ||
+           method == "textDocument/foldingRange";
+}
+
+/// Parses a single nested member of the params, without parsing the rest of the (possibly very large) params
+static std::optional<json> findParam(const json_rpc::JsonRpcMessage& message, std::initializer_list<std::string_view> path)
+{
+    if (message.params)
+    {
+        const json* value = &*message.params;
+        for (auto key : path)
+        {
+            if (!value->is_object())
+                return std::nullopt;
+            auto it = value->find(std::string(key));
+            if (it == value->end())
+                return std::nullopt;
+            value = &*it;
+        }
+        return std::optional<json>(std::in_place, *value);
+    }
+    else if (message.rawParams)
+    {
+        std::optional<json_rpc::RawJson> value = message.rawParams;
+        for (auto key : path)
+        {
+            value = value->find(key);
+            if (!value)
+                return std::nullopt;
+        }
+        return value->parse();
+    }
+
+    return std::nullopt;
+}
+
+static std::optional<std::string> getTextDocumentUri(const json_rpc::JsonRpcMessage& message)
+{
+    auto uri = findParam(message, {"textDocument", "uri"});
+    if (!uri || !uri->is_string())
+        return std::nullopt;
+    return uri->get<std::string>();
+}
+
+// NOTE: must be called with the lock held
+std::optional<DocumentRequestStamp> MessageQueue::stampDocumentRequest(const json_rpc::JsonRpcMessage& message)
+{
+    if (!message.method)
+        return std::nullopt;
+
+    // Track document versions as soon as they are read, before they are applied by the main loop
+    if (message.is_notification() && (message.method == "textDocument/didOpen" || message.method == "textDocument/didChange"))
+    {
+        if (auto uri = getTextDocumentUri(message))
+        {
+            if (auto version = findParam(message, {"textDocument", "version"}); version && version->is_number_unsigned())
+                documentVersions.insert_or_assign(*uri, version->get<size_t>());
+        }
+        return std::nullopt;
+    }
+
+    // Requests still queued for a closed document are not superseded by anything any more, so its state can be dropped
+    if (message.is_notification() && message.method == "textDocument/didClose")
+    {
+        if (auto uri = getTextDocumentUri(message))
+        {
+            documentVersions.erase(*uri);
+            requestGenerations.erase(*uri);
+        }
+        return std::nullopt;
+    }
+
+    if (!message.is_request() || !isCoalescableRequest(*message.method))
+        return std::nullopt;
+
+    auto uri = getTextDocumentUri(message);
+    if (!uri)
+        return std::nullopt;
+
+    // Requests over a range (e.g. inlay hints for the visible region) only supersede requests over the same range
+    std::string key = *message.method + "|" + *uri;
+    if (auto range = findParam(message, {"range"}))
+        key += "|" + range->dump();
+
+    size_t generation = ++nextGeneration;
+    requestGenerations[*uri].insert_or_assign(key, generation);
+
+    auto versionIt = documentVersions.find(*uri);
+    return DocumentRequestStamp{key, *uri, versionIt != documentVersions.end() ? versionIt->second : 0, generation};
+}
+
+void MessageQueue::push(json_rpc::JsonRpcMessage message)
+{
+    {
+        std::unique_lock lock(mutex);
+
+        auto documentStamp = stampDocumentRequest(message);
+
+        LSPCancellationToken cancellationToken = nullptr;
+        if (message.is_request())
+        {
+            // Sweep requests which have already been handled
+            for (auto it = pendingRequests.begin(); it != pendingRequests.end();)
+            {
+                if (it->second.expired())
+                    it = pendingRequests.erase(it);
+                else
+                    ++it;
+            }
+
+            cancellationToken = std::make_shared<Luau::FrontendCancellationToken>();
+            pendingRequests.insert_or_assign(*message.id, cancellationToken);
+        }
+
+        messages.push_back(QueuedMessage{std::move(message), std::move(cancellationToken), std::move(documentStamp)});
+    }
+    condition.notify_one();
+}
+
+std::optional<QueuedMessage> MessageQueue::pop()
+{
+    std::unique_lock lock(mutex);
+    condition.wait(lock,
+        [this]
+        {
+            return closed || !messages.empty();
+        });
+
+    if (messages.empty())
+        return std::nullopt;
+
+    auto message = std::move(messages.front());
+    messages.pop_front();
+    return message;
+}
+
+std::optional<QueuedMessage> MessageQueue::tryPop()
+{
+    std::unique_lock lock(mutex);
+    if (messages.empty())
+        return std::nullopt;
+
+    auto message = std::move(messages.front());
+    messages.pop_front();
+    return message;
+}
+
+void MessageQueue::close()
+{
+    {
+        std::unique_lock lock(mutex);
+        closed = true;
+    }
+    condition.notify_all();
+}
+
+bool MessageQueue::cancel(const json_rpc::id_type& id)
+{
+    std::unique_lock lock(mutex);
+    auto it = pendingRequests.find(id);
+    if (it == pendingRequests.end())
+        return false;
+
+    auto cancellationToken = it->second.lock();
+    pendingRequests.erase(it);
+    if (!cancellationToken)
+        return false;
+
+    cancellationToken->cancel();
+    return true;
+}
+
+bool MessageQueue::isSuperseded(const QueuedMessage& message)
+{
+    if (!message.documentStamp)
+        return false;
+
+    std::unique_lock lock(mutex);
+    const auto& stamp = *message.documentStamp;
+
+    bool superseded = false;
+    if (auto it = documentVersions.find(stamp.uri); it != documentVersions.end() && it->second != stamp.documentVersion)
+        superseded = true;
+
+    if (auto documentIt = requestGenerations.find(stamp.uri); documentIt != requestGenerations.end())
+    {
+        auto& generations = documentIt->second;
+        if (auto it = generations.find(stamp.key); it != generations.end())
+        {
+            // This is the latest request with the key, so nothing queued needs the entry any more
+            if (it->second == stamp.generation)
+                generations.erase(it);
+            else
+                superseded = true;
+        }
+
+        if (generations.empty())
+            requestGenerations.erase(documentIt);
+    }
+
+    return superseded;
+}
+
+size_t MessageQueue::trackedDocumentCount()
+{
+    std::unique_lock lock(mutex);
+    size_t count = documentVersions.size();
+    for (const auto& [uri, _] : requestGenerations)
+        if (!documentVersions.count(uri))
+            count++;
+    return count;
+}
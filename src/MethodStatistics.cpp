@@ -0,0 +1,90 @@
+#include "LSP/MethodStatistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+size_t LatencyHistogram::bucketFor(uint64_t microseconds)
+{
+    constexpr uint64_t subBuckets = 1 << SubBucketBits;
+    if (microseconds < subBuckets)
+        return size_t(microseconds);
+
+    // Values in [2^e, 2^(e+1)) are split into sub-buckets by the bits following the most significant bit
+    size_t exponent = 63;
+    while (!(microseconds & (uint64_t(1) << exponent)))
+        exponent--;
+    size_t subBucket = size_t((microseconds >> (exponent - SubBucketBits)) & (subBuckets - 1));
+    size_t bucket = (exponent - SubBucketBits + 1) * subBuckets + subBucket;
+    return std::min(bucket, BucketCount - 1);
+}
+
+uint64_t LatencyHistogram::valueFor(size_t bucket)
+{
+    constexpr uint64_t subBuckets = 1 << SubBucketBits;
+    if (bucket < subBuckets)
+        return bucket;
+
+    size_t exponent = bucket / subBuckets + SubBucketBits - 1;
+    uint64_t subBucket = bucket % subBuckets;
+    uint64_t width = uint64_t(1) << (exponent - SubBucketBits);
+    uint64_t lower = (uint64_t(1) << exponent) + subBucket * width;
+    return lower + width / 2;
+}
+
+void LatencyHistogram::record(std::chrono::nanoseconds duration)
+{
+    auto microseconds = uint64_t(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+    buckets[bucketFor(microseconds)].fetch_add(1, std::memory_order_relaxed);
+
+    auto currentMax = maxMicroseconds.load(std::memory_order_relaxed);
+    while (microseconds > currentMax && !maxMicroseconds.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+uint64_t LatencyHistogram::count() const
+{
+    uint64_t total = 0;
+    for (const auto& bucket : buckets)
+        total += bucket.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t LatencyHistogram::percentile(double percentile) const
+{
+    auto total = count();
+    if (total == 0)
+        return 0;
+
+    auto rank = uint64_t(std::ceil(percentile / 100.0 * double(total)));
+    rank = std::clamp<uint64_t>(rank, 1, total);
+    if (rank == total)
+        return max();
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BucketCount; i++)
+    {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return std::min(valueFor(i), max());
+    }
+    return max();
+}
+
+lsp::MethodStatistics MethodCounters::snapshot() const
+{
+    auto toMilliseconds = [](uint64_t microseconds)
+    {
+        return double(microseconds) / 1000.0;
+    };
+
+    lsp::MethodStatistics statistics;
+    statistics.count = count.load(std::memory_order_relaxed);
+    statistics.bytesIn = bytesIn.load(std::memory_order_relaxed);
+    statistics.bytesOut = bytesOut.load(std::memory_order_relaxed);
+    statistics.latency.p50 = toMilliseconds(latency.percentile(50));
+    statistics.latency.p95 = toMilliseconds(latency.percentile(95));
+    statistics.latency.p99 = toMilliseconds(latency.percentile(99));
+    statistics.latency.max = toMilliseconds(latency.max());
+    return statistics;
+}
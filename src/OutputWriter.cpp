@@ -0,0 +1,110 @@
+#include "LSP/OutputWriter.hpp"
+#include "LSP/JsonRpc.hpp"
+
+OutputWriter::OutputWriter(std::ostream& output, size_t capacity)
+    : output(output)
+    , capacity(capacity)
+    , thread(&OutputWriter::writeLoop, this)
+{
+}
+
+OutputWriter::~OutputWriter()
+{
+    {
+        std::unique_lock lock(mutex);
+        stopped = true;
+    }
+    pendingAvailable.notify_all();
+    thread.join();
+}
+
+void OutputWriter::push(json message, ByteCounter bytesWritten)
+{
+    enqueue(PendingMessage{std::variant<json, Serializer>(std::in_place_type<json>, std::move(message)), std::move(bytesWritten)});
+}
+
+void OutputWriter::push(Serializer serializer, ByteCounter bytesWritten)
+{
+    enqueue(PendingMessage{std::variant<json, Serializer>(std::in_place_type<Serializer>, std::move(serializer)), std::move(bytesWritten)});
+}
+
+void OutputWriter::enqueue(PendingMessage message)
+{
+    {
+        std::unique_lock lock(mutex);
+        pendingConsumed.wait(lock,
+            [this]
+            {
+                return pending.size() < capacity;
+            });
+        pending.push_back(std::move(message));
+    }
+    pendingAvailable.notify_one();
+}
+
+void OutputWriter::flush()
+{
+    std::unique_lock lock(mutex);
+    pendingConsumed.wait(lock,
+        [this]
+        {
+            return pending.empty() && !writing;
+        });
+}
+
+void OutputWriter::writeLoop()
+{
+    std::deque<PendingMessage> batch;
+    // Reused between batches to avoid reallocating
+    std::string buffer;
+    std::string body;
+
+    while (true)
+    {
+        {
+            std::unique_lock lock(mutex);
+            pendingAvailable.wait(lock,
+                [this]
+                {
+                    return stopped || !pending.empty();
+                });
+
+            // Drain any remaining messages before stopping
+            if (pending.empty())
+                return;
+
+            std::swap(batch, pending);
+            writing = true;
+        }
+        pendingConsumed.notify_all();
+
+        buffer.clear();
+        for (const auto& [message, bytesWritten] : batch)
+        {
+            size_t start = buffer.size();
+            if (auto j = std::get_if<json>(&message))
+            {
+                json_rpc::writeRawMessage(buffer, *j);
+            }
+            else
+            {
+                body.clear();
+                std::get<Serializer>(message)(body);
+                json_rpc::writeFramedBody(buffer, body);
+            }
+
+            if (bytesWritten)
+                bytesWritten->fetch_add(buffer.size() - start, std::memory_order_relaxed);
+        }
+        batch.clear();
+
+        output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        output.flush();
+
+        {
+            std::unique_lock lock(mutex);
+            writing = false;
+        }
+        pendingConsumed.notify_all();
+    }
+}
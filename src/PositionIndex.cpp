@@ -0,0 +1,210 @@
+#include "LSP/PositionIndex.hpp"
+#include "LSP/TextScan.hpp"
+
+#include <algorithm>
+
+static size_t utf8SequenceLength(unsigned char lead)
+{
+    if ((lead & 0xE0) == 0xC0)
+        return 2;
+    if ((lead & 0xF0) == 0xE0)
+        return 3;
+    if ((lead & 0xF8) == 0xF0)
+        return 4;
+    return 1; // Continuation bytes and invalid lead bytes are treated as a single unit
+}
+
+static size_t utf16Length(const PositionIndex::Codepoint& codepoint)
+{
+    return codepoint.byteLength == 4 ? 2 : 1;
+}
+
+PositionIndex::PositionIndex(const Rope& text)
+    : textSize(text.size())
+{
+    lineStarts.reserve(text.lineCount());
+    codepointStarts.reserve(text.lineCount() + 1);
+    lineStarts.push_back(0);
+    codepointStarts.push_back(0);
+
+    size_t offset = 0;
+    bool previousWasCarriageReturn = false;
+    // Bytes still to be swallowed by a multi-byte sequence started in a previous chunk
+    size_t pendingSequenceBytes = 0;
+    Codepoint current;
+
+    text.forEachChunk(0, text.size(),
+        [&](std::string_view chunk)
+        {
+            for (size_t i = 0; i < chunk.size(); i++)
+            {
+                // Skip straight past runs of ASCII which are not line breaks, as they need no bookkeeping
+                if (pendingSequenceBytes == 0)
+                {
+                    size_t run = text_scan::findLineBreakOrNonAscii(chunk.substr(i));
+                    if (run > 0)
+                    {
+                        previousWasCarriageReturn = false;
+                        i += run;
+                        if (i == chunk.size())
+                            break;
+                    }
+                }
+
+                auto c = static_cast<unsigned char>(chunk[i]);
+                if (c == '\r' || c == '\n')
+                {
+                    pendingSequenceBytes = 0;
+                    if (c == '\n' && previousWasCarriageReturn)
+                    {
+                        // Extend the line started after the `\r`, which must be empty
+                        lineStarts.back() = offset + i + 1;
+                    }
+                    else
+                    {
+                        lineStarts.push_back(offset + i + 1);
+                        codepointStarts.push_back(static_cast<uint32_t>(codepoints.size()));
+                    }
+                    previousWasCarriageReturn = c == '\r';
+                    continue;
+                }
+                previousWasCarriageReturn = false;
+
+                if (pendingSequenceBytes > 0)
+                {
+                    pendingSequenceBytes--;
+                    codepoints.back().byteLength++;
+                    continue;
+                }
+
+                if (c < 0x80)
+                    continue;
+
+                size_t sequenceLength = utf8SequenceLength(c);
+                if (sequenceLength == 1)
+                    continue;
+
+                size_t columnInLine = offset + i - lineStarts.back();
+                current.byteColumn = static_cast<uint32_t>(columnInLine);
+                if (codepointStarts.back() == codepoints.size())
+                {
+                    current.utf16Column = current.byteColumn;
+                    current.utf32Column = current.byteColumn;
+                }
+                else
+                {
+                    // Every byte between the previous codepoint and this one is a single unit
+                    const auto& previous = codepoints.back();
+                    size_t gap = current.byteColumn - previous.byteColumn - previous.byteLength;
+                    current.utf16Column = static_cast<uint32_t>(previous.utf16Column + utf16Length(previous) + gap);
+                    current.utf32Column = static_cast<uint32_t>(previous.utf32Column + 1 + gap);
+                }
+                current.byteLength = 1;
+                codepoints.push_back(current);
+                pendingSequenceBytes = sequenceLength - 1;
+            }
+
+            offset += chunk.size();
+            return false;
+        });
+
+    codepointStarts.push_back(static_cast<uint32_t>(codepoints.size()));
+}
+
+size_t PositionIndex::lineOf(size_t offset) const
+{
+    auto it = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    return static_cast<size_t>(it - lineStarts.begin()) - 1;
+}
+
+size_t PositionIndex::unitsUpTo(std::vector<Codepoint>::const_iterator begin, std::vector<Codepoint>::const_iterator it, size_t byteColumn,
+    lsp::PositionEncodingKind encoding)
+{
+    if (it == begin)
+        return byteColumn;
+
+    const auto& codepoint = *(it - 1);
+    size_t codepointEnd = codepoint.byteColumn + codepoint.byteLength;
+    size_t after = byteColumn > codepointEnd ? byteColumn - codepointEnd : 0;
+    if (encoding == lsp::PositionEncodingKind::UTF16)
+        return codepoint.utf16Column + utf16Length(codepoint) + after;
+    else
+        return codepoint.utf32Column + 1 + after;
+}
+
+size_t PositionIndex::toUnits(size_t line, size_t byteColumn, lsp::PositionEncodingKind encoding) const
+{
+    if (encoding == lsp::PositionEncodingKind::UTF8 || isAscii(line))
+        return byteColumn;
+
+    auto begin = codepoints.begin() + codepointStarts[line];
+    auto end = codepoints.begin() + codepointStarts[line + 1];
+
+    // Find the first codepoint starting at or after the column
+    auto it = std::lower_bound(begin, end, byteColumn,
+        [](const Codepoint& codepoint, size_t column)
+        {
+            return codepoint.byteColumn < column;
+        });
+    return unitsUpTo(begin, it, byteColumn, encoding);
+}
+
+size_t PositionIndex::toUnits(size_t line, size_t byteColumn, lsp::PositionEncodingKind encoding, size_t& cursor) const
+{
+    if (encoding == lsp::PositionEncodingKind::UTF8 || isAscii(line))
+        return byteColumn;
+
+    auto begin = codepoints.begin() + codepointStarts[line];
+    auto end = codepoints.begin() + codepointStarts[line + 1];
+
+    // Walk forwards from the cursor if it is on this line and not past the column, otherwise restart from the start of the line
+    auto it = codepoints.begin() + cursor;
+    if (it < begin || it > end || (it > begin && (it - 1)->byteColumn >= byteColumn))
+        it = begin;
+    while (it != end && it->byteColumn < byteColumn)
+        ++it;
+
+    cursor = it - codepoints.begin();
+    return unitsUpTo(begin, it, byteColumn, encoding);
+}
+
+size_t PositionIndex::toBytes(size_t line, size_t units, lsp::PositionEncodingKind encoding, bool& valid) const
+{
+    valid = true;
+    size_t length = lineLength(line);
+    size_t result = units;
+
+    if (encoding != lsp::PositionEncodingKind::UTF8 && !isAscii(line))
+    {
+        bool utf16 = encoding == lsp::PositionEncodingKind::UTF16;
+        auto begin = codepoints.begin() + codepointStarts[line];
+        auto end = codepoints.begin() + codepointStarts[line + 1];
+
+        // Find the last codepoint starting before the column
+        auto it = std::lower_bound(begin, end, units,
+            [utf16](const Codepoint& codepoint, size_t column)
+            {
+                return (utf16 ? codepoint.utf16Column : codepoint.utf32Column) < column;
+            });
+        if (it != begin)
+        {
+            const auto& codepoint = *(it - 1);
+            size_t codepointUnits = utf16 ? utf16Length(codepoint) : 1;
+            size_t codepointEnd = (utf16 ? codepoint.utf16Column : codepoint.utf32Column) + codepointUnits;
+            if (units < codepointEnd)
+            {
+                // In the middle of a surrogate pair
+                valid = false;
+                return codepoint.byteColumn + codepoint.byteLength;
+            }
+            result = codepoint.byteColumn + codepoint.byteLength + (units - codepointEnd);
+        }
+    }
+
+    if (result > length)
+    {
+        valid = false;
+        return length;
+    }
+    return result;
+}
@@ -0,0 +1,177 @@
+#include "Replay/ReplayCli.hpp"
+#include "LSP/SessionRecorder.hpp"
+#include "LSP/Utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+struct ResourceUsage
+{
+    /// User and system CPU time of the whole process, including the output writer thread
+    double cpuSeconds = 0;
+    size_t peakRssBytes = 0;
+};
+
+static ResourceUsage getResourceUsage()
+{
+    ResourceUsage result;
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+    {
+        auto toSeconds = [](const FILETIME& time)
+        {
+            // FILETIME is measured in 100ns intervals
+            return double((uint64_t(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 1e7;
+        };
+        result.cpuSeconds = toSeconds(kernelTime) + toSeconds(userTime);
+    }
+
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        result.peakRssBytes = counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        result.cpuSeconds = double(usage.ru_utime.tv_sec) + double(usage.ru_utime.tv_usec) / 1e6 + double(usage.ru_stime.tv_sec) +
+                            double(usage.ru_stime.tv_usec) / 1e6;
+#ifdef __APPLE__
+        result.peakRssBytes = size_t(usage.ru_maxrss);
+#else
+        // Linux reports the maximum resident set size in kilobytes
+        result.peakRssBytes = size_t(usage.ru_maxrss) * 1024;
+#endif
+    }
+#endif
+    return result;
+}
+
+/// Finds the root of the recorded workspace from the initialize request.
+/// The uri is returned exactly as it was sent by the client, so that it can be found in other messages
+static std::optional<std::string> findRecordedWorkspaceRoot(const std::vector<RecordedMessage>& messages)
+{
+    for (const auto& message : messages)
+    {
+        auto body = json::parse(message.body, nullptr, /* allow_exceptions: */ false);
+        if (!body.is_object() || body.value("method", "") != "initialize" || !body.contains("params"))
+            continue;
+
+        const auto& params = body["params"];
+        if (auto folders = params.find("workspaceFolders"); folders != params.end() && folders->is_array() && !folders->empty())
+        {
+            if (folders->size() > 1)
+                std::cerr << "warning: the recorded session has multiple workspace folders, only the first will be remapped\n";
+            if (auto uri = folders->front().find("uri"); uri != folders->front().end() && uri->is_string())
+                return uri->get<std::string>();
+        }
+        if (auto rootUri = params.find("rootUri"); rootUri != params.end() && rootUri->is_string())
+            return rootUri->get<std::string>();
+
+        return std::nullopt;
+    }
+
+    return std::nullopt;
+}
+
+int replaySession(const argparse::ArgumentParser& program, LanguageServer& server)
+{
+    auto recordingPath = program.get<std::filesystem::path>("recording");
+    std::ifstream recording(recordingPath, std::ios::in | std::ios::binary);
+    if (!recording)
+    {
+        std::cerr << "Failed to open session recording at '" << recordingPath.generic_string() << "'\n";
+        return 1;
+    }
+
+    // The whole recording is read up front, so that reading it is not included in the measurements
+    std::vector<RecordedMessage> messages;
+    RecordedMessage message;
+    while (readRecordedMessage(recording, message))
+        messages.push_back(std::move(message));
+
+    if (auto workspacePath = program.present<std::filesystem::path>("--workspace"))
+    {
+        auto recordedRoot = findRecordedWorkspaceRoot(messages);
+        if (!recordedRoot)
+        {
+            std::cerr << "The recorded session does not specify a workspace folder to remap\n";
+            return 1;
+        }
+
+        auto localRoot = Uri::file(std::filesystem::absolute(*workspacePath)).toString();
+        for (auto& recordedMessage : messages)
+            replaceAll(recordedMessage.body, *recordedRoot, localRoot);
+    }
+
+    auto usageBefore = getResourceUsage();
+    auto start = std::chrono::steady_clock::now();
+
+    size_t replayed = 0;
+    for (auto& recordedMessage : messages)
+    {
+        try
+        {
+            auto parsed = json_rpc::parse(std::make_shared<const std::string>(std::move(recordedMessage.body)));
+
+            // The exit notification terminates the process, so the replay stops here instead
+            if (parsed.is_notification() && parsed.method == "exit")
+                break;
+
+            server.replayMessage(std::move(parsed));
+            replayed++;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "warning: failed to replay message at " << recordedMessage.timestamp.count() << "us: " << e.what() << '\n';
+        }
+    }
+
+    Client::flushOutput();
+
+    auto wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto usageAfter = getResourceUsage();
+    auto cpuSeconds = usageAfter.cpuSeconds - usageBefore.cpuSeconds;
+    auto stats = server.stats();
+
+    if (program.get<bool>("--json"))
+    {
+        json report{
+            {"messages", replayed},
+            {"wallTime", wallSeconds},
+            {"cpuTime", cpuSeconds},
+            {"peakRss", usageAfter.peakRssBytes},
+            {"methods", stats.methods},
+        };
+        std::cout << report.dump(4) << '\n';
+        return 0;
+    }
+
+    printf("Replayed %zu messages in %.3fs (CPU time %.3fs), peak RSS %.1f MiB\n\n", replayed, wallSeconds, cpuSeconds,
+        double(usageAfter.peakRssBytes) / (1024.0 * 1024.0));
+
+    std::vector<std::pair<std::string, lsp::MethodStatistics>> methods(stats.methods.begin(), stats.methods.end());
+    std::sort(methods.begin(), methods.end(),
+        [](const auto& a, const auto& b)
+        {
+            return a.first < b.first;
+        });
+
+    printf("%-45s %8s %10s %10s %10s %10s\n", "method", "count", "p50 (ms)", "p95 (ms)", "p99 (ms)", "max (ms)");
+    for (const auto& [method, statistics] : methods)
+        printf("%-45s %8zu %10.2f %10.2f %10.2f %10.2f\n", method.c_str(), statistics.count, statistics.latency.p50, statistics.latency.p95,
+            statistics.latency.p99, statistics.latency.max);
+
+    return 0;
+}
@@ -0,0 +1,288 @@
+#include "LSP/Rope.hpp"
+#include "LSP/TextScan.hpp"
+
+#include <tuple>
+
+using NodePtr = Rope::NodePtr;
+
+static uint32_t nextPriority()
+{
+    // Priorities only need to be well distributed, not unpredictable. A fixed sequence keeps tree shapes reproducible
+    static thread_local uint64_t state = 0x9E3779B97F4A7C15ull;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<uint32_t>(state >> 32);
+}
+
+static bool isContinuationByte(char c)
+{
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+/// Counts the line breaks which end at or before `length`. A `\r\n` pair counts once, as ending after the `\n`
+static size_t countLineBreaks(std::string_view chunk, size_t length)
+{
+    std::string_view prefix = chunk.substr(0, length);
+    size_t count = 0;
+    for (size_t i = text_scan::findLineBreak(prefix); i < prefix.size(); i += 1 + text_scan::findLineBreak(prefix.substr(i + 1)))
+    {
+        if (!(chunk[i] == '\r' && i + 1 < chunk.size() && chunk[i + 1] == '\n'))
+            count++;
+    }
+    return count;
+}
+
+/// The offset just after the `n`th (1-indexed) line break in the chunk
+static size_t lineBreakEnd(std::string_view chunk, size_t n)
+{
+    for (size_t i = text_scan::findLineBreak(chunk); i < chunk.size(); i += 1 + text_scan::findLineBreak(chunk.substr(i + 1)))
+    {
+        if (chunk[i] == '\r' && i + 1 < chunk.size() && chunk[i + 1] == '\n')
+            continue;
+        if (--n == 0)
+            return i + 1;
+    }
+    return chunk.size();
+}
+
+static size_t bytesOf(const NodePtr& node)
+{
+    return node ? node->bytes : 0;
+}
+
+static size_t lineBreaksOf(const NodePtr& node)
+{
+    return node ? node->lineBreaks : 0;
+}
+
+static NodePtr makeNode(std::shared_ptr<const std::string> chunk, size_t chunkLineBreaks, uint32_t priority, NodePtr left, NodePtr right)
+{
+    auto node = std::make_shared<Rope::Node>();
+    node->bytes = bytesOf(left) + chunk->size() + bytesOf(right);
+    node->lineBreaks = lineBreaksOf(left) + chunkLineBreaks + lineBreaksOf(right);
+    node->chunk = std::move(chunk);
+    node->chunkLineBreaks = chunkLineBreaks;
+    node->priority = priority;
+    node->left = std::move(left);
+    node->right = std::move(right);
+    return node;
+}
+
+static NodePtr makeLeaf(std::string text)
+{
+    auto lineBreaks = countLineBreaks(text, text.size());
+    return makeNode(std::make_shared<const std::string>(std::move(text)), lineBreaks, nextPriority(), nullptr, nullptr);
+}
+
+static NodePtr withChildren(const NodePtr& node, NodePtr left, NodePtr right)
+{
+    return makeNode(node->chunk, node->chunkLineBreaks, node->priority, std::move(left), std::move(right));
+}
+
+static NodePtr merge(const NodePtr& left, const NodePtr& right)
+{
+    if (!left)
+        return right;
+    if (!right)
+        return left;
+
+    if (left->priority > right->priority)
+        return withChildren(left, left->left, merge(left->right, right));
+    else
+        return withChildren(right, merge(left, right->left), right->right);
+}
+
+/// Splits the tree into [0, offset) and [offset, size). A chunk containing the offset is split in two.
+/// Line break counts of the split chunks may be transiently wrong if a `\r\n` pair is split, see Rope::replace
+static std::pair<NodePtr, NodePtr> split(const NodePtr& node, size_t offset)
+{
+    if (!node)
+        return {nullptr, nullptr};
+
+    size_t leftBytes = bytesOf(node->left);
+    if (offset <= leftBytes)
+    {
+        auto [left, right] = split(node->left, offset);
+        return {std::move(left), withChildren(node, std::move(right), node->right)};
+    }
+
+    offset -= leftBytes;
+    const std::string& chunk = *node->chunk;
+    if (offset >= chunk.size())
+    {
+        auto [left, right] = split(node->right, offset - chunk.size());
+        return {withChildren(node, node->left, std::move(left)), std::move(right)};
+    }
+
+    return {merge(node->left, makeLeaf(chunk.substr(0, offset))), merge(makeLeaf(chunk.substr(offset)), node->right)};
+}
+
+static const Rope::Node* firstNode(const NodePtr& node)
+{
+    const Rope::Node* current = node.get();
+    while (current && current->left)
+        current = current->left.get();
+    return current;
+}
+
+static const Rope::Node* lastNode(const NodePtr& node)
+{
+    const Rope::Node* current = node.get();
+    while (current && current->right)
+        current = current->right.get();
+    return current;
+}
+
+/// Splits text into chunks of at most MaxChunkSize, without splitting `\r\n` pairs or UTF-8 sequences, and builds a tree from them
+static NodePtr build(std::string_view text)
+{
+    NodePtr result;
+    if (text.empty())
+        return result;
+
+    // Split into evenly sized chunks, so that text slightly larger than a chunk does not leave a tiny remainder
+    size_t chunkCount = (text.size() + Rope::MaxChunkSize - 1) / Rope::MaxChunkSize;
+    size_t targetSize = (text.size() + chunkCount - 1) / chunkCount;
+
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = std::min(start + targetSize, text.size());
+        if (end < text.size())
+        {
+            // Only step back a bounded distance, as invalid UTF-8 may contain long runs of continuation bytes
+            size_t boundary = end;
+            while (boundary > start + 1 && boundary + 3 > end && isContinuationByte(text[boundary]))
+                boundary--;
+            if (!isContinuationByte(text[boundary]))
+                end = boundary;
+
+            if (text[end - 1] == '\r' && text[end] == '\n')
+                end = end - 1 > start ? end - 1 : end + 1;
+        }
+
+        result = merge(result, makeLeaf(std::string(text.substr(start, end - start))));
+        start = end;
+    }
+
+    return result;
+}
+
+Rope::Rope(std::string_view text)
+    : root(build(text))
+{
+}
+
+void Rope::replace(size_t offset, size_t length, std::string_view text)
+{
+    offset = std::min(offset, size());
+    length = std::min(length, size() - offset);
+
+    auto [before, rest] = split(root, offset);
+    auto after = split(rest, length).second;
+
+    // The chunks either side of the edit are rebuilt together with the inserted text. This keeps chunks from fragmenting as text is
+    // typed, and re-establishes the invariants if the edit split (or created) a `\r\n` pair or a UTF-8 sequence at its boundaries
+    std::string middle;
+    if (auto last = lastNode(before))
+    {
+        middle = *last->chunk;
+        std::tie(before, std::ignore) = split(before, before->bytes - middle.size());
+
+        // Absorb one more chunk if the edit left a small chunk behind, so deleting text gradually merges chunks together
+        if (auto previous = lastNode(before); previous && middle.size() + text.size() < MaxChunkSize / 4)
+        {
+            middle.insert(0, *previous->chunk);
+            std::tie(before, std::ignore) = split(before, before->bytes - previous->chunk->size());
+        }
+    }
+    middle.append(text);
+    if (auto first = firstNode(after))
+    {
+        auto firstSize = first->chunk->size();
+        middle.append(*first->chunk);
+        std::tie(std::ignore, after) = split(after, firstSize);
+    }
+
+    root = merge(merge(before, build(middle)), after);
+}
+
+size_t Rope::lineStart(size_t line) const
+{
+    if (line == 0)
+        return 0;
+
+    // Find the end of the `line`th line break
+    size_t offset = 0;
+    const Node* node = root.get();
+    while (node)
+    {
+        size_t leftLineBreaks = lineBreaksOf(node->left);
+        if (line <= leftLineBreaks)
+        {
+            node = node->left.get();
+            continue;
+        }
+
+        line -= leftLineBreaks;
+        offset += bytesOf(node->left);
+        if (line <= node->chunkLineBreaks)
+            return offset + lineBreakEnd(*node->chunk, line);
+
+        line -= node->chunkLineBreaks;
+        offset += node->chunk->size();
+        node = node->right.get();
+    }
+
+    return size();
+}
+
+size_t Rope::lineOf(size_t offset) const
+{
+    // Count the line breaks which end at or before the offset
+    size_t line = 0;
+    const Node* node = root.get();
+    while (node)
+    {
+        size_t leftBytes = bytesOf(node->left);
+        if (offset <= leftBytes)
+        {
+            node = node->left.get();
+            continue;
+        }
+
+        line += lineBreaksOf(node->left);
+        offset -= leftBytes;
+        if (offset <= node->chunk->size())
+            return line + countLineBreaks(*node->chunk, offset);
+
+        line += node->chunkLineBreaks;
+        offset -= node->chunk->size();
+        node = node->right.get();
+    }
+
+    return line;
+}
+
+std::string Rope::substr(size_t offset, size_t length) const
+{
+    std::string result;
+    appendTo(result, offset, length);
+    return result;
+}
+
+void Rope::appendTo(std::string& output, size_t offset, size_t length) const
+{
+    if (offset >= size())
+        return;
+
+    length = std::min(length, size() - offset);
+    output.reserve(output.size() + length);
+    forEachChunk(offset, length,
+        [&](std::string_view piece)
+        {
+            output.append(piece);
+            return false;
+        });
+}
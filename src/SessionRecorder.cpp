@@ -0,0 +1,74 @@
+#include "LSP/SessionRecorder.hpp"
+#include "LSP/JsonRpc.hpp"
+
+#include "Luau/StringUtils.h"
+
+static constexpr std::string_view contentLengthHeader = "Content-Length:";
+static constexpr std::string_view timestampHeader = "Recorded-At:";
+
+SessionRecorder::SessionRecorder(std::unique_ptr<std::ostream> output)
+    : output(std::move(output))
+    , start(std::chrono::steady_clock::now())
+{
+}
+
+void SessionRecorder::record(std::string_view body)
+{
+    auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    std::string buffer;
+    buffer.reserve(body.size() + 64);
+    buffer.append(timestampHeader);
+    buffer.append(" ");
+    buffer.append(std::to_string(timestamp.count()));
+    buffer.append("\r\n");
+    json_rpc::writeFramedBody(buffer, body);
+
+    output->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    output->flush();
+}
+
+static size_t parseHeaderValue(std::string_view value)
+{
+    size_t result = 0;
+    for (char c : value)
+    {
+        if (c >= '0' && c <= '9')
+            result = result * 10 + static_cast<size_t>(c - '0');
+        else if (c != ' ')
+            break;
+    }
+    return result;
+}
+
+bool readRecordedMessage(std::istream& input, RecordedMessage& message)
+{
+    size_t contentLength = 0;
+    message.timestamp = std::chrono::microseconds(0);
+
+    std::string line;
+    while (std::getline(input, line))
+    {
+        std::string_view header = line;
+        while (!header.empty() && (header.back() == '\r' || header.back() == ' '))
+            header.remove_suffix(1);
+
+        // An empty line ends the header block
+        if (header.empty())
+        {
+            // A recording which was cut off (e.g. by a crash) may end in a partially written message
+            if (contentLength == 0)
+                return false;
+
+            message.body.resize(contentLength);
+            return bool(input.read(&message.body[0], static_cast<std::streamsize>(contentLength)));
+        }
+
+        if (Luau::startsWith(header, contentLengthHeader))
+            contentLength = parseHeaderValue(header.substr(contentLengthHeader.size()));
+        else if (Luau::startsWith(header, timestampHeader))
+            message.timestamp = std::chrono::microseconds(parseHeaderValue(header.substr(timestampHeader.size())));
+    }
+
+    return false;
+}
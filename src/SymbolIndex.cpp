@@ -0,0 +1,271 @@
+#include "LSP/SymbolIndex.hpp"
+
+#include <algorithm>
+#include <optional>
+
+static char toLowerAscii(char c)
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+static std::string lowercase(std::string_view text)
+{
+    std::string result(text);
+    for (auto& c : result)
+        c = toLowerAscii(c);
+    return result;
+}
+
+static uint32_t trigramAt(std::string_view text, size_t i)
+{
+    return (static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8) | static_cast<unsigned char>(text[i + 2]);
+}
+
+static std::vector<uint32_t> trigramsOf(std::string_view lowerText)
+{
+    std::vector<uint32_t> result;
+    if (lowerText.size() < 3)
+        return result;
+
+    result.reserve(lowerText.size() - 2);
+    for (size_t i = 0; i + 2 < lowerText.size(); i++)
+        result.push_back(trigramAt(lowerText, i));
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+/// A bit for each character in the text (letters case-insensitively and digits, with all other characters sharing one bit).
+/// A name can only match a query if it has every bit the query has
+static uint64_t characterMask(std::string_view lowerText)
+{
+    uint64_t mask = 0;
+    for (char c : lowerText)
+    {
+        if (c >= 'a' && c <= 'z')
+            mask |= uint64_t(1) << (c - 'a');
+        else if (c >= '0' && c <= '9')
+            mask |= uint64_t(1) << (26 + c - '0');
+        else
+            mask |= uint64_t(1) << 63;
+    }
+    return mask;
+}
+
+/// Whether a word starts at the position, e.g. `Service` in `getService` or `service` in `get_service`
+static bool isWordStart(std::string_view name, size_t i)
+{
+    if (i == 0)
+        return true;
+
+    char previous = name[i - 1];
+    if (previous == '_' || previous == '.' || previous == ':')
+        return true;
+
+    return previous >= 'a' && previous <= 'z' && name[i] >= 'A' && name[i] <= 'Z';
+}
+
+/// Scores how well the name matches the query, or std::nullopt if it does not match at all. Names starting with the query rank
+/// highest, then names containing it at the start of a word, then anywhere, and finally names containing its characters in order
+static std::optional<int> matchScore(std::string_view name, std::string_view lowerName, std::string_view lowerQuery)
+{
+    if (lowerQuery.empty())
+        return 0;
+
+    // Prefer shorter names amongst names which match equally well
+    int lengthPenalty = static_cast<int>(std::min<size_t>(lowerName.size() - std::min(lowerName.size(), lowerQuery.size()), 100));
+
+    auto position = lowerName.find(lowerQuery);
+    if (position == 0)
+        return (lowerName.size() == lowerQuery.size() ? 4000 : 3000) - lengthPenalty;
+
+    if (position != std::string_view::npos)
+    {
+        for (auto next = position; next != std::string_view::npos; next = lowerName.find(lowerQuery, next + 1))
+            if (isWordStart(name, next))
+                return 2000 - lengthPenalty;
+
+        return 1000 - lengthPenalty;
+    }
+
+    int wordStartBonus = 0;
+    size_t matched = 0;
+    for (size_t i = 0; i < lowerName.size() && matched < lowerQuery.size(); i++)
+    {
+        if (lowerName[i] == lowerQuery[matched])
+        {
+            if (isWordStart(name, i))
+                wordStartBonus += 20;
+            matched++;
+        }
+    }
+
+    if (matched < lowerQuery.size())
+        return std::nullopt;
+
+    return std::min(wordStartBonus, 400) + 400 - lengthPenalty;
+}
+
+bool SymbolIndex::isLive(const Entry& entry) const
+{
+    return entry.generation == generations[entry.module.value];
+}
+
+void SymbolIndex::addEntry(Entry entry)
+{
+    auto index = static_cast<uint32_t>(entries.size());
+    for (auto trigram : trigramsOf(entry.lowerName))
+        trigrams[trigram].push_back(index);
+    masks.push_back(characterMask(entry.lowerName));
+    entries.push_back(std::move(entry));
+}
+
+void SymbolIndex::compact()
+{
+    std::vector<Entry> previous = std::move(entries);
+    entries.clear();
+    entries.reserve(liveEntries);
+    masks.clear();
+    masks.reserve(liveEntries);
+    trigrams.clear();
+
+    for (auto& entry : previous)
+        if (isLive(entry))
+            addEntry(std::move(entry));
+}
+
+void SymbolIndex::setModule(InternedId module, const std::vector<IndexedSymbol>& symbols)
+{
+    removeModule(module);
+
+    if (module.value >= generations.size())
+    {
+        generations.resize(module.value + 1);
+        liveCounts.resize(module.value + 1);
+    }
+
+    uint32_t generation = ++generations[module.value];
+    for (const auto& symbol : symbols)
+        addEntry(Entry{module, generation, symbol, lowercase(symbol.name)});
+
+    liveCounts[module.value] = static_cast<uint32_t>(symbols.size());
+    liveEntries += symbols.size();
+
+    std::lock_guard lock(staleMutex);
+    stale.erase(module);
+}
+
+void SymbolIndex::removeModule(InternedId module)
+{
+    if (module.value >= generations.size())
+        return;
+
+    liveEntries -= liveCounts[module.value];
+    liveCounts[module.value] = 0;
+    generations[module.value]++;
+
+    // Dead entries are only dropped once they make up most of the list, so that replacing a module stays cheap
+    if (entries.size() > 1024 && entries.size() > 2 * liveEntries)
+        compact();
+}
+
+void SymbolIndex::invalidate(InternedId module)
+{
+    std::lock_guard lock(staleMutex);
+    stale.insert(module);
+}
+
+std::vector<InternedId> SymbolIndex::takeStale()
+{
+    std::lock_guard lock(staleMutex);
+    std::vector<InternedId> result(stale.begin(), stale.end());
+    stale.clear();
+    return result;
+}
+
+void SymbolIndex::clear()
+{
+    entries.clear();
+    masks.clear();
+    trigrams.clear();
+    generations.clear();
+    liveCounts.clear();
+    liveEntries = 0;
+
+    std::lock_guard lock(staleMutex);
+    stale.clear();
+}
+
+std::vector<SymbolMatch> SymbolIndex::search(std::string_view query, size_t limit) const
+{
+    std::string lowerQuery = lowercase(query);
+    std::vector<std::pair<int, uint32_t>> scored;
+
+    auto consider = [&](uint32_t index)
+    {
+        const auto& entry = entries[index];
+        if (!isLive(entry))
+            return;
+
+        if (auto score = matchScore(entry.symbol.name, entry.lowerName, lowerQuery))
+            scored.emplace_back(*score, index);
+    };
+
+    bool usedTrigrams = lowerQuery.size() >= 3;
+    if (usedTrigrams)
+    {
+        // Every name containing the query contains all of its trigrams, so only the names with its rarest trigram need to be looked at
+        static const std::vector<uint32_t> none;
+        const std::vector<uint32_t>* rarest = nullptr;
+        for (auto trigram : trigramsOf(lowerQuery))
+        {
+            auto it = trigrams.find(trigram);
+            const auto& candidates = it == trigrams.end() ? none : it->second;
+            if (!rarest || candidates.size() < rarest->size())
+                rarest = &candidates;
+        }
+
+        for (auto index : *rarest)
+            if (entries[index].lowerName.find(lowerQuery) != std::string::npos)
+                consider(index);
+    }
+
+    // Names containing the query always rank above names which only contain its characters in order, so the rest of the names only need
+    // to be looked at if there are too few of them. The names containing the query have already been scored above
+    if (scored.size() < limit)
+    {
+        uint64_t queryMask = characterMask(lowerQuery);
+        for (uint32_t index = 0; index < entries.size(); index++)
+            if ((masks[index] & queryMask) == queryMask && (!usedTrigrams || entries[index].lowerName.find(lowerQuery) == std::string::npos))
+                consider(index);
+    }
+
+    auto better = [this](const std::pair<int, uint32_t>& a, const std::pair<int, uint32_t>& b)
+    {
+        if (a.first != b.first)
+            return a.first > b.first;
+
+        const auto& nameA = entries[a.second].symbol.name;
+        const auto& nameB = entries[b.second].symbol.name;
+        if (nameA.size() != nameB.size())
+            return nameA.size() < nameB.size();
+        if (nameA != nameB)
+            return nameA < nameB;
+        return a.second < b.second;
+    };
+
+    size_t count = std::min(limit, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + static_cast<std::ptrdiff_t>(count), scored.end(), better);
+
+    std::vector<SymbolMatch> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto& entry = entries[scored[i].second];
+        result.push_back(SymbolMatch{entry.module, entry.symbol, scored[i].first});
+    }
+
+    return result;
+}
@@ -4,6 +4,7 @@
 #include "Luau/Location.h"
 #include "Luau/StringUtils.h"
 #include "LSP/TextDocument.hpp"
+#include "LSP/TextScan.hpp"
 #include "LSP/LanguageServer.hpp"
 
 static size_t countLeadingZeros(unsigned char n)
@@ -26,12 +27,15 @@ static size_t countLeadingOnes(unsigned char n)
 // invokes CB(UTF-8 length, UTF-16 length), and breaks if it returns true.
 // Returns true if CB returned true, false if we hit the end of string.
 //
+// DEVIATION: runs of ASCII characters are found with a vectorized scan and reported
+// together, as CB(N, N) for a run of N characters.
+//
 // If the string is not valid UTF-8, we log this error and "decode" the
 // text in some arbitrary way. This is pretty sad, but this tends to happen deep
 // within indexing of headers where clang misdetected the encoding, and
 // propagating the error all the way back up is (probably?) not be worth it.
-using CodepointsCallback = std::function<bool(int, int)>;
-static bool iterateCodepoints(const std::string& U8, const CodepointsCallback& CB)
+template<typename CodepointsCallback>
+static bool iterateCodepoints(std::string_view U8, CodepointsCallback&& CB)
 {
     bool LoggedInvalid = false;
     // A codepoint takes two UTF-16 code unit if it's astral (outside BMP).
@@ -40,10 +44,11 @@ static bool iterateCodepoints(const std::string& U8, const CodepointsCallback& C
     {
         auto C = static_cast<unsigned char>(U8[I]);
         if (LUAU_LIKELY(!(C & 0x80)))
-        { // ASCII character.
-            if (CB(1, 1))
+        { // Run of ASCII characters.
+            size_t Run = text_scan::findNonAscii(U8.substr(I));
+            if (CB(static_cast<int>(Run), static_cast<int>(Run)))
                 return true;
-            ++I;
+            I += Run;
             continue;
         }
         // This convenient property of UTF-8 holds for all non-ASCII characters.
@@ -75,11 +80,14 @@ static bool iterateCodepoints(const std::string& U8, const CodepointsCallback& C
 }
 
 // https://github.com/llvm/llvm-project/blob/main/clang-tools-extra/clangd/SourceCode.cpp
-// Returns the byte offset into the string that is an offset of \p Units in
+// Returns the byte offset into the [Offset, Offset + Length) range of the rope that is an offset of \p Units in
 // the specified encoding.
 // Conceptually, this converts to the encoding, truncates to CodeUnits,
 // converts back to UTF-8, and returns the length in bytes.
-static size_t measureUnits(const std::string& U8, int Units, lsp::PositionEncodingKind Enc, bool& Valid)
+//
+// Chunks of the rope never split a codepoint, so each chunk can be measured on its own.
+// Used to convert positions whilst edits are being applied, when the PositionIndex is out of date
+static size_t measureUnits(const Rope& Content, size_t Offset, size_t Length, int Units, lsp::PositionEncodingKind Enc, bool& Valid)
 {
     Valid = Units >= 0;
     if (Units <= 0)
@@ -91,39 +99,47 @@ static size_t measureUnits(const std::string& U8, int Units, lsp::PositionEncodi
         Result = Units;
         break;
     case lsp::PositionEncodingKind::UTF16:
-        Valid = iterateCodepoints(U8,
-            [&](int U8Len, int U16Len)
+    case lsp::PositionEncodingKind::UTF32:
+        Valid = false;
+        Content.forEachChunk(Offset, Length,
+            [&](std::string_view Chunk)
             {
-                Result += U8Len;
-                Units -= U16Len;
-                return Units <= 0;
+                Valid = iterateCodepoints(Chunk,
+                    [&](int U8Len, int U16Len)
+                    {
+                        if (U8Len == U16Len)
+                        {
+                            // A run of ASCII (or a single invalid byte), which may only be partially needed
+                            int Taken = std::min(U8Len, Units);
+                            Result += Taken;
+                            Units -= Taken;
+                        }
+                        else
+                        {
+                            Result += U8Len;
+                            Units -= Enc == lsp::PositionEncodingKind::UTF16 ? U16Len : 1;
+                        }
+                        return Units <= 0;
+                    });
+                return Valid;
             });
         if (Units < 0) // Offset in the middle of a surrogate pair.
             Valid = false;
         break;
-    case lsp::PositionEncodingKind::UTF32:
-        Valid = iterateCodepoints(U8,
-            [&](int U8Len, int U16Len)
-            {
-                Result += U8Len;
-                Units--;
-                return Units <= 0;
-            });
-        break;
         // case OffsetEncoding::UnsupportedEncoding:
         //     llvm_unreachable("unsupported encoding");
     }
     // Don't return an out-of-range index if we overran.
-    if (Result > U8.size())
+    if (Result > Length)
     {
         Valid = false;
-        return U8.size();
+        return Length;
     }
     return Result;
 }
 
 // https://github.com/llvm/llvm-project/blob/main/clang-tools-extra/clangd/SourceCode.cpp
-size_t lspLength(const std::string& Code)
+size_t lspLength(std::string_view Code)
 {
     size_t Count = 0;
     switch (positionEncoding())
@@ -143,7 +159,8 @@ size_t lspLength(const std::string& Code)
         iterateCodepoints(Code,
             [&](int U8Len, int U16Len)
             {
-                ++Count;
+                // Runs of ASCII are one codepoint per byte
+                Count += U8Len == U16Len ? U8Len : 1;
                 return false;
             });
         break;
@@ -153,27 +170,6 @@ size_t lspLength(const std::string& Code)
     return Count;
 }
 
-static std::vector<size_t> computeLineOffsets(const std::string& content, bool isAtLineStart, size_t textOffset = 0)
-{
-    std::vector<size_t> result{};
-    if (isAtLineStart)
-        result = {textOffset};
-
-    for (size_t i = 0; i < content.size(); i++)
-    {
-        auto ch = content[i];
-        if (ch == '\r' || ch == '\n')
-        {
-            if (ch == '\r' && i + 1 < content.size() && content[i + 1] == '\n')
-            {
-                i++;
-            }
-            result.push_back(textOffset + i + 1);
-        }
-    }
-    return result;
-}
-
 static lsp::Range getWellformedRange(lsp::Range range)
 {
     auto start = range.start;
@@ -194,66 +190,57 @@ std::string TextDocument::getText(std::optional<lsp::Range> range) const
         auto end = offsetAt(range->end);
         return _content.substr(start, end - start);
     }
+
+    auto content = _content.toString();
     // Handle shebang
-    if (_content.size() > 2 && _content[0] == '#' && _content[1] == '!')
+    if (content.size() > 2 && content[0] == '#' && content[1] == '!')
     {
-        if (auto pos = _content.find('\n'); pos != std::string::npos)
-            return _content.substr(pos);
+        if (auto pos = content.find('\n'); pos != std::string::npos)
+            return content.substr(pos);
         else
             return "\n";
     }
-    return _content;
+    return content;
 }
 
 std::string TextDocument::getLine(size_t index) const
 {
     LUAU_ASSERT(index < lineCount());
-    auto lineOffsets = getLineOffsets();
-    auto startOffset = lineOffsets[index];
+    auto startOffset = _content.lineStart(index);
 
     if (index + 1 < lineCount())
-        return _content.substr(startOffset, lineOffsets[index + 1] - startOffset - 1);
+        return _content.substr(startOffset, _content.lineStart(index + 1) - startOffset - 1);
     else
         return _content.substr(startOffset, std::string::npos); // Return remaining content
 }
 
-lsp::Position TextDocument::positionAt(size_t offset) const
+const PositionIndex& TextDocument::positionIndex() const
 {
-    offset = std::max(std::min(offset, _content.size()), (size_t)0);
-    auto lineOffsets = getLineOffsets();
-
-    size_t low = 0, high = lineOffsets.size();
-    if (high == 0)
+    // Snapshots may be read from several threads, which could race to build the index. The first index published wins,
+    // and is never replaced afterwards, so references to it stay valid for the lifetime of the document
+    auto index = std::atomic_load(&_positionIndex);
+    if (!index)
     {
-        return lsp::Position{0, offset};
+        std::shared_ptr<const PositionIndex> built = std::make_shared<PositionIndex>(_content);
+        if (std::atomic_compare_exchange_strong(&_positionIndex, &index, built))
+            index = std::move(built);
     }
+    return *index;
+}
 
-    while (low < high)
-    {
-        auto mid = (low + high) / 2;
-        if (lineOffsets[mid] > offset)
-        {
-            high = mid;
-        }
-        else
-        {
-            low = mid + 1;
-        }
-    }
+lsp::Position TextDocument::positionAt(size_t offset) const
+{
+    offset = std::min(offset, _content.size());
 
-    // low is the least x for which the line offset is larger than the current offset
-    // or array.length if no line offset is larger than the current offset
-    auto line = low - 1;
-    std::string currentContent = _content.substr(lineOffsets[line], offset - lineOffsets[line]);
-    return lsp::Position{line, lspLength(currentContent)};
+    const auto& index = positionIndex();
+    auto line = index.lineOf(offset);
+    return lsp::Position{line, index.toUnits(line, offset - index.lineStart(line), positionEncoding())};
 }
 
 size_t TextDocument::offsetAt(const lsp::Position& position) const
 {
     auto utf8Position = convertPosition(position);
-    auto lineOffsets = getLineOffsets();
-    auto lineOffset = lineOffsets[utf8Position.line];
-    return lineOffset + utf8Position.column;
+    return positionIndex().lineStart(utf8Position.line) + utf8Position.column;
 }
 
 // We treat all lsp:Positions as UTF-16 encoded. We must convert between the two when necessary
@@ -262,22 +249,16 @@ Luau::Position TextDocument::convertPosition(const lsp::Position& position) cons
     LUAU_ASSERT(position.line <= UINT_MAX);
     LUAU_ASSERT(position.character <= UINT_MAX);
 
-    auto lineOffsets = getLineOffsets();
-    if (position.line >= lineCount())
-    {
-        return Luau::Position{static_cast<unsigned int>(lineOffsets.size() - 1), static_cast<unsigned int>(_content.size() - lineOffsets.back())};
-    }
-    else if (position.line < 0)
+    const auto& index = positionIndex();
+    if (position.line >= index.lineCount())
     {
-        return Luau::Position{0, 0};
+        auto lastLine = index.lineCount() - 1;
+        return Luau::Position{static_cast<unsigned int>(lastLine), static_cast<unsigned int>(index.lineLength(lastLine))};
     }
-    auto lineOffset = lineOffsets[position.line];
-    auto nextLineOffset = position.line + 1 < lineOffsets.size() ? lineOffsets[position.line + 1] : _content.size();
 
     // position.character may be in UTF-16, so we need to convert as necessary
     bool valid = true;
-    std::string line = _content.substr(lineOffset, nextLineOffset - lineOffset);
-    size_t byteInLine = measureUnits(line, static_cast<int>(position.character), positionEncoding(), valid);
+    size_t byteInLine = index.toBytes(position.line, position.character, positionEncoding(), valid);
 
     if (!valid)
         std::cerr << "UTF-16 offset " << position.character << " is invalid for line " << position.line << "\n";
@@ -287,10 +268,78 @@ Luau::Position TextDocument::convertPosition(const lsp::Position& position) cons
 
 lsp::Position TextDocument::convertPosition(const Luau::Position& position) const
 {
-    auto lineOffsets = getLineOffsets();
+    return convertPosition(positionIndex(), position, positionEncoding(), nullptr);
+}
+
+lsp::Position TextDocument::convertPosition(
+    const PositionIndex& index, const Luau::Position& position, lsp::PositionEncodingKind encoding, size_t* cursor) const
+{
     auto line = position.line;
-    std::string currentContent = _content.substr(lineOffsets[line], position.column);
-    return lsp::Position{line, lspLength(currentContent)};
+    auto lineOffset = index.lineStart(line);
+
+    // A column past the end of the line (such as a position past the end of the file) continues into the lines after it
+    if (position.column > index.lineLength(line))
+    {
+        size_t length = 0;
+        _content.forEachChunk(lineOffset, position.column,
+            [&](std::string_view chunk)
+            {
+                length += lspLength(chunk);
+                return false;
+            });
+        return lsp::Position{line, length};
+    }
+
+    if (cursor)
+        return lsp::Position{line, index.toUnits(line, position.column, encoding, *cursor)};
+    return lsp::Position{line, index.toUnits(line, position.column, encoding)};
+}
+
+std::vector<lsp::Position> TextDocument::convertPositions(const std::vector<Luau::Position>& positions) const
+{
+    const auto& index = positionIndex();
+    auto encoding = positionEncoding();
+
+    std::vector<lsp::Position> result;
+    result.reserve(positions.size());
+    size_t cursor = 0;
+    for (const auto& position : positions)
+        result.emplace_back(convertPosition(index, position, encoding, &cursor));
+    return result;
+}
+
+std::vector<lsp::Range> TextDocument::convertLocations(const std::vector<Luau::Location>& locations) const
+{
+    const auto& index = positionIndex();
+    auto encoding = positionEncoding();
+
+    std::vector<lsp::Range> result;
+    result.reserve(locations.size());
+    // Ends are swept separately, as a location may end after the beginning of the next one
+    size_t beginCursor = 0;
+    size_t endCursor = 0;
+    for (const auto& location : locations)
+        result.emplace_back(lsp::Range{
+            convertPosition(index, location.begin, encoding, &beginCursor), convertPosition(index, location.end, encoding, &endCursor)});
+    return result;
+}
+
+size_t TextDocument::offsetAtUnindexed(const lsp::Position& position) const
+{
+    if (position.line >= _content.lineCount())
+        return _content.size();
+
+    auto lineOffset = _content.lineStart(position.line);
+    auto nextLineOffset = _content.lineStart(position.line + 1);
+
+    bool valid = true;
+    size_t byteInLine = measureUnits(
+        _content, lineOffset, nextLineOffset - lineOffset, static_cast<int>(position.character), positionEncoding(), valid);
+
+    if (!valid)
+        std::cerr << "UTF-16 offset " << position.character << " is invalid for line " << position.line << "\n";
+
+    return lineOffset + byteInLine;
 }
 
 void TextDocument::update(const std::vector<lsp::TextDocumentContentChangeEvent>& changes, size_t version)
@@ -301,62 +350,28 @@ void TextDocument::update(const std::vector<lsp::TextDocumentContentChangeEvent>
         if (change.range)
         {
             auto range = getWellformedRange(*change.range);
-            size_t startOffset = offsetAt(range.start);
-            size_t endOffset = offsetAt(range.end); // End position is EXCLUSIVE
-            _content = _content.substr(0, startOffset) + change.text + _content.substr(endOffset, _content.size() - endOffset);
-
-            // Update offset
-            size_t startLine = std::max(range.start.line, (size_t)0);
-            size_t endLine = std::max(range.end.line, (size_t)0);
-
-            auto& offsets = *_lineOffsets;
-            auto addedLineOffsets = computeLineOffsets(change.text, false, startOffset);
-            auto addedLineOffsetsLen = addedLineOffsets.size();
-            if (endLine - startLine == addedLineOffsets.size())
-            {
-                for (size_t i = 0, len = addedLineOffsets.size(); i < len; i++)
-                {
-                    offsets[i + startLine + 1] = addedLineOffsets[i];
-                }
-            }
-            else
-            {
-                // Copy all unchanged lines after endline to the end of addedLineOffsets
-                if (offsets.size() > endLine)
-                    addedLineOffsets.insert(addedLineOffsets.end(), offsets.begin() + endLine + 1, offsets.end());
-                // Erase all points from offsets after startline
-                if (offsets.size() > startLine)
-                    offsets.erase(offsets.begin() + startLine + 1, offsets.end());
-                // Append addedLineOffsets to offsets
-                offsets.insert(offsets.end(), addedLineOffsets.begin(), addedLineOffsets.end());
-            }
-            long diff = static_cast<long>(change.text.size() - (endOffset - startOffset));
-            if (diff != 0)
-            {
-                for (size_t i = startLine + 1 + addedLineOffsetsLen, len = offsets.size(); i < len; i++)
-                {
-                    offsets[i] = offsets[i] + diff;
-                }
-            }
+            // The position index is stale once the first change is applied, and rebuilding it for every keystroke would
+            // cost a full scan of the document, so the rope is measured directly instead
+            size_t startOffset = offsetAtUnindexed(range.start);
+            size_t endOffset = offsetAtUnindexed(range.end); // End position is EXCLUSIVE
+            _content.replace(startOffset, endOffset - startOffset, change.text);
         }
         else
         {
-            _content = change.text;
-            _lineOffsets = std::nullopt;
+            _content = Rope(change.text);
         }
     }
+
+    // Line offsets are tracked by the rope, so the position index is only rebuilt if it is asked for again
+    _positionIndex = nullptr;
 }
 
 size_t TextDocument::lineCount() const
 {
-    return getLineOffsets().size();
+    return _content.lineCount();
 }
 
 const std::vector<size_t>& TextDocument::getLineOffsets() const
 {
-    if (!_lineOffsets)
-    {
-        _lineOffsets = computeLineOffsets(_content, true);
-    }
-    return *_lineOffsets;
-}
\ No newline at end of file
+    return positionIndex().getLineStarts();
+}
@@ -0,0 +1,127 @@
+#include "LSP/TextScan.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define LSP_TEXT_SCAN_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LSP_TEXT_SCAN_SSE2 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace text_scan
+{
+static bool matches(unsigned char c, bool lineBreaks, bool nonAscii)
+{
+    return (lineBreaks && (c == '\r' || c == '\n')) || (nonAscii && c >= 0x80);
+}
+
+#if defined(LSP_TEXT_SCAN_AVX2) || defined(LSP_TEXT_SCAN_SSE2)
+static size_t countTrailingZeros(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+/// Scans the text a word at a time, only inspecting individual bytes within a word known to contain a match
+template<bool LineBreaks, bool NonAscii>
+static size_t findScalar(const char* data, size_t size)
+{
+    constexpr uint64_t ones = 0x0101010101010101ull;
+    constexpr uint64_t highBits = 0x8080808080808080ull;
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+
+        uint64_t found = 0;
+        if constexpr (NonAscii)
+            found |= word & highBits;
+        if constexpr (LineBreaks)
+        {
+            // A byte of `x` is zero if the corresponding byte of the word is the character being searched for. This may report
+            // false positives above a true match, but never reports a match where there is none
+            uint64_t cr = word ^ (ones * '\r');
+            uint64_t lf = word ^ (ones * '\n');
+            found |= ((cr - ones) & ~cr & highBits) | ((lf - ones) & ~lf & highBits);
+        }
+
+        if (found)
+            break;
+    }
+
+    for (; i < size; i++)
+        if (matches(static_cast<unsigned char>(data[i]), LineBreaks, NonAscii))
+            return i;
+    return size;
+}
+
+template<bool LineBreaks, bool NonAscii>
+static size_t find(std::string_view text)
+{
+    const char* data = text.data();
+    size_t size = text.size();
+    size_t i = 0;
+
+#if defined(LSP_TEXT_SCAN_AVX2)
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    for (; i + 32 <= size; i += 32)
+    {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t mask = 0;
+        if constexpr (NonAscii)
+            mask |= static_cast<uint32_t>(_mm256_movemask_epi8(block));
+        if constexpr (LineBreaks)
+            mask |= static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, cr), _mm256_cmpeq_epi8(block, lf))));
+        if (mask)
+            return i + countTrailingZeros(mask);
+    }
+#elif defined(LSP_TEXT_SCAN_SSE2)
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    for (; i + 16 <= size; i += 16)
+    {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        uint32_t mask = 0;
+        if constexpr (NonAscii)
+            mask |= static_cast<uint32_t>(_mm_movemask_epi8(block));
+        if constexpr (LineBreaks)
+            mask |= static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, cr), _mm_cmpeq_epi8(block, lf))));
+        if (mask)
+            return i + countTrailingZeros(mask);
+    }
+#endif
+
+    return i + findScalar<LineBreaks, NonAscii>(data + i, size - i);
+}
+
+size_t findLineBreak(std::string_view text)
+{
+    return find<true, false>(text);
+}
+
+size_t findNonAscii(std::string_view text)
+{
+    return find<false, true>(text);
+}
+
+size_t findLineBreakOrNonAscii(std::string_view text)
+{
+    return find<true, true>(text);
+}
+} // namespace text_scan
@@ -0,0 +1,101 @@
+#include "LSP/ThreadPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++)
+        threads.emplace_back(&ThreadPool::workLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopped = true;
+    }
+    taskAvailable.notify_all();
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void ThreadPool::workLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            taskAvailable.wait(lock, [this] { return stopped || !tasks.empty(); });
+            if (tasks.empty())
+                return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& task)
+{
+    if (count == 0)
+        return;
+
+    std::atomic<size_t> next = 0;
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+    size_t remaining = std::min(count, size());
+    std::exception_ptr error;
+
+    // One long-running task per worker pulls indices until they run out, which balances uneven task lengths
+    size_t workers = remaining;
+    for (size_t worker = 0; worker < workers; worker++)
+    {
+        submit(
+            [&, worker]()
+            {
+                std::exception_ptr caught;
+                for (size_t index = next++; index < count; index = next++)
+                {
+                    try
+                    {
+                        task(index, worker);
+                    }
+                    catch (...)
+                    {
+                        if (!caught)
+                            caught = std::current_exception();
+                    }
+                }
+
+                std::lock_guard lock(doneMutex);
+                if (caught && !error)
+                    error = caught;
+                if (--remaining == 0)
+                    doneCondition.notify_one();
+            });
+    }
+
+    std::unique_lock lock(doneMutex);
+    doneCondition.wait(lock, [&] { return remaining == 0; });
+
+    if (error)
+        std::rethrow_exception(error);
+}
@@ -1,50 +1,49 @@
 // Based off https://github.com/microsoft/vscode-uri/blob/6dec22d7dcc6c63c30343d3a8d56050d0078cb6a/src/uri.ts
 #include <filesystem>
-#include <regex>
+#include <iomanip>
 #include <optional>
+#include <sstream>
+#include <string_view>
 #include <cctype>
 #include "LSP/Uri.hpp"
 #include "LSP/Utils.hpp"
 
-static std::string decodeURIComponent(const std::string& str)
+static int hexValue(char c)
 {
-    std::string res;
-    res.reserve(str.length());
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Decodes every `%XX` escape with two hex digits. Any other `%` is kept as is
+static std::string percentDecode(std::string_view str)
+{
+    size_t next = str.find('%');
+    if (next == std::string_view::npos)
+        return std::string(str);
 
-    for (size_t i = 0; i < str.length(); i++)
+    std::string out;
+    out.reserve(str.size());
+    out.append(str.substr(0, next));
+
+    for (size_t i = next; i < str.size(); i++)
     {
-        auto ch = str[i];
-        if (ch == '%' && (i + 2) < str.length())
+        int high = 0;
+        int low = 0;
+        if (str[i] == '%' && i + 2 < str.size() && (high = hexValue(str[i + 1])) >= 0 && (low = hexValue(str[i + 2])) >= 0)
         {
-            auto hex = str.substr(i + 1, 2);
-            res += static_cast<char>(std::stol(hex.c_str(), nullptr, 16));
+            out += static_cast<char>(high * 16 + low);
             i += 2;
         }
-        else if (ch == '+')
-        {
-            res += ' ';
-        }
         else
         {
-            res += ch;
+            out += str[i];
         }
     }
-    return res;
-}
-
-static std::string percentDecode(const std::string& str)
-{
-    const std::regex REGEX_EXPR(R"((%[0-9A-Za-z][0-9A-Za-z])+)");
-    std::string out;
-    auto it = str.cbegin();
-    auto end = str.cend();
-
-    for (std::smatch match; std::regex_search(it, end, match, REGEX_EXPR); it = match[0].second)
-    {
-        out += match.prefix();
-        out += decodeURIComponent(match.str());
-    }
-    out.append(it, end);
     return out;
 }
 
@@ -216,20 +215,46 @@ static std::string encodeURIComponentMinimal(const std::string& path, bool, bool
     return res.has_value() ? *res : path;
 }
 
+// Splits the value into the components matched by the regular expression in https://datatracker.ietf.org/doc/html/rfc3986#appendix-B:
+// ^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?
+// Every string matches, so parsing never fails
 Uri Uri::parse(const std::string& value)
 {
-    const std::regex REGEX_EXPR(R"(^(([^:\/?#]+?):)?(\/\/([^\/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)");
-    std::smatch match;
-    if (std::regex_match(value, match, REGEX_EXPR))
+    std::string_view rest = value;
+    std::string_view scheme;
+    std::string_view authority;
+    std::string_view path;
+    std::string_view query;
+    std::string_view fragment;
+
+    // The scheme is everything before the first ':', as long as it is not empty and no '/', '?' or '#' comes first
+    if (size_t schemeEnd = rest.find_first_of(":/?#"); schemeEnd != std::string_view::npos && schemeEnd > 0 && rest[schemeEnd] == ':')
     {
-        // match[0] is whole string
-        return {match[2], percentDecode(match[4]), percentDecode(match[5]), percentDecode(match[7]), percentDecode(match[9])};
+        scheme = rest.substr(0, schemeEnd);
+        rest.remove_prefix(schemeEnd + 1);
     }
-    else
+
+    if (rest.size() >= 2 && rest[0] == '/' && rest[1] == '/')
+    {
+        rest.remove_prefix(2);
+        authority = rest.substr(0, rest.find_first_of("/?#"));
+        rest.remove_prefix(authority.size());
+    }
+
+    path = rest.substr(0, rest.find_first_of("?#"));
+    rest.remove_prefix(path.size());
+
+    if (!rest.empty() && rest[0] == '?')
     {
-        // TODO: should we error?
-        return {"", "", "", "", ""};
+        rest.remove_prefix(1);
+        query = rest.substr(0, rest.find('#'));
+        rest.remove_prefix(query.size());
     }
+
+    if (!rest.empty() && rest[0] == '#')
+        fragment = rest.substr(1);
+
+    return {std::string(scheme), percentDecode(authority), percentDecode(path), percentDecode(query), percentDecode(fragment)};
 }
 
 Uri Uri::file(const std::filesystem::path& fsPath)
@@ -265,6 +290,23 @@ Uri Uri::file(const std::filesystem::path& fsPath)
     return Uri("file", authority, path, "", "");
 }
 
+Uri Uri::normalisedFile(const std::filesystem::path& fsPath)
+{
+    Uri uri = file(fsPath);
+
+    // Lower-case the drive letter in /C:/path, as toString() does
+    if (uri.path.length() >= 3 && uri.path[0] == '/' && uri.path[2] == ':' && isupper(static_cast<unsigned char>(uri.path[1])))
+        uri.path[1] = static_cast<char>(tolower(static_cast<unsigned char>(uri.path[1])));
+
+    // Lower-case the host (and port), but not any user information, of the authority
+    auto host = uri.authority.find('@');
+    host = host == std::string::npos ? 0 : host + 1;
+    for (size_t i = host; i < uri.authority.size(); i++)
+        uri.authority[i] = static_cast<char>(tolower(static_cast<unsigned char>(uri.authority[i])));
+
+    return uri;
+}
+
 std::filesystem::path Uri::fsPath() const
 {
     if (!authority.empty() && path.length() > 1 && scheme == "file")
@@ -126,6 +126,23 @@ std::optional<std::filesystem::path> getHomeDirectory()
     }
 }
 
+std::optional<std::filesystem::path> getCacheDirectory()
+{
+#if defined(_WIN32)
+    if (const char* localAppData = getenv("LOCALAPPDATA"))
+        return localAppData;
+#elif defined(__APPLE__)
+    if (auto home = getHomeDirectory())
+        return *home / "Library" / "Caches";
+#else
+    if (const char* cacheHome = getenv("XDG_CACHE_HOME"); cacheHome && *cacheHome)
+        return cacheHome;
+    if (auto home = getHomeDirectory())
+        return *home / ".cache";
+#endif
+    return std::nullopt;
+}
+
 // Resolves a filesystem path, including any tilde expansion
 std::filesystem::path resolvePath(const std::filesystem::path& path)
 {
@@ -2,16 +2,172 @@
 
 #include <iostream>
 #include <memory>
+#include <set>
 
 #include "LSP/LanguageServer.hpp"
+#include "LSP/ThreadPool.hpp"
+#include "LSP/Version.hpp"
 #include "Platform/LSPPlatform.hpp"
 #include "Platform/RobloxPlatform.hpp"
-#include "glob/glob.hpp"
 #include "Luau/BuiltinDefinitions.h"
 #include "Luau/TimeTrace.h"
 
 LUAU_FASTFLAG(LuauSolverV2)
 
+/// The number of modules each indexing thread parses per background step
+static constexpr size_t kIndexBatchSizePerThread = 16;
+/// The number of directories walked per background step whilst finding the files to index
+static constexpr size_t kIndexWalkDirectoriesPerStep = 256;
+
+namespace
+{
+/// Parses modules whilst indexing on a worker thread, into a frontend separate from the workspace's one.
+/// Only the module being indexed is read, so that each module is parsed once across all workers
+/// (its dependencies are parsed when they are indexed themselves)
+struct IndexWorker : Luau::FileResolver
+{
+    WorkspaceFileResolver& fileResolver;
+    Luau::Frontend frontend;
+    std::optional<Luau::ModuleName> indexing;
+    /// The source of the module being indexed, which has already been read to check the index cache
+    std::optional<Luau::SourceCode> source;
+
+    explicit IndexWorker(WorkspaceFileResolver& fileResolver)
+        : fileResolver(fileResolver)
+        , frontend(this, &fileResolver)
+    {
+    }
+
+    std::optional<Luau::SourceCode> readSource(const Luau::ModuleName& name) override
+    {
+        if (name != indexing)
+            return std::nullopt;
+        if (source)
+            return std::exchange(source, std::nullopt);
+        return fileResolver.readSource(name);
+    }
+
+    std::optional<Luau::ModuleInfo> resolveModule(const Luau::ModuleInfo* context, Luau::AstExpr* node) override
+    {
+        return fileResolver.resolveModule(context, node);
+    }
+
+    std::string getHumanReadableModuleName(const Luau::ModuleName& name) const override
+    {
+        return fileResolver.getHumanReadableModuleName(name);
+    }
+};
+
+/// A module indexed by a worker
+struct IndexResult
+{
+    Luau::ModuleName moduleName;
+    std::optional<IndexedModule> summary;
+    /// Whether the summary came from the index cache, rather than from parsing the module
+    bool restored = false;
+};
+
+struct IndexState
+{
+    ClientConfiguration config;
+
+    /// Whether the files to index are yet to be found, which is done in the first steps
+    bool findingFiles = true;
+    /// The walk for the workspace source files, if they were not already known when indexing started
+    std::unique_ptr<SourceFileWalk> walk;
+
+    std::vector<Uri> files;
+    size_t next = 0;
+
+    ThreadPool pool;
+    /// One per thread in the pool
+    std::vector<std::unique_ptr<IndexWorker>> workers;
+
+    /// Modules parsed by the workers or restored from the index cache, and added to the workspace frontend
+    std::vector<Luau::ModuleName> merged;
+    /// Modules parsed by the workers which the workspace frontend had already loaded in the meantime
+    std::vector<Luau::ModuleName> deferred;
+
+    /// Where the index is persisted, if caching is enabled
+    std::optional<std::filesystem::path> cachePath;
+    std::string cacheKey;
+    IndexCache cache;
+    /// Every module indexed, to be written back to the cache
+    std::unordered_map<Luau::ModuleName, IndexedModule> summaries;
+    size_t restoredCount = 0;
+
+    /// The work done progress shown to the user, if the client supports it. Ended when indexing completes or is cancelled
+    std::optional<lsp::ProgressToken> progressToken;
+
+    IndexState(ClientConfiguration config, std::optional<lsp::ProgressToken> progressToken)
+        : config(std::move(config))
+        , pool(this->config.index.threads)
+        , progressToken(std::move(progressToken))
+    {
+    }
+
+    IndexState(const IndexState&) = delete;
+    IndexState& operator=(const IndexState&) = delete;
+
+    ~IndexState()
+    {
+        // The task was replaced or cancelled (e.g. the workspace was removed) before indexing completed
+        endProgress("Cancelled");
+    }
+
+    void reportProgress(const std::string& message, std::optional<unsigned int> percentage = std::nullopt) const
+    {
+        if (progressToken)
+            Client::sendProgress({*progressToken, lsp::WorkDoneProgressReport{"report", std::nullopt, message, percentage}});
+    }
+
+    void endProgress(const std::string& message)
+    {
+        if (progressToken)
+            Client::sendProgress({*progressToken, lsp::WorkDoneProgressEnd{"end", message}});
+        progressToken = std::nullopt;
+    }
+};
+} // namespace
+
+/// Everything persisted module summaries depend on besides their source: the server version, the Luau flags the modules were
+/// parsed under, and the inputs to module resolution, including every `.luaurc` in the directories of the files being indexed
+static std::string indexCacheKey(
+    const LSPPlatform& platform, const ClientConfiguration& config, const std::vector<Uri>& files, const std::filesystem::path& root)
+{
+    std::string key = LSP_VERSION;
+    key += '\n';
+    key += json(config.platform).dump();
+    key += json(config.require).dump();
+    key += platform.getModuleResolutionKey();
+    key += '\n';
+
+    // Each directory is only visited once, so this walks up from each file until it reaches a directory already seen
+    std::set<std::filesystem::path> directories;
+    for (const auto& file : files)
+    {
+        for (auto directory = file.fsPath().parent_path(); directories.insert(directory).second; directory = directory.parent_path())
+            if (directory == root || !directory.has_relative_path())
+                break;
+    }
+    for (const auto& directory : directories)
+    {
+        if (auto contents = readFile(directory / ".luaurc"))
+        {
+            key += (directory / ".luaurc").generic_string() + '\n';
+            key += *contents;
+            key += '\n';
+        }
+    }
+
+    for (Luau::FValue<bool>* flag = Luau::FValue<bool>::list; flag; flag = flag->next)
+        key += std::string(flag->name) + (flag->value ? "=true\n" : "=false\n");
+    for (Luau::FValue<int>* flag = Luau::FValue<int>::list; flag; flag = flag->next)
+        key += std::string(flag->name) + "=" + std::to_string(flag->value) + '\n';
+
+    return key;
+}
+
 const Luau::ModulePtr WorkspaceFolder::getModule(const Luau::ModuleName& moduleName, bool forAutocomplete) const
 {
     if (FFlag::LuauSolverV2 || !forAutocomplete)
@@ -24,8 +180,8 @@ void WorkspaceFolder::openTextDocument(const lsp::DocumentUri& uri, const lsp::D
 {
     auto normalisedUri = fileResolver.normalisedUriString(uri);
 
-    fileResolver.managedFiles.emplace(
-        std::make_pair(normalisedUri, TextDocument(uri, params.textDocument.languageId, params.textDocument.version, params.textDocument.text)));
+    fileResolver.managedFiles.emplace(normalisedUri,
+        std::make_shared<TextDocument>(uri, params.textDocument.languageId, params.textDocument.version, params.textDocument.text));
 
     if (isConfigured)
     {
@@ -40,13 +196,18 @@ void WorkspaceFolder::updateTextDocument(
 {
     auto normalisedUri = fileResolver.normalisedUriString(uri);
 
-    if (!contains(fileResolver.managedFiles, normalisedUri))
+    auto it = fileResolver.managedFiles.find(normalisedUri);
+    if (it == fileResolver.managedFiles.end())
     {
         client->sendLogMessage(lsp::MessageType::Error, "Text Document not loaded locally: " + uri.toString());
         return;
     }
-    auto& textDocument = fileResolver.managedFiles.at(normalisedUri);
-    textDocument.update(params.contentChanges, params.textDocument.version);
+
+    // Snapshots of the previous version may still be held elsewhere, so the edit is applied to a copy.
+    // The copy shares all unchanged text with the previous version
+    auto textDocument = std::make_shared<TextDocument>(*it->second);
+    textDocument->update(params.contentChanges, params.textDocument.version);
+    it->second = std::move(textDocument);
 
     // Mark the module dirty for the typechecker
     auto moduleName = fileResolver.getModuleName(uri);
@@ -92,9 +253,27 @@ void WorkspaceFolder::onDidChangeWatchedFiles(const lsp::FileEvent& change)
     auto filePath = change.uri.fsPath();
     auto config = client->getConfiguration(rootUri);
 
+    // Creating or deleting a file can change whether requires resolve, and what paths canonicalise to
+    if (change.type != lsp::FileChangeType::Changed)
+        fileResolver.fileSystem->clear();
+
     platform->onDidChangeWatchedFiles(change);
 
-    if (filePath.filename() == ".luaurc")
+    if (change.type == lsp::FileChangeType::Created)
+        sourceFiles.onCreated(filePath);
+    else if (change.type == lsp::FileChangeType::Deleted)
+    {
+        sourceFiles.onDeleted(filePath);
+        if (auto moduleId = moduleNames.find(fileResolver.getModuleName(change.uri)))
+            symbolIndex.removeModule(*moduleId);
+    }
+
+    if (filePath.filename() == ".gitignore")
+    {
+        if (config.respectGitignore)
+            sourceFiles.clear();
+    }
+    else if (filePath.filename() == ".luaurc")
     {
         client->sendLogMessage(lsp::MessageType::Info, "Acknowledge config changed for workspace " + name + ", clearing configuration cache");
         fileResolver.clearConfigCache();
@@ -135,8 +314,20 @@ void WorkspaceFolder::onDidChangeWatchedFiles(const lsp::FileEvent& change)
     }
 }
 
+void WorkspaceFolder::applyIgnoreGlobs(const ClientConfiguration& config)
+{
+    if (ignoreGlobs.getPatterns() != config.ignoreGlobs)
+        ignoreGlobs = GlobMatcher(config.ignoreGlobs);
+    if (autoImportIgnoreGlobs.getPatterns() != config.completion.imports.ignoreGlobs)
+        autoImportIgnoreGlobs = GlobMatcher(config.completion.imports.ignoreGlobs);
+
+    sourceFileOptions.ignoreGlobs = ignoreGlobs;
+    sourceFileOptions.respectGitignore = config.respectGitignore;
+    sourceFileOptions.threads = config.index.threads;
+}
+
 /// Whether the file has been marked as ignored by any of the ignored lists in the configuration
-bool WorkspaceFolder::isIgnoredFile(const std::filesystem::path& path, const std::optional<ClientConfiguration>& givenConfig)
+bool WorkspaceFolder::isIgnoredFile(const std::filesystem::path& path)
 {
     // We want to test globs against a relative path to workspace, since that's what makes most sense
     auto relativeFsPath = path.lexically_relative(rootUri.fsPath());
@@ -145,19 +336,10 @@ bool WorkspaceFolder::isIgnoredFile(const std::filesystem::path& path, const std
                                                                   path.string() + " against " + rootUri.fsPath().string());
     auto relativePathString = relativeFsPath.generic_string(); // HACK: we convert to generic string so we get '/' separators
 
-    auto config = givenConfig ? *givenConfig : client->getConfiguration(rootUri);
-    std::vector<std::string> patterns = config.ignoreGlobs; // TODO: extend further?
-    for (auto& pattern : patterns)
-    {
-        if (glob::fnmatch_case(relativePathString, pattern))
-        {
-            return true;
-        }
-    }
-    return false;
+    return ignoreGlobs.matches(relativePathString); // TODO: extend further?
 }
 
-bool WorkspaceFolder::isIgnoredFileForAutoImports(const std::filesystem::path& path, const std::optional<ClientConfiguration>& givenConfig)
+bool WorkspaceFolder::isIgnoredFileForAutoImports(const std::filesystem::path& path)
 {
     // We want to test globs against a relative path to workspace, since that's what makes most sense
     auto relativeFsPath = path.lexically_relative(rootUri.fsPath());
@@ -165,26 +347,23 @@ bool WorkspaceFolder::isIgnoredFileForAutoImports(const std::filesystem::path& p
         throw JsonRpcException(lsp::ErrorCode::InternalError, "isIgnoredFileForAutoImports failed: relative path is default-constructed");
     auto relativePathString = relativeFsPath.generic_string(); // HACK: we convert to generic string so we get '/' separators
 
-    auto config = givenConfig ? *givenConfig : client->getConfiguration(rootUri);
-    std::vector<std::string> patterns = config.completion.imports.ignoreGlobs;
-    for (auto& pattern : patterns)
-    {
-        if (glob::fnmatch_case(relativePathString, pattern))
-        {
-            return true;
-        }
-    }
-    return false;
+    return autoImportIgnoreGlobs.matches(relativePathString);
+}
+
+bool WorkspaceFolder::isDefinitionFile(const std::filesystem::path& path)
+{
+    return isDefinitionFile(path, client->getConfiguration(rootUri));
 }
 
-bool WorkspaceFolder::isDefinitionFile(const std::filesystem::path& path, const std::optional<ClientConfiguration>& givenConfig)
+bool WorkspaceFolder::isDefinitionFile(const std::filesystem::path& path, const ClientConfiguration& config)
 {
-    auto config = givenConfig ? *givenConfig : client->getConfiguration(rootUri);
-    auto canonicalised = std::filesystem::weakly_canonical(path);
+    auto canonicalised = fileResolver.fileSystem->weaklyCanonical(path);
+    if (!canonicalised)
+        return false;
 
     for (auto& file : config.types.definitionFiles)
     {
-        if (std::filesystem::weakly_canonical(resolvePath(file)) == canonicalised)
+        if (fileResolver.fileSystem->weaklyCanonical(resolvePath(file)) == canonicalised)
         {
             return true;
         }
@@ -193,6 +372,25 @@ bool WorkspaceFolder::isDefinitionFile(const std::filesystem::path& path, const
     return false;
 }
 
+const std::vector<std::filesystem::path>& WorkspaceFolder::workspaceSourceFiles()
+{
+    // Without file change events, the list cannot be kept up to date, so the workspace is walked every time
+    if (!isWatchingSourceFiles())
+        sourceFiles.clear();
+
+    return sourceFiles.get(rootUri.fsPath(), sourceFileOptions,
+        [this](const std::string& error)
+        {
+            client->sendLogMessage(lsp::MessageType::Warning, "failed to find workspace files: " + error);
+        });
+}
+
+bool WorkspaceFolder::isWatchingSourceFiles() const
+{
+    return client->capabilities.workspace && client->capabilities.workspace->didChangeWatchedFiles &&
+           client->capabilities.workspace->didChangeWatchedFiles->dynamicRegistration;
+}
+
 // Runs `Frontend::check` on the module and DISCARDS THE TYPE GRAPH.
 // Uses the diagnostic type checker, so strictness and DM awareness is not enforced
 // NOTE: do NOT use this if you later retrieve a ModulePtr (via frontend.moduleResolver.getModule). Instead use `checkStrict`
@@ -230,6 +428,99 @@ void WorkspaceFolder::checkStrict(const Luau::ModuleName& moduleName, bool forAu
     frontend.check(moduleName, Luau::FrontendOptions{/* retainFullTypeGraphs: */ true, forAutocomplete, /* runLintChecks: */ false});
 }
 
+/// Moves the modules parsed by an indexing worker into the workspace frontend
+static void mergeIndexedModules(Luau::Frontend& frontend, Luau::Frontend& workerFrontend, IndexState& state)
+{
+    for (auto& [moduleName, sourceNode] : workerFrontend.sourceNodes)
+    {
+        if (frontend.sourceNodes.find(moduleName) != frontend.sourceNodes.end())
+        {
+            state.deferred.push_back(moduleName);
+            continue;
+        }
+
+        auto sourceModule = workerFrontend.sourceModules.find(moduleName);
+        if (sourceModule == workerFrontend.sourceModules.end())
+            continue;
+
+        frontend.sourceNodes[moduleName] = std::move(sourceNode);
+        frontend.sourceModules[moduleName] = std::move(sourceModule->second);
+        if (auto requireTrace = workerFrontend.requireTrace.find(moduleName); requireTrace != workerFrontend.requireTrace.end())
+            frontend.requireTrace[moduleName] = std::move(requireTrace->second);
+
+        state.merged.push_back(moduleName);
+    }
+
+    workerFrontend.clear();
+}
+
+/// Adds the source node of a module restored from the index cache. A new source node is marked dirty, so its source module is parsed
+/// the first time it is needed
+static void restoreIndexedModule(
+    Luau::Frontend& frontend, const WorkspaceFileResolver& fileResolver, const Luau::ModuleName& moduleName, const IndexedModule& summary)
+{
+    if (frontend.sourceNodes.find(moduleName) != frontend.sourceNodes.end())
+        return;
+
+    auto sourceNode = std::make_shared<Luau::SourceNode>();
+    sourceNode->name = moduleName;
+    sourceNode->humanReadableName = fileResolver.getHumanReadableModuleName(moduleName);
+    for (const auto& [dependency, location] : summary.requireLocations)
+    {
+        sourceNode->requireSet.insert(dependency);
+        sourceNode->requireLocations.emplace_back(dependency, location);
+    }
+
+    frontend.sourceNodes[moduleName] = std::move(sourceNode);
+}
+
+/// Whether the requires of a module restored from the index cache are the same as they would be if it was parsed. How a string require
+/// resolves depends on more than the module's own source (e.g. `./foo` resolves to `foo/init.luau` once `foo.luau` is moved there),
+/// so each is resolved again. A module requiring a file which no longer exists is parsed again rather than trusted
+static bool requiresStillResolve(LSPPlatform& platform, FileSystemCache& fileSystem, const Luau::ModuleName& moduleName, const IndexedModule& summary)
+{
+    Luau::ModuleInfo context{moduleName};
+    for (const auto& [requiredString, resolvedName] : summary.stringRequires)
+    {
+        auto resolved = platform.resolveStringRequire(&context, requiredString);
+        if ((resolved ? resolved->name : "") != resolvedName)
+            return false;
+    }
+
+    for (const auto& [dependency, location] : summary.requireLocations)
+        if (auto path = platform.resolveToRealPath(dependency); path && !fileSystem.exists(*path))
+            return false;
+
+    return true;
+}
+
+/// Collects the workspace files which should be indexed, up to the configured limit
+static void collectFilesToIndex(WorkspaceFolder& workspace, IndexState& state, const std::vector<std::filesystem::path>& sourceFiles)
+{
+    const auto& config = state.config;
+    for (const auto& path : sourceFiles)
+    {
+        if (state.files.size() >= config.index.maxFiles)
+        {
+            workspace.client->sendWindowMessage(lsp::MessageType::Warning,
+                "The maximum workspace index limit (" + std::to_string(config.index.maxFiles) +
+                    ") has been hit. This may cause some language features to only work partially "
+                    "(Find All References, Rename). If necessary, consider increasing the limit");
+            break;
+        }
+
+        try
+        {
+            if (!workspace.isDefinitionFile(path, config) && !workspace.isIgnoredFile(path))
+                state.files.push_back(Uri::file(path));
+        }
+        catch (const std::filesystem::filesystem_error& e)
+        {
+            workspace.client->sendLogMessage(lsp::MessageType::Warning, std::string("failed to index file: ") + e.what());
+        }
+    }
+}
+
 void WorkspaceFolder::indexFiles(const ClientConfiguration& config)
 {
     LUAU_TIMETRACE_SCOPE("WorkspaceFolder::indexFiles", "LSP");
@@ -241,44 +532,191 @@ void WorkspaceFolder::indexFiles(const ClientConfiguration& config)
 
     client->sendTrace("workspace: indexing all files");
 
-    size_t indexCount = 0;
+    // Indexing runs in the background, so that interactive requests are not held up by it. The workspace files are found first,
+    // and then modules are parsed in batches, with reading and parsing within a batch spread across the thread pool
+    auto progressToken = client->createWorkDoneProgress();
+    if (progressToken)
+        client->sendProgress({*progressToken, lsp::WorkDoneProgressBegin{"begin", "Indexing", false, "Finding files", std::nullopt}});
 
-    for (std::filesystem::recursive_directory_iterator next(rootUri.fsPath(), std::filesystem::directory_options::skip_permission_denied), end;
-        next != end; ++next)
-    {
-        if (indexCount >= config.index.maxFiles)
-        {
-            client->sendWindowMessage(lsp::MessageType::Warning, "The maximum workspace index limit (" + std::to_string(config.index.maxFiles) +
-                                                                     ") has been hit. This may cause some language features to only work partially "
-                                                                     "(Find All References, Rename). If necessary, consider increasing the limit");
-            break;
-        }
+    auto state = std::make_shared<IndexState>(config, progressToken);
 
-        try
+    for (size_t i = 0; i < state->pool.size(); i++)
+        state->workers.push_back(std::make_unique<IndexWorker>(fileResolver));
+
+    runInBackground("index",
+        [this, state]()
         {
-            if (next->is_regular_file() && next->path().has_extension() && !isDefinitionFile(next->path(), config) &&
-                !isIgnoredFile(next->path(), config))
+            if (state->findingFiles)
             {
-                auto ext = next->path().extension();
-                if (ext == ".lua" || ext == ".luau")
+                // The workspace is walked a few directories per step, so that a large workspace does not hold up interactive requests
+                auto root = rootUri.fsPath();
+                const auto& options = sourceFileOptions;
+                if (!state->walk && (!isWatchingSourceFiles() || !sourceFiles.isPopulated(root, options)))
+                    state->walk = std::make_unique<SourceFileWalk>(root, options);
+
+                if (state->walk)
                 {
-                    auto moduleName = fileResolver.getModuleName(Uri::file(next->path()));
+                    bool walking = state->walk->step(state->pool, kIndexWalkDirectoriesPerStep,
+                        [this](const std::string& error)
+                        {
+                            client->sendLogMessage(lsp::MessageType::Warning, "failed to find workspace files: " + error);
+                        });
+
+                    if (walking)
+                    {
+                        state->reportProgress("Found " + std::to_string(state->walk->fileCount()) + " files");
+                        return true;
+                    }
+
+                    sourceFiles.set(root, options, state->walk->takeFiles());
+                    state->walk = nullptr;
+                }
 
-                    // Parse the module to infer require data
-                    // We do not perform any type checking here
-                    frontend.parse(moduleName);
+                collectFilesToIndex(*this, *state, sourceFiles.get(root, options));
+                state->findingFiles = false;
+                state->reportProgress("Found " + std::to_string(state->files.size()) + " files", 0);
 
-                    indexCount += 1;
+                // Modules which have not changed since the index was last saved are restored from it rather than parsed
+                if (state->config.index.cache)
+                {
+                    state->cachePath = IndexCache::pathForWorkspace(rootUri.fsPath());
+                    state->cacheKey = indexCacheKey(*platform, state->config, state->files, rootUri.fsPath());
+                    if (state->cachePath)
+                        state->cache = IndexCache::load(*state->cachePath, state->cacheKey);
                 }
             }
-        }
-        catch (const std::filesystem::filesystem_error& e)
-        {
-            client->sendLogMessage(lsp::MessageType::Warning, std::string("failed to index file: ") + e.what());
-        }
+
+            if (state->next < state->files.size())
+            {
+                size_t batchStart = state->next;
+                size_t batchSize = std::min(state->files.size() - batchStart, state->pool.size() * kIndexBatchSizePerThread);
+                state->next += batchSize;
+
+                // Parse the modules to infer require data
+                // We do not perform any type checking here
+                std::vector<IndexResult> results(batchSize);
+                state->pool.parallelFor(batchSize,
+                    [this, &state, &results, batchStart](size_t index, size_t workerIndex)
+                    {
+                        auto& worker = *state->workers[workerIndex];
+                        auto& result = results[index];
+                        result.moduleName = fileResolver.getModuleName(state->files[batchStart + index]);
+
+                        uint64_t contentHash = 0;
+                        if (state->cachePath)
+                        {
+                            worker.source = fileResolver.readSource(result.moduleName);
+                            if (!worker.source)
+                                return;
+
+                            contentHash = hashIndexContent(worker.source->source);
+                            if ((result.summary = state->cache.find(result.moduleName, contentHash)))
+                            {
+                                if (requiresStillResolve(*platform, *fileResolver.fileSystem, result.moduleName, *result.summary))
+                                {
+                                    result.restored = true;
+                                    worker.source = std::nullopt;
+                                    return;
+                                }
+                                result.summary = std::nullopt;
+                            }
+                        }
+
+                        worker.indexing = result.moduleName;
+                        worker.frontend.parse(result.moduleName);
+                        worker.indexing = std::nullopt;
+                        worker.source = std::nullopt;
+
+                        // The summary is always computed, even without a cache to save it to, as it seeds the symbol index
+                        auto sourceNode = worker.frontend.sourceNodes.find(result.moduleName);
+                        auto sourceModule = worker.frontend.sourceModules.find(result.moduleName);
+                        if (sourceNode != worker.frontend.sourceNodes.end() && sourceModule != worker.frontend.sourceModules.end())
+                            result.summary = indexModule(*sourceNode->second, *sourceModule->second, contentHash, *platform);
+                    });
+
+                for (auto& worker : state->workers)
+                    mergeIndexedModules(frontend, worker->frontend, *state);
+
+                for (auto& result : results)
+                {
+                    if (!result.summary)
+                        continue;
+
+                    if (result.restored)
+                    {
+                        restoreIndexedModule(frontend, fileResolver, result.moduleName, *result.summary);
+                        state->merged.push_back(result.moduleName);
+                        state->restoredCount++;
+                    }
+                    symbolIndex.setModule(moduleNames.intern(result.moduleName), result.summary->symbols);
+                    state->summaries[result.moduleName] = std::move(*result.summary);
+                }
+
+                state->reportProgress(std::to_string(state->next) + "/" + std::to_string(state->files.size()) + " files",
+                    static_cast<unsigned int>(state->next * 100 / state->files.size()));
+                return true;
+            }
+
+            // Modules which were loaded by the frontend whilst indexing are left to it to bring up to date, as are dependencies which
+            // are not indexed themselves (such as those in ignored directories)
+            for (const auto& moduleName : state->deferred)
+                frontend.parse(moduleName);
+
+            for (const auto& moduleName : state->merged)
+            {
+                auto it = frontend.sourceNodes.find(moduleName);
+                if (it == frontend.sourceNodes.end())
+                    continue;
+
+                for (const auto& dependency : it->second->requireSet)
+                    if (frontend.sourceNodes.find(dependency) == frontend.sourceNodes.end())
+                        frontend.parse(dependency);
+            }
+
+            if (state->cachePath)
+            {
+                client->sendTrace("workspace: restored " + std::to_string(state->restoredCount) + " of " + std::to_string(state->files.size()) +
+                                  " files from the index cache");
+
+                // Nothing needs to be written if every module was restored, and no modules were removed since the cache was saved
+                if (state->restoredCount != state->summaries.size() || state->summaries.size() != state->cache.size())
+                    if (!IndexCache::save(*state->cachePath, state->cacheKey, state->summaries))
+                        client->sendLogMessage(lsp::MessageType::Warning, "failed to write index cache to " + state->cachePath->string());
+            }
+
+            state->endProgress("Indexed " + std::to_string(state->files.size()) + " files");
+            client->sendTrace("workspace: indexing all files COMPLETED");
+            return false;
+        });
+}
+
+void WorkspaceFolder::finishIndexing(const LSPCancellationToken& cancellationToken)
+{
+    // Without a scheduler, indexing has already run to completion
+    if (!scheduler)
+        return;
+
+    auto key = backgroundTaskPrefix() + "index";
+    while (scheduler->runStep(key))
+        throwIfCancelled(cancellationToken);
+}
+
+void WorkspaceFolder::runInBackground(const std::string& kind, BackgroundTask task)
+{
+    if (!scheduler)
+    {
+        bool remaining = true;
+        while (remaining)
+            remaining = task();
+        return;
     }
 
-    client->sendTrace("workspace: indexing all files COMPLETED");
+    scheduler->schedule(backgroundTaskPrefix() + kind, std::move(task));
+}
+
+std::string WorkspaceFolder::backgroundTaskPrefix() const
+{
+    return rootUri.toString() + "|";
 }
 
 void WorkspaceFolder::registerTypes()
@@ -374,6 +812,10 @@ void WorkspaceFolder::setupWithConfiguration(const ClientConfiguration& configur
     client->sendTrace("workspace: apply platform-specific configuration");
 
     platform->setupWithConfiguration(configuration);
+    applyIgnoreGlobs(configuration);
+
+    // Cached lookups are only invalidated by file change events, so without them a require would never see a file created later
+    fileResolver.fileSystem->setCaching(isWatchingSourceFiles());
 
     if (configuration.index.enabled)
         indexFiles(configuration);
@@ -38,37 +38,55 @@ const TextDocument* WorkspaceFileResolver::getTextDocument(const lsp::DocumentUr
 {
     auto it = managedFiles.find(normalisedUriString(uri));
     if (it != managedFiles.end())
-        return &it->second;
+        return it->second.get();
 
     return nullptr;
 }
 
 const TextDocument* WorkspaceFileResolver::getTextDocumentFromModuleName(const Luau::ModuleName& name) const
+{
+    return getTextDocumentSnapshotFromModuleName(name).get();
+}
+
+TextDocumentSnapshot WorkspaceFileResolver::getTextDocumentSnapshot(const lsp::DocumentUri& uri) const
+{
+    auto it = managedFiles.find(normalisedUriString(uri));
+    if (it != managedFiles.end())
+        return it->second;
+
+    return nullptr;
+}
+
+TextDocumentSnapshot WorkspaceFileResolver::getTextDocumentSnapshotFromModuleName(const Luau::ModuleName& name) const
 {
     // Handle untitled: files
     if (Luau::startsWith(name, "untitled:"))
-        return getTextDocument(Uri::parse(name));
+        return getTextDocumentSnapshot(Uri::parse(name));
 
     if (auto filePath = platform->resolveToRealPath(name))
-        return getTextDocument(Uri::file(*filePath));
+        return getTextDocumentSnapshot(Uri::file(*filePath));
 
     return nullptr;
 }
 
 TextDocumentPtr WorkspaceFileResolver::getOrCreateTextDocumentFromModuleName(const Luau::ModuleName& name)
 {
-    if (auto document = getTextDocumentFromModuleName(name))
-        return TextDocumentPtr(document);
+    if (auto document = getTextDocumentSnapshotFromModuleName(name))
+        return TextDocumentPtr(std::move(document));
 
+    // The source is read directly rather than through readSource, as creating a document does not mean the module is being re-parsed
     if (auto filePath = platform->resolveToRealPath(name))
-        if (auto source = readSource(name))
-            return TextDocumentPtr(Uri::file(*filePath), "luau", source->source);
+        if (auto source = platform->readSourceCode(name, *filePath))
+            return TextDocumentPtr(Uri::file(*filePath), "luau", *source);
 
     return TextDocumentPtr(nullptr);
 }
 
 std::optional<Luau::SourceCode> WorkspaceFileResolver::readSource(const Luau::ModuleName& name)
 {
+    if (onReadSource)
+        onReadSource(name);
+
     Luau::SourceCode::Type sourceType = Luau::SourceCode::Type::None;
 
     std::filesystem::path realFileName = name;
@@ -87,7 +105,7 @@ std::optional<Luau::SourceCode> WorkspaceFileResolver::readSource(const Luau::Mo
     }
 
     if (auto source = platform->readSourceCode(name, realFileName))
-        return Luau::SourceCode{*source, sourceType};
+        return Luau::SourceCode{std::move(*source), sourceType};
 
     return std::nullopt;
 }
@@ -127,9 +145,12 @@ const Luau::Config& WorkspaceFileResolver::getConfig(const Luau::ModuleName& nam
 
 const Luau::Config& WorkspaceFileResolver::readConfigRec(const std::filesystem::path& path) const
 {
-    auto it = configCache.find(path.generic_string());
-    if (it != configCache.end())
-        return it->second;
+    {
+        std::lock_guard lock(*configCacheMutex);
+        auto it = configCache.find(path.generic_string());
+        if (it != configCache.end())
+            return it->second;
+    }
 
     Luau::Config result = (path.has_relative_path() && path.has_parent_path()) ? readConfigRec(path.parent_path()) : defaultConfig;
     auto configPath = path / Luau::kConfigName;
@@ -160,10 +181,13 @@ const Luau::Config& WorkspaceFileResolver::readConfigRec(const std::filesystem::
         }
     }
 
-    return configCache[path.generic_string()] = result;
+    // Another thread may have read the same config in the meantime, in which case its entry is kept since it may already be referenced
+    std::lock_guard lock(*configCacheMutex);
+    return configCache.try_emplace(path.generic_string(), std::move(result)).first->second;
 }
 
 void WorkspaceFileResolver::clearConfigCache()
 {
+    std::lock_guard lock(*configCacheMutex);
     configCache.clear();
 }
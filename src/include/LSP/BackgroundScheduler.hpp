@@ -0,0 +1,44 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <string>
+
+/// A resumable unit of background work. Each call performs a single step (e.g. checking one module),
+/// and returns whether there is more work remaining
+using BackgroundTask = std::function<bool()>;
+
+/// Runs background work (workspace diagnostics, dependent re-checks, indexing) on the main thread in small steps,
+/// so that interactive requests can be handled in between modules rather than waiting for the whole batch.
+/// Not thread-safe: tasks are scheduled and stepped from the main loop only
+class BackgroundScheduler
+{
+private:
+    struct Entry
+    {
+        std::string key;
+        BackgroundTask step;
+    };
+    std::deque<Entry> tasks;
+
+public:
+    /// Schedules a task to be stepped when there are no interactive messages to handle.
+    /// If a task with the same key is already pending, it is replaced in place, as its work has been made redundant
+    void schedule(const std::string& key, BackgroundTask task);
+
+    /// Removes all pending tasks whose key begins with the given prefix
+    void cancel(const std::string& keyPrefix);
+
+    bool empty() const;
+    size_t size() const;
+
+    /// Runs a single step of the next task. Tasks with remaining work are moved to the back of the queue,
+    /// so that multiple tasks progress in turn. If the step throws, the task is dropped and the exception propagated
+    void runStep();
+
+    /// Runs a single step of the task with the given key, if one is pending, leaving its place in the queue unchanged.
+    /// Used to bring forward work which a request depends on. Returns whether the task has work remaining
+    bool runStep(const std::string& key);
+
+    /// Runs all pending tasks to completion
+    void runAll();
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+/// A map holding at most `capacity` entries, evicting the least recently used entry once full.
+/// Used to memoise conversions which are repeated for the same inputs, such as normalising file paths.
+/// All methods are safe to call concurrently
+template<typename K, typename V>
+class BoundedCache
+{
+    using Entry = std::pair<K, V>;
+
+    mutable std::mutex mutex;
+    size_t capacity;
+    /// Most recently used first
+    mutable std::list<Entry> entries;
+    std::unordered_map<K, typename std::list<Entry>::iterator> index;
+
+public:
+    explicit BoundedCache(size_t capacity)
+        : capacity(capacity)
+    {
+    }
+
+    std::optional<V> get(const K& key) const
+    {
+        std::lock_guard lock(mutex);
+        auto it = index.find(key);
+        if (it == index.end())
+            return std::nullopt;
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->second;
+    }
+
+    void put(const K& key, V value)
+    {
+        std::lock_guard lock(mutex);
+        if (auto it = index.find(key); it != index.end())
+        {
+            it->second->second = std::move(value);
+            entries.splice(entries.begin(), entries, it->second);
+            return;
+        }
+
+        if (capacity == 0)
+            return;
+
+        if (entries.size() >= capacity)
+        {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+
+        entries.emplace_front(key, std::move(value));
+        index.emplace(key, entries.begin());
+    }
+
+    void clear()
+    {
+        std::lock_guard lock(mutex);
+        entries.clear();
+        index.clear();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard lock(mutex);
+        return entries.size();
+    }
+};
@@ -5,9 +5,12 @@
 #include "Protocol/ClientCapabilities.hpp"
 #include "Protocol/Structures.hpp"
 #include "Protocol/Diagnostics.hpp"
+#include "Protocol/Completion.hpp"
+#include "Protocol/SemanticTokens.hpp"
 #include "Protocol/Window.hpp"
 #include "Protocol/Workspace.hpp"
 #include "LSP/JsonRpc.hpp"
+#include "LSP/OutputWriter.hpp"
 #include "LSP/ClientConfiguration.hpp"
 
 using namespace json_rpc;
@@ -41,6 +44,10 @@ public:
 
     ConfigChangedCallback configChangedCallback;
 
+    /// Counts the bytes of all messages sent by this thread whilst it is set.
+    /// Set by the dispatcher so that output is attributed to the method being handled
+    static thread_local OutputWriter::ByteCounter bytesOutCounter;
+
     // A partial result token for workspace diagnostics
     // If this is present, we can stream results
     std::optional<id_type> workspaceDiagnosticsRequestId = std::nullopt;
@@ -49,12 +56,18 @@ public:
 private:
     /// The request id for the next request
     int nextRequestId = 0;
+    /// Distinguishes the tokens of work done progress created by the server
+    int nextProgressToken = 0;
     std::unordered_map<id_type, ResponseHandler> responseHandler{};
 
 public:
     void sendRequest(const id_type& id, const std::string& method, const std::optional<json>& params,
         const std::optional<ResponseHandler>& handler = std::nullopt);
     static void sendResponse(const id_type& id, const json& result);
+    // Large results which are streamed directly into the output, without building a json DOM
+    static void sendResponse(const id_type& id, lsp::SemanticTokens result);
+    static void sendResponse(const id_type& id, std::vector<lsp::CompletionItem> result);
+    static void sendResponse(const id_type& id, lsp::WorkspaceDiagnosticReport result);
     static void sendError(const std::optional<id_type>& id, const JsonRpcException& e);
     static void sendNotification(const std::string& method, const std::optional<json>& params);
 
@@ -63,6 +76,10 @@ public:
         sendNotification("$/progress", params);
     }
 
+    /// Asks the client to create a work done progress, returning the token to report it with.
+    /// Returns std::nullopt if the client does not support progress initiated by the server
+    std::optional<lsp::ProgressToken> createWorkDoneProgress();
+
     static void sendLogMessage(const lsp::MessageType& type, const std::string& message);
     void sendTrace(const std::string& message, const std::optional<std::string>& verbose = std::nullopt) const;
     static void sendWindowMessage(const lsp::MessageType& type, const std::string& message);
@@ -87,5 +104,13 @@ public:
     void handleResponse(const JsonRpcMessage& message);
 
 private:
-    static void sendRawMessage(const json& message);
+    /// Queues a message to be written to stdout by the output writer thread
+    static void sendRawMessage(json message);
+
+public:
+    /// Blocks until all queued messages have been written to stdout
+    static void flushOutput();
+    /// Discards all outgoing messages instead of writing them to stdout, e.g. when replaying a recorded session.
+    /// Must be called before any message is sent
+    static void discardOutput();
 };
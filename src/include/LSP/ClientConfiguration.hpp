@@ -163,9 +163,13 @@ struct ClientIndexConfiguration
     bool enabled = true;
     /// The maximum amount of files that can be indexed
     size_t maxFiles = 10000;
+    /// The number of threads used to read and parse files whilst indexing. If 0, one thread per CPU core is used
+    size_t threads = 0;
+    /// Whether the index should be saved to disk, so that files which have not changed do not need to be parsed again on startup
+    bool cache = true;
 };
 
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(ClientIndexConfiguration, enabled, maxFiles);
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(ClientIndexConfiguration, enabled, maxFiles, threads, cache);
 
 struct ClientFFlagsConfiguration
 {
@@ -217,6 +221,8 @@ struct ClientConfiguration
     /// DEPRECATED: Use completion.autocompleteEnd instead
     bool autocompleteEnd = false;
     std::vector<std::string> ignoreGlobs{};
+    /// Whether files ignored by `.gitignore` files should be excluded from indexing and workspace diagnostics
+    bool respectGitignore = false;
     ClientPlatformConfiguration platform{};
     ClientRobloxSourcemapConfiguration sourcemap{};
     ClientDiagnosticsConfiguration diagnostics{};
@@ -230,5 +236,5 @@ struct ClientConfiguration
     ClientFFlagsConfiguration fflags{};
     ClientBytecodeConfiguration bytecode{};
 };
-NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(ClientConfiguration, autocompleteEnd, ignoreGlobs, platform, sourcemap, diagnostics, types,
-    inlayHints, hover, completion, signatureHelp, require, index, fflags, bytecode);
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE_WITH_DEFAULT(ClientConfiguration, autocompleteEnd, ignoreGlobs, respectGitignore, platform, sourcemap,
+    diagnostics, types, inlayHints, hover, completion, signatureHelp, require, index, fflags, bytecode);
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "LSP/Interner.hpp"
+
+/// The require graph of a workspace over interned module ids, holding the edges in both directions so that the dependents of a
+/// module can be found without scanning every module.
+///
+/// Modules whose requires may have changed (i.e. which have been re-parsed) are invalidated, and their edges are replaced the next
+/// time the graph is synced, so keeping it up to date costs time in the number of edges changed rather than the size of the workspace
+class DependencyGraph
+{
+    std::vector<std::vector<InternedId>> dependencies;
+    std::vector<std::vector<InternedId>> dependents;
+
+    std::mutex staleMutex;
+    /// A module is invalidated on every parse, so it is only recorded once however often it is parsed between syncs
+    std::unordered_set<InternedId> stale;
+    bool populated = false;
+
+    /// Stamped with the current generation when a module is visited, so the visited set is reset without clearing it
+    std::vector<uint32_t> visited;
+    uint32_t generation = 0;
+
+    void grow(InternedId module);
+
+public:
+    /// Whether the graph has been built since it was created or last cleared. Until then, it needs to be built from every module
+    bool isPopulated() const
+    {
+        return populated;
+    }
+
+    void markPopulated()
+    {
+        populated = true;
+    }
+
+    /// Replaces the modules required by a module
+    void setDependencies(InternedId module, std::vector<InternedId> moduleDependencies);
+
+    /// Records that the requires of the module may have changed. Safe to call from any thread
+    void invalidate(InternedId module);
+    /// Returns the modules invalidated since the last call, in id order, which need their dependencies set again
+    std::vector<InternedId> takeStale();
+
+    /// Removes every module, so that the graph needs to be built again
+    void clear();
+
+    const std::vector<InternedId>& directDependencies(InternedId module) const;
+    const std::vector<InternedId>& directDependents(InternedId module) const;
+
+    /// The module followed by every module which depends on it, directly or transitively
+    std::vector<InternedId> transitiveDependents(InternedId module);
+};
@@ -0,0 +1,43 @@
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "LSP/BoundedCache.hpp"
+
+/// Caches the file system lookups made when resolving requires: whether a path exists, whether it is a directory, and its canonical form.
+/// A workspace resolves the same few paths for every require edge on every parse, so without a cache this costs several syscalls per edge.
+///
+/// The file system is assumed not to change between calls to `clear()`, which is called whenever a watched file is created or deleted.
+/// When the client does not report file changes, caching is turned off and every lookup goes to the disk.
+/// All methods are safe to call concurrently
+class FileSystemCache
+{
+    BoundedCache<std::string, std::filesystem::file_type> types;
+    BoundedCache<std::string, std::optional<std::filesystem::path>> canonicalPaths;
+    std::atomic<bool> caching{true};
+
+    std::filesystem::file_type type(const std::filesystem::path& path);
+
+public:
+    explicit FileSystemCache(size_t capacity = 65536)
+        : types(capacity)
+        , canonicalPaths(capacity)
+    {
+    }
+
+    /// As std::filesystem::exists, returning false on error
+    bool exists(const std::filesystem::path& path);
+
+    /// As std::filesystem::is_directory, returning false on error
+    bool isDirectory(const std::filesystem::path& path);
+
+    /// As std::filesystem::weakly_canonical, returning std::nullopt on error
+    std::optional<std::filesystem::path> weaklyCanonical(const std::filesystem::path& path);
+
+    void clear();
+
+    /// Turns caching on or off. Turning it off clears the cache
+    void setCaching(bool enabled);
+};
@@ -0,0 +1,125 @@
+#pragma once
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LSP/GlobMatcher.hpp"
+
+/// The rules of the `.gitignore` files which apply within a directory: its own, followed by those inherited from its parents.
+///
+/// Supports comments, negation (`!`), directory-only rules (trailing `/`) and rules anchored to the `.gitignore` (containing a `/`).
+/// As with `GlobMatcher`, `*` may also match across directories, so rules can ignore slightly more than git itself would
+class GitignoreRules
+{
+    struct Rule
+    {
+        GlobMatcher matcher;
+        bool negated = false;
+        bool directoryOnly = false;
+        /// Matched against the path relative to the `.gitignore`, rather than just the name of the entry
+        bool anchored = false;
+    };
+
+    std::shared_ptr<const GitignoreRules> parent;
+    /// The directory containing the `.gitignore`, relative to the root of the walk with '/' separators. Empty for the root itself
+    std::string base;
+    std::vector<Rule> rules;
+
+public:
+    GitignoreRules(std::shared_ptr<const GitignoreRules> parent, std::string base, std::string_view contents);
+
+    /// Whether the entry at the path (relative to the root of the walk, with '/' separators) is ignored
+    bool isIgnored(std::string_view relativePath, bool isDirectory) const;
+};
+
+struct FileWalkerOptions
+{
+    /// Directories which these globs match everything under are not walked
+    GlobMatcher ignoreGlobs;
+    /// The directory the globs are relative to. If empty, the root of the walk is used
+    std::filesystem::path ignoreGlobsRoot;
+    /// Whether to skip files and directories ignored by `.gitignore` files found during the walk
+    bool respectGitignore = false;
+    /// The number of threads to walk with. If 0, one thread per CPU core is used
+    size_t threads = 0;
+};
+
+/// Whether the path has a Luau source file extension (`.lua` or `.luau`)
+bool isSourceFile(const std::filesystem::path& path);
+
+class ThreadPool;
+
+/// A walk for the Luau source files under a root which is advanced a batch of directories at a time, so that walking a large
+/// workspace can be interleaved with other work. Directories are walked breadth first
+class SourceFileWalk
+{
+public:
+    struct PendingDirectory
+    {
+        std::filesystem::path path;
+        /// Relative to the root of the walk, with '/' separators
+        std::string relativePath;
+        std::shared_ptr<const GitignoreRules> gitignore;
+    };
+
+private:
+    FileWalkerOptions options;
+    std::vector<PendingDirectory> pending;
+    std::vector<std::filesystem::path> files;
+
+public:
+    SourceFileWalk(const std::filesystem::path& root, FileWalkerOptions options);
+
+    /// Walks up to `maxDirectories` of the directories found so far, spread across the pool. Returns whether there is more to walk.
+    /// Errors visiting entries are passed to `onError` on the calling thread, and the walk continues past them
+    bool step(ThreadPool& pool, size_t maxDirectories, const std::function<void(const std::string&)>& onError = nullptr);
+
+    bool isDone() const
+    {
+        return pending.empty();
+    }
+
+    /// The number of source files found so far
+    size_t fileCount() const
+    {
+        return files.size();
+    }
+
+    /// The files found, sorted. Only complete once the walk is done
+    std::vector<std::filesystem::path> takeFiles();
+};
+
+/// Finds every Luau source file under the root, walking directories in parallel. The result is sorted.
+/// Errors visiting entries are passed to `onError` on the calling thread, and the walk continues past them
+std::vector<std::filesystem::path> findSourceFiles(const std::filesystem::path& root, const FileWalkerOptions& options,
+    const std::function<void(const std::string&)>& onError = nullptr);
+
+/// The source files of a workspace, walked once and then kept up to date from file change events, so the disk need not be walked again
+class WorkspaceFiles
+{
+    std::filesystem::path root;
+    FileWalkerOptions options;
+    bool populated = false;
+    std::vector<std::filesystem::path> files;
+
+public:
+    /// The source files under the root, walking it if they are not yet known or were found with different options
+    const std::vector<std::filesystem::path>& get(const std::filesystem::path& root, const FileWalkerOptions& options,
+        const std::function<void(const std::string&)>& onError = nullptr);
+
+    /// Whether the files under the root are known for the options, so that `get` will not need to walk
+    bool isPopulated(const std::filesystem::path& root, const FileWalkerOptions& options) const;
+    /// Records the files found by a walk of the root with the options done elsewhere, such as by a `SourceFileWalk`
+    void set(const std::filesystem::path& root, const FileWalkerOptions& options, std::vector<std::filesystem::path> walkedFiles);
+
+    /// Forgets the files, so that the next call to `get` walks the workspace again
+    void clear();
+
+    /// Records that a file or directory was created
+    void onCreated(const std::filesystem::path& path);
+    /// Records that a file or directory was deleted, along with everything inside it
+    void onDeleted(const std::filesystem::path& path);
+};
@@ -0,0 +1,73 @@
+#pragma once
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// A set of glob patterns compiled into a single automaton, which tests a path against all of them in one pass.
+/// Patterns have the same semantics as `glob::fnmatch_case`: `*` matches any run of characters (including `/`),
+/// `?` matches any single character, `[...]` is a character class and everything else matches literally.
+///
+/// Each pattern's literal prefix, literal suffix and longest literal run are checked before running the automaton,
+/// so most paths are rejected with a few string comparisons
+class GlobMatcher
+{
+    enum class TokenKind : uint8_t
+    {
+        Literal,
+        Any,
+        Star,
+        Class,
+        Accept,
+    };
+
+    struct Token
+    {
+        TokenKind kind = TokenKind::Literal;
+        char literal = 0;
+        uint32_t classIndex = 0;
+        /// Whether this token and every token after it in the pattern is a `*`, so any remaining text is accepted
+        bool acceptsAnything = false;
+    };
+
+    struct Pattern
+    {
+        uint32_t start = 0;
+        /// Literal text which every match must start with, end with and contain respectively
+        std::string prefix;
+        std::string suffix;
+        std::string required;
+    };
+
+    std::vector<std::string> sources;
+    std::vector<Token> tokens;
+    std::vector<std::bitset<256>> classes;
+    std::vector<Pattern> patterns;
+
+    void compile(const std::string& pattern);
+    /// Runs the automaton over the text from the start of the given patterns. Returns the states reached, which is empty if none are live
+    const std::vector<uint32_t>& run(std::string_view text, const std::vector<uint32_t>& startPatterns) const;
+
+public:
+    GlobMatcher() = default;
+    explicit GlobMatcher(std::vector<std::string> patterns);
+
+    /// The patterns this matcher was compiled from
+    const std::vector<std::string>& getPatterns() const
+    {
+        return sources;
+    }
+
+    bool empty() const
+    {
+        return patterns.empty();
+    }
+
+    /// Whether any pattern matches the whole path
+    bool matches(std::string_view path) const;
+
+    /// Whether any pattern matches every path inside the directory, i.e. `directory/<anything>`.
+    /// When true, a traversal can skip the directory entirely
+    bool matchesEverythingUnder(std::string_view directory) const;
+};
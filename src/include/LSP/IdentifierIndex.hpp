@@ -0,0 +1,39 @@
+#pragma once
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "LSP/Interner.hpp"
+
+/// The names (identifiers, indexed properties, type names and string constants) mentioned in each module, over module ids from the
+/// workspace's interner. Searches for references to a name use it to skip modules which never mention the name, without type checking them.
+///
+/// Modules are invalidated when they are parsed again, and their entry is dropped the next time stale entries are, to be rebuilt on demand
+class IdentifierIndex
+{
+    StringInterner names;
+    /// The sorted ids of the names mentioned by each module, indexed by module id. Empty if the module has not been indexed
+    std::vector<std::optional<std::vector<InternedId>>> modules;
+
+    std::mutex staleMutex;
+    /// Recorded once per module however often it is parsed, as entries are only dropped when a search next needs the index
+    std::unordered_set<InternedId> stale;
+
+public:
+    /// Records the names mentioned by a module, replacing any previous entry
+    void setModule(InternedId module, const std::vector<std::string_view>& identifiers);
+
+    bool isIndexed(InternedId module) const;
+
+    /// Whether the indexed module mentions the name
+    bool mentions(InternedId module, std::string_view name) const;
+
+    /// Records that the module has changed. Safe to call from any thread
+    void invalidate(InternedId module);
+    /// Drops the entries of the modules invalidated since the last call
+    void dropStale();
+
+    void clear();
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Luau/Location.h"
+#include "Protocol/LanguageFeatures.hpp"
+
+/// A symbol declared in a module, as listed by workspace symbols
+struct IndexedSymbol
+{
+    std::string name;
+    lsp::SymbolKind kind = lsp::SymbolKind::Variable;
+    Luau::Location location;
+
+    bool operator==(const IndexedSymbol& other) const
+    {
+        return name == other.name && kind == other.kind && location == other.location;
+    }
+};
+
+/// What the workspace index records about a module, which is enough to restore it without parsing
+struct IndexedModule
+{
+    /// Hash of the source the entry was computed from, see `hashIndexContent`
+    uint64_t contentHash = 0;
+    /// The modules it requires, as in `Luau::SourceNode::requireLocations`
+    std::vector<std::pair<std::string, Luau::Location>> requireLocations;
+    /// Names of the types declared with `export type`
+    std::vector<std::string> exportedTypes;
+    std::vector<IndexedSymbol> symbols;
+    /// The string passed to each `require("...")`, and the module it resolved to (empty if it did not resolve). How a string resolves
+    /// depends on other files, so these are resolved again before the entry is restored
+    std::vector<std::pair<std::string, std::string>> stringRequires;
+};
+
+/// A hash of module source which is stable between runs, used to check whether a cached entry is still valid
+uint64_t hashIndexContent(std::string_view content);
+
+/// The workspace index persisted to disk, so that modules which have not changed since the last run do not need to be parsed on startup.
+///
+/// The file is a header, then fixed-size records for each module (sorted by name), require, exported type and symbol, and finally
+/// a pool of the strings they refer to. It is loaded with a single read and used in place: nothing is decoded until an entry is looked up.
+/// A cache written with a different key (e.g. by another version of the server) is discarded as a whole
+class IndexCache
+{
+    std::string data;
+    size_t moduleCount = 0;
+
+    template<typename Record>
+    Record record(size_t offset) const;
+    std::string_view moduleName(size_t index) const;
+
+public:
+    /// Bump whenever the layout or the meaning of the stored data changes
+    static constexpr uint32_t kFormatVersion = 2;
+
+    /// Returns an empty cache if the file does not exist, is corrupt, or was written with a different key
+    static IndexCache load(const std::filesystem::path& path, std::string_view key);
+    /// Writes the modules to the file, replacing it atomically. Returns false if the file could not be written
+    static bool save(const std::filesystem::path& path, std::string_view key, const std::unordered_map<std::string, IndexedModule>& modules);
+
+    /// Where the index of the workspace at `root` is cached, inside the user's cache directory
+    static std::optional<std::filesystem::path> pathForWorkspace(const std::filesystem::path& root);
+
+    /// The cached entry for the module, if there is one computed from source with the given hash
+    std::optional<IndexedModule> find(std::string_view name, uint64_t contentHash) const;
+
+    size_t size() const
+    {
+        return moduleCount;
+    }
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/// A compact identifier for a string held by a `StringInterner`. Ids are only meaningful to the interner which created them
+struct InternedId
+{
+    uint32_t value = 0;
+
+    bool operator==(const InternedId& other) const
+    {
+        return value == other.value;
+    }
+
+    bool operator!=(const InternedId& other) const
+    {
+        return value != other.value;
+    }
+
+    bool operator<(const InternedId& other) const
+    {
+        return value < other.value;
+    }
+};
+
+namespace std
+{
+template<>
+struct hash<InternedId>
+{
+    size_t operator()(const InternedId& id) const noexcept
+    {
+        return hash<uint32_t>{}(id.value);
+    }
+};
+} // namespace std
+
+/// An append-only table giving each distinct string (module name, path or URI) a dense integer id, so that structures
+/// holding many references to the same strings store and compare 4-byte ids instead of copying and hashing the strings.
+/// Ids are allocated from zero in the order strings are first interned, so they can also index a vector.
+///
+/// Strings are never removed, and a reference returned by `lookup` stays valid for the lifetime of the interner.
+/// All methods are safe to call concurrently
+class StringInterner
+{
+    mutable std::shared_mutex mutex;
+    /// A deque, so that growing it never moves the strings the map keys point into
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, InternedId> ids;
+
+public:
+    StringInterner() = default;
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    /// Returns the id of the string, allocating a new one if it has not been seen before
+    InternedId intern(std::string_view string);
+
+    /// Returns the id of the string if it has already been interned
+    std::optional<InternedId> find(std::string_view string) const;
+
+    /// Returns the string for an id created by this interner
+    const std::string& lookup(InternedId id) const;
+
+    size_t size() const;
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include <exception>
+#include <memory>
+#include <string_view>
 #include <variant>
 #include <iostream>
 #include "Luau/StringUtils.h"
@@ -40,6 +42,33 @@ public:
     }
 };
 
+/// A JSON value which has not yet been parsed, referencing a span of the message body it was read from
+class RawJson
+{
+private:
+    std::shared_ptr<const std::string> source;
+    size_t offset = 0;
+    size_t length = 0;
+
+public:
+    RawJson(std::shared_ptr<const std::string> source, size_t offset, size_t length)
+        : source(std::move(source))
+        , offset(offset)
+        , length(length)
+    {
+    }
+
+    [[nodiscard]] std::string_view view() const
+    {
+        return std::string_view(*source).substr(offset, length);
+    }
+
+    [[nodiscard]] json parse() const;
+
+    /// Finds the value of a member if this is an object, without parsing any of the other members
+    [[nodiscard]] std::optional<RawJson> find(std::string_view key) const;
+};
+
 class JsonRpcMessage
 {
 public:
@@ -48,6 +77,25 @@ public:
     std::optional<json> params;
     std::optional<json> result;
     std::optional<JsonRpcException> error;
+    /// Params read from input are left unparsed until the message is handled
+    std::optional<RawJson> rawParams = std::nullopt;
+    /// The size of the message body, if it was read from input
+    size_t contentLength = 0;
+
+    [[nodiscard]] bool has_params() const
+    {
+        return this->params.has_value() || this->rawParams.has_value();
+    }
+
+    /// Returns the message params, parsing them if they have not yet been materialized
+    [[nodiscard]] std::optional<json> parseParams() const
+    {
+        if (this->params)
+            return this->params;
+        else if (this->rawParams)
+            return this->rawParams->parse();
+        return std::nullopt;
+    }
 
     [[nodiscard]] bool is_request() const
     {
@@ -65,11 +113,17 @@ public:
     }
 };
 
+/// Parses the message envelope. The params are not parsed, and instead reference the message body
+JsonRpcMessage parse(std::shared_ptr<const std::string> body);
 JsonRpcMessage parse(const std::string& jsonString);
 
 /// Reads a JSON-RPC message from input
 bool readRawMessage(std::istream& input, std::string& output);
 
+/// Appends an already serialized message body, including its headers, to the buffer
+void writeFramedBody(std::string& buffer, std::string_view body);
+/// Appends a JSON-RPC message, including its headers, to the buffer
+void writeRawMessage(std::string& buffer, const json& message);
 /// Sends a raw JSON-RPC message to output stream
 void sendRawMessage(std::ostream& output, const json& message);
 
@@ -0,0 +1,148 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+#include "nlohmann/json.hpp"
+#include "Protocol/Completion.hpp"
+#include "Protocol/Diagnostics.hpp"
+#include "Protocol/SemanticTokens.hpp"
+
+using json = nlohmann::json;
+
+/// Streams JSON directly into an output buffer, without building an intermediate json DOM.
+/// Used to serialize large results on the hot path. Any type without a dedicated writer falls back to its to_json definition.
+/// Invalid UTF-8 in strings is replaced with U+FFFD, matching how messages built as json are dumped.
+class JsonWriter
+{
+private:
+    std::string& buffer;
+    size_t depth = 0;
+    // Bit N is set once a value has been written at nesting depth N + 1, and a separator is required before the next
+    uint64_t hasValue = 0;
+    bool afterKey = false;
+
+    void separator();
+    void writeString(std::string_view str);
+
+public:
+    explicit JsonWriter(std::string& buffer)
+        : buffer(buffer)
+    {
+    }
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(std::string_view key);
+
+    void value(std::string_view str);
+    void value(const char* str)
+    {
+        value(std::string_view(str));
+    }
+    void value(const std::string& str)
+    {
+        value(std::string_view(str));
+    }
+    void value(bool b);
+    void value(int64_t number);
+    void value(uint64_t number);
+    void value(int number)
+    {
+        value(int64_t(number));
+    }
+    void value(unsigned int number)
+    {
+        value(uint64_t(number));
+    }
+    void value(std::nullptr_t);
+    /// Fallback for types without a dedicated writer
+    void value(const json& j);
+
+    template<typename T>
+    void field(std::string_view name, const T& v)
+    {
+        key(name);
+        write(*this, v);
+    }
+
+    /// Matches the behaviour of NLOHMANN_DEFINE_OPTIONAL, where missing optionals are omitted entirely
+    template<typename T>
+    void optionalField(std::string_view name, const std::optional<T>& v)
+    {
+        if (v)
+            field(name, *v);
+    }
+};
+
+// Writers for primitives, to allow them to be used in fields and arrays
+inline void write(JsonWriter& writer, const std::string& value)
+{
+    writer.value(value);
+}
+inline void write(JsonWriter& writer, const char* value)
+{
+    writer.value(value);
+}
+inline void write(JsonWriter& writer, bool value)
+{
+    writer.value(value);
+}
+inline void write(JsonWriter& writer, int value)
+{
+    writer.value(value);
+}
+inline void write(JsonWriter& writer, size_t value)
+{
+    writer.value(uint64_t(value));
+}
+inline void write(JsonWriter& writer, const json& value)
+{
+    writer.value(value);
+}
+template<typename T>
+std::enable_if_t<std::is_enum_v<T>> write(JsonWriter& writer, const T& value)
+{
+    // Enums serialized as strings use NLOHMANN_JSON_SERIALIZE_ENUM, so we go through to_json.
+    // Neither representation allocates, so avoid dumping the value
+    json j = value;
+    if (j.is_string())
+        writer.value(j.get_ref<const std::string&>());
+    else if (j.is_number_integer())
+        writer.value(j.get<int64_t>());
+    else
+        writer.value(j);
+}
+template<typename T>
+void write(JsonWriter& writer, const std::vector<T>& values)
+{
+    writer.beginArray();
+    for (const auto& value : values)
+        write(writer, value);
+    writer.endArray();
+}
+void write(JsonWriter& writer, const std::variant<std::string, int>& value);
+
+namespace lsp
+{
+void write(JsonWriter& writer, const Position& position);
+void write(JsonWriter& writer, const Range& range);
+void write(JsonWriter& writer, const TextEdit& edit);
+void write(JsonWriter& writer, const MarkupContent& content);
+void write(JsonWriter& writer, const CompletionItem& item);
+void write(JsonWriter& writer, const SemanticTokens& tokens);
+void write(JsonWriter& writer, const Diagnostic& diagnostic);
+void write(JsonWriter& writer, const WorkspaceDocumentDiagnosticReport& report);
+void write(JsonWriter& writer, const WorkspaceDiagnosticReport& report);
+
+// Fallback for the remaining protocol types
+template<typename T>
+std::enable_if_t<!std::is_enum_v<T>> write(JsonWriter& writer, const T& value)
+{
+    writer.value(json(value));
+}
+} // namespace lsp
@@ -8,12 +8,17 @@
 #include "Protocol/LanguageFeatures.hpp"
 
 #include "LSP/Client.hpp"
+#include "LSP/MessageQueue.hpp"
+#include "LSP/MethodStatistics.hpp"
+#include "LSP/SessionRecorder.hpp"
 #include "LSP/Workspace.hpp"
 
 using json = nlohmann::json;
 using namespace json_rpc;
 using WorkspaceFolderPtr = std::shared_ptr<WorkspaceFolder>;
 using ClientPtr = std::shared_ptr<Client>;
+using RequestHandler = std::function<void(const id_type& id, std::optional<json> params, const LSPCancellationToken& cancellationToken)>;
+using NotificationHandler = std::function<void(std::optional<json> params)>;
 
 #define JSON_REQUIRED_PARAMS(params, method) \
     (!(params) ? throw json_rpc::JsonRpcException(lsp::ErrorCode::InvalidParams, "params not provided for " method) : (params).value())
@@ -41,7 +46,41 @@ private:
     WorkspaceFolderPtr nullWorkspace;
     std::vector<WorkspaceFolderPtr> workspaceFolders;
 
-    std::vector<json_rpc::JsonRpcMessage> configPostponedMessages;
+    std::vector<QueuedMessage> configPostponedMessages;
+
+    // Messages read by the input thread, waiting to be dispatched
+    MessageQueue messageQueue;
+    // Long-running work which is stepped whenever there are no messages waiting to be dispatched
+    BackgroundScheduler backgroundScheduler;
+    // If set, every message read from the client is recorded
+    std::unique_ptr<SessionRecorder> recorder;
+
+    struct RegisteredRequest
+    {
+        RequestHandler handler;
+        MethodCountersPtr counters;
+    };
+    struct RegisteredNotification
+    {
+        NotificationHandler handler;
+        MethodCountersPtr counters;
+    };
+    std::unordered_map<std::string, RegisteredRequest> requestHandlers;
+    std::unordered_map<std::string, RegisteredNotification> notificationHandlers;
+
+    /// The request whose handler is running, and when it was received
+    struct ActiveRequest
+    {
+        MethodCountersPtr counters;
+        std::chrono::steady_clock::time_point start;
+        /// Set by `deferResponse`, in which case the latency is recorded once the request finishes rather than when the handler returns
+        bool deferred = false;
+    };
+    std::optional<ActiveRequest> activeRequest;
+
+    /// For a request which is finished by background steps after its handler returns. Wraps the steps so that their output is counted
+    /// against the request, and its latency is recorded from when it was received until the last step
+    BackgroundTask deferResponse(BackgroundTask step);
 
 public:
     explicit LanguageServer(ClientPtr aClient, std::optional<Luau::Config> aDefaultConfig)
@@ -49,6 +88,8 @@ public:
         , defaultConfig(std::move(aDefaultConfig))
         , nullWorkspace(std::make_shared<WorkspaceFolder>(client, "$NULL_WORKSPACE", Uri(), defaultConfig))
     {
+        nullWorkspace->scheduler = &backgroundScheduler;
+        registerHandlers();
     }
 
     lsp::ServerCapabilities getServerCapabilities();
@@ -57,15 +98,37 @@ public:
     /// If no workspace is found, the file is attached to the null workspace
     WorkspaceFolderPtr findWorkspace(const lsp::DocumentUri& file);
 
-    void onRequest(const id_type& id, const std::string& method, std::optional<json> params);
-    void onNotification(const std::string& method, std::optional<json> params);
+    void onRequest(const id_type& id, const std::string& method, std::optional<json> params,
+        const LSPCancellationToken& cancellationToken = nullptr, size_t contentLength = 0);
+    void onNotification(const std::string& method, std::optional<json> params, size_t contentLength = 0);
     void processInputLoop();
     bool requestedShutdown();
 
+    /// Records all incoming messages read by processInputLoop. Must be set before the input loop is started
+    void setRecorder(std::unique_ptr<SessionRecorder> sessionRecorder);
+    /// Handles a single message as if it had been read from the client, then runs any background work it scheduled to completion.
+    /// Used to deterministically replay a recorded session
+    void replayMessage(json_rpc::JsonRpcMessage message);
+
+    /// Call counts, latencies and bytes in/out of every handled method
+    lsp::StatsResult stats() const;
+
     // Dispatch handlers
 private:
+    void registerRequest(const std::string& method, RequestHandler handler);
+    void registerNotification(const std::string& method, NotificationHandler handler);
+    void registerHandlers();
+
     bool allWorkspacesConfigured() const;
-    void handleMessage(const json_rpc::JsonRpcMessage& msg);
+    void handleMessage(const QueuedMessage& queuedMessage);
+    void handlePostponedMessages();
+    /// Cheaply responds to a request which has been superseded by a later message, without computing a result
+    void respondSuperseded(const json_rpc::JsonRpcMessage& msg);
+    /// Reads messages from stdin and pushes them onto the message queue. Runs on a separate thread
+    void readInputLoop();
+    /// Runs a single step of pending background work
+    void runBackgroundStep();
+    WorkspaceFolderPtr createWorkspace(const std::string& name, const lsp::DocumentUri& uri);
 
     lsp::InitializeResult onInitialize(const lsp::InitializeParams& params);
     void onInitialized([[maybe_unused]] const lsp::InitializedParams& params);
@@ -87,13 +150,13 @@ private:
     std::optional<lsp::SignatureHelp> signatureHelp(const lsp::SignatureHelpParams& params);
     lsp::DefinitionResult gotoDefinition(const lsp::DefinitionParams& params);
     std::optional<lsp::Location> gotoTypeDefinition(const lsp::TypeDefinitionParams& params);
-    lsp::ReferenceResult references(const lsp::ReferenceParams& params);
+    lsp::ReferenceResult references(const lsp::ReferenceParams& params, const LSPCancellationToken& cancellationToken);
     std::optional<std::vector<lsp::DocumentSymbol>> documentSymbol(const lsp::DocumentSymbolParams& params);
-    lsp::RenameResult rename(const lsp::RenameParams& params);
+    lsp::RenameResult rename(const lsp::RenameParams& params, const LSPCancellationToken& cancellationToken);
     lsp::InlayHintResult inlayHint(const lsp::InlayHintParams& params);
     std::optional<lsp::SemanticTokens> semanticTokens(const lsp::SemanticTokensParams& params);
     lsp::DocumentDiagnosticReport documentDiagnostic(const lsp::DocumentDiagnosticParams& params);
-    lsp::PartialResponse<lsp::WorkspaceDiagnosticReport> workspaceDiagnostic(const lsp::WorkspaceDiagnosticParams& params);
+    void workspaceDiagnostic(const id_type& id, const lsp::WorkspaceDiagnosticParams& params, const LSPCancellationToken& cancellationToken);
     Response onShutdown([[maybe_unused]] const id_type& id);
 
 private:
@@ -0,0 +1,88 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include "Luau/Frontend.h"
+#include "LSP/JsonRpc.hpp"
+
+using LSPCancellationToken = std::shared_ptr<Luau::FrontendCancellationToken>;
+
+/// Throws a RequestCancelled error if the client has requested cancellation of the current request
+void throwIfCancelled(const LSPCancellationToken& cancellationToken);
+
+/// Records the state of the document at the time a per-document request was received.
+/// Used to recognise requests which have been superseded by later messages in the queue
+struct DocumentRequestStamp
+{
+    std::string key;
+    std::string uri;
+    /// The latest document version seen by the input thread when the request was received
+    size_t documentVersion = 0;
+    /// Increases with every stamped request, so a later request with the same key always has a greater generation
+    size_t generation = 0;
+};
+
+struct QueuedMessage
+{
+    json_rpc::JsonRpcMessage message;
+    /// Only present for requests. Remains cancellable for as long as a handler holds onto it
+    LSPCancellationToken cancellationToken = nullptr;
+    /// Only present for requests computing a result for a whole document
+    std::optional<DocumentRequestStamp> documentStamp = std::nullopt;
+};
+
+/// Whether the request method computes its result from a single document, and can therefore be coalesced
+/// if the document is changed, or the same request is made again, before it is handled
+bool isCoalescableRequest(const std::string& method);
+
+/// A thread-safe queue of incoming messages. The input thread pushes parsed messages onto the queue,
+/// whilst the main loop pops them off and dispatches them.
+class MessageQueue
+{
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<QueuedMessage> messages;
+    bool closed = false;
+
+    // Weak references to the tokens of all requests which are queued or in-flight
+    // Once the handler finishes with a request, the token expires and the entry is swept
+    std::unordered_map<json_rpc::id_type, std::weak_ptr<Luau::FrontendCancellationToken>> pendingRequests;
+
+    // The latest document versions read by the input thread, which may not yet have been applied
+    std::unordered_map<std::string /* DocumentUri */, size_t> documentVersions;
+    // The generation of the latest received request for each key, grouped by document so that they can be dropped once it is closed.
+    // An entry is erased once its request is dispatched, so only requests which are still queued are tracked
+    std::unordered_map<std::string /* DocumentUri */, std::unordered_map<std::string, size_t>> requestGenerations;
+    size_t nextGeneration = 0;
+
+    std::optional<DocumentRequestStamp> stampDocumentRequest(const json_rpc::JsonRpcMessage& message);
+
+public:
+    void push(json_rpc::JsonRpcMessage message);
+
+    /// Blocks until a message is available. Returns std::nullopt once the queue is closed and drained
+    std::optional<QueuedMessage> pop();
+
+    /// Pops a message if one is immediately available, without blocking
+    std::optional<QueuedMessage> tryPop();
+
+    /// Signals that no more messages will be pushed
+    void close();
+
+    /// Requests cancellation of a queued or in-flight request.
+    /// Returns false if the request is unknown, i.e. it has already been responded to
+    bool cancel(const json_rpc::id_type& id);
+
+    /// Whether the request has been made redundant by a later message: either the document has since been changed,
+    /// or the same request has been made again for the same document. Called as the request is dispatched, after which
+    /// a later request with the same key is no longer superseded by it
+    bool isSuperseded(const QueuedMessage& message);
+
+    /// The number of documents with state tracked for superseding requests
+    size_t trackedDocumentCount();
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include "Protocol/Extensions.hpp"
+
+/// A fixed-size, lock-free histogram of latencies. Buckets are logarithmic with 4 sub-buckets per power of two,
+/// so any recorded value is reported within ~12.5% of its actual value
+class LatencyHistogram
+{
+public:
+    static constexpr size_t SubBucketBits = 2;
+    static constexpr size_t BucketCount = 160;
+
+    void record(std::chrono::nanoseconds duration);
+
+    /// Returns the approximate latency at the given percentile (0-100), in microseconds
+    [[nodiscard]] uint64_t percentile(double percentile) const;
+    [[nodiscard]] uint64_t max() const
+    {
+        return maxMicroseconds.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] uint64_t count() const;
+
+    static size_t bucketFor(uint64_t microseconds);
+    /// The midpoint of the range of values stored in a bucket
+    static uint64_t valueFor(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, BucketCount> buckets{};
+    std::atomic<uint64_t> maxMicroseconds = 0;
+};
+
+/// Counters for a single request or notification method.
+/// Updated by the main loop, except for bytesOut which is updated by the output writer thread once the response is written
+struct MethodCounters
+{
+    std::atomic<uint64_t> count = 0;
+    std::atomic<uint64_t> bytesIn = 0;
+    std::atomic<uint64_t> bytesOut = 0;
+    LatencyHistogram latency;
+
+    [[nodiscard]] lsp::MethodStatistics snapshot() const;
+};
+using MethodCountersPtr = std::shared_ptr<MethodCounters>;
@@ -0,0 +1,63 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <variant>
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+/// Writes outgoing JSON-RPC messages to an output stream on a dedicated thread.
+/// Messages are serialized by the writer thread, and all messages queued whilst a write is in progress are
+/// framed into a single buffer and written together. Messages are always written in the order they were pushed.
+class OutputWriter
+{
+public:
+    /// Writes a message body directly into the buffer, for messages which are not built as json
+    using Serializer = std::function<void(std::string& body)>;
+    /// Incremented by the framed size of a message once it has been serialized
+    using ByteCounter = std::shared_ptr<std::atomic<uint64_t>>;
+
+private:
+    struct PendingMessage
+    {
+        std::variant<json, Serializer> message;
+        ByteCounter bytesWritten;
+    };
+
+    std::ostream& output;
+    size_t capacity;
+
+    std::mutex mutex;
+    std::condition_variable pendingAvailable;
+    std::condition_variable pendingConsumed;
+    std::deque<PendingMessage> pending;
+    bool writing = false;
+    bool stopped = false;
+
+    std::thread thread;
+
+    void writeLoop();
+    void enqueue(PendingMessage message);
+
+public:
+    /// The writer blocks producers once `capacity` messages are waiting to be written
+    explicit OutputWriter(std::ostream& output, size_t capacity = 1024);
+    ~OutputWriter();
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    /// Queues a message to be written. Blocks if the queue is full
+    void push(json message, ByteCounter bytesWritten = nullptr);
+    void push(Serializer serializer, ByteCounter bytesWritten = nullptr);
+
+    /// Blocks until all queued messages have been written and flushed to the output stream
+    void flush();
+};
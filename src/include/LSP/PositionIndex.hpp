@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "LSP/Rope.hpp"
+#include "Protocol/Structures.hpp"
+
+/// A snapshot of the line structure of a text, for converting between byte offsets and LSP positions without
+/// touching the text itself. Lines containing only ASCII convert in O(1). Other lines keep a table of their
+/// non-ASCII codepoints, which is binary searched, so no conversion scans the line or allocates.
+///
+/// Invalid UTF-8 is decoded in the same lenient way as `lspLength`: an invalid lead byte counts as a single unit,
+/// and a valid lead byte swallows the bytes that follow it, up to the end of the line
+class PositionIndex
+{
+public:
+    struct Codepoint
+    {
+        uint32_t byteColumn = 0;
+        uint32_t utf16Column = 0;
+        uint32_t utf32Column = 0;
+        uint32_t byteLength = 0;
+    };
+
+private:
+    size_t textSize = 0;
+    std::vector<size_t> lineStarts;
+    /// The non-ASCII codepoints of line `i` are `codepoints[codepointStarts[i]..codepointStarts[i + 1]]`
+    std::vector<uint32_t> codepointStarts;
+    std::vector<Codepoint> codepoints;
+
+    /// The column in the given encoding of `byteColumn`, where `it` is the first codepoint of the line at or after the column
+    static size_t unitsUpTo(std::vector<Codepoint>::const_iterator begin, std::vector<Codepoint>::const_iterator it, size_t byteColumn,
+        lsp::PositionEncodingKind encoding);
+
+public:
+    explicit PositionIndex(const Rope& text);
+
+    size_t lineCount() const
+    {
+        return lineStarts.size();
+    }
+
+    /// Offsets of the start of every line
+    const std::vector<size_t>& getLineStarts() const
+    {
+        return lineStarts;
+    }
+
+    /// The offset of the first byte of the line. Returns the size of the text if the line is past the end
+    size_t lineStart(size_t line) const
+    {
+        return line < lineStarts.size() ? lineStarts[line] : textSize;
+    }
+
+    /// The length of the line in bytes, including its line break
+    size_t lineLength(size_t line) const
+    {
+        return lineStart(line + 1) - lineStart(line);
+    }
+
+    /// The line which contains the given offset. An offset between a `\r\n` pair is part of the line the pair ends
+    size_t lineOf(size_t offset) const;
+
+    bool isAscii(size_t line) const
+    {
+        return line >= lineCount() || codepointStarts[line] == codepointStarts[line + 1];
+    }
+
+    /// Converts a byte column to a column in the given encoding. An offset inside a codepoint counts the whole codepoint.
+    /// The byte column must be no greater than lineLength(line)
+    size_t toUnits(size_t line, size_t byteColumn, lsp::PositionEncodingKind encoding) const;
+    /// As above, for converting many positions in order. `cursor` should start at zero and be passed to each call. Rather than searching
+    /// the line, each call walks forwards from where the previous call finished, so sorted positions are converted in one sweep
+    size_t toUnits(size_t line, size_t byteColumn, lsp::PositionEncodingKind encoding, size_t& cursor) const;
+
+    /// Converts a column in the given encoding to a byte column. `valid` is set to false if the column is past the end of the line
+    /// (which is clamped to lineLength(line)) or is in the middle of a UTF-16 surrogate pair (which is rounded up)
+    size_t toBytes(size_t line, size_t units, lsp::PositionEncodingKind encoding, bool& valid) const;
+};
@@ -0,0 +1,125 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/// An immutable-node rope: text stored as a balanced tree (a treap) of chunks of at most `MaxChunkSize` bytes.
+/// Every node caches the number of bytes and line breaks in its subtree, so edits, offset <-> line lookups and
+/// substring reads take O(log n) time instead of scanning or copying the whole text.
+///
+/// Nodes are never modified once built, so copying a rope is O(1) and copies share all unchanged chunks.
+///
+/// Line breaks are `\n`, `\r\n` or a lone `\r`. Chunks are never split between a `\r\n` pair, nor inside a UTF-8 sequence,
+/// so that every line break and codepoint can be found within a single chunk
+class Rope
+{
+public:
+    static constexpr size_t MaxChunkSize = 1024;
+
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node
+    {
+        /// Shared between nodes, so rebalancing a path through the tree does not copy the text
+        std::shared_ptr<const std::string> chunk;
+        size_t chunkLineBreaks = 0;
+        uint32_t priority = 0;
+        NodePtr left;
+        NodePtr right;
+
+        // Totals for the subtree rooted at this node
+        size_t bytes = 0;
+        size_t lineBreaks = 0;
+    };
+
+private:
+    NodePtr root;
+
+public:
+    Rope() = default;
+    explicit Rope(std::string_view text);
+
+    size_t size() const
+    {
+        return root ? root->bytes : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /// The number of lines in the text, which is always at least one
+    size_t lineCount() const
+    {
+        return (root ? root->lineBreaks : 0) + 1;
+    }
+
+    /// Replaces `length` bytes at `offset` with `text`. The range is clamped to the size of the rope
+    void replace(size_t offset, size_t length, std::string_view text);
+
+    /// The offset of the first byte of the line. Returns size() if the line is past the end of the text
+    size_t lineStart(size_t line) const;
+
+    /// The line which contains the given offset. An offset between a `\r\n` pair is part of the line the pair ends
+    size_t lineOf(size_t offset) const;
+
+    /// Copies `length` bytes at `offset` out of the rope. The range is clamped to the size of the rope
+    std::string substr(size_t offset, size_t length = std::string::npos) const;
+    /// Appends `length` bytes at `offset` to `output`. The range is clamped to the size of the rope
+    void appendTo(std::string& output, size_t offset = 0, size_t length = std::string::npos) const;
+
+    std::string toString() const
+    {
+        return substr(0);
+    }
+
+    /// Calls `callback(std::string_view)` for each contiguous piece of the text in [offset, offset + length), in order.
+    /// Iteration stops early if the callback returns true. No allocations are made
+    template<typename Callback>
+    void forEachChunk(size_t offset, size_t length, Callback&& callback) const
+    {
+        if (length == 0 || offset >= size())
+            return;
+        visit(root.get(), offset, std::min(length, size() - offset), callback);
+    }
+
+private:
+    /// Returns true if iteration should stop
+    template<typename Callback>
+    static bool visit(const Node* node, size_t offset, size_t length, Callback& callback)
+    {
+        while (node && length > 0)
+        {
+            size_t leftBytes = node->left ? node->left->bytes : 0;
+            if (offset < leftBytes)
+            {
+                size_t leftLength = std::min(length, leftBytes - offset);
+                if (visit(node->left.get(), offset, leftLength, callback))
+                    return true;
+                length -= leftLength;
+                offset = leftBytes;
+            }
+
+            offset -= leftBytes;
+            const std::string& chunk = *node->chunk;
+            if (length > 0 && offset < chunk.size())
+            {
+                size_t chunkLength = std::min(length, chunk.size() - offset);
+                if (callback(std::string_view(chunk).substr(offset, chunkLength)))
+                    return true;
+                length -= chunkLength;
+                offset = chunk.size();
+            }
+
+            // Continue into the right subtree iteratively, to bound recursion to the left spine
+            offset -= chunk.size();
+            node = node->right.get();
+        }
+        return false;
+    }
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <chrono>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/// A message read from a session recording
+struct RecordedMessage
+{
+    /// Time since the start of the recording at which the message was received
+    std::chrono::microseconds timestamp{0};
+    std::string body;
+};
+
+/// Records every message received from the client, so that a real editing session can be replayed later with `luau-lsp replay`.
+/// Messages are written using the same Content-Length framing as the protocol, with an additional header holding the time
+/// the message was received. Not thread-safe: messages should only be recorded by the input thread
+class SessionRecorder
+{
+private:
+    std::unique_ptr<std::ostream> output;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit SessionRecorder(std::unique_ptr<std::ostream> output);
+
+    /// Appends a message body to the recording. Each message is flushed, so the recording survives a crash
+    void record(std::string_view body);
+};
+
+/// Reads the next message from a session recording. Returns false once the end of the recording is reached
+bool readRecordedMessage(std::istream& input, RecordedMessage& message);
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "LSP/IndexCache.hpp"
+#include "LSP/Interner.hpp"
+
+/// A symbol found by `SymbolIndex::search`
+struct SymbolMatch
+{
+    InternedId module;
+    IndexedSymbol symbol;
+    /// Higher is a better match
+    int score = 0;
+};
+
+/// The symbols declared by every module in the workspace, searched by workspace symbols.
+///
+/// Symbols are stored in one flat list, with an index from each trigram (three consecutive characters, case-insensitively) of their
+/// names to the symbols containing it, so that a query only needs to look at symbols containing its rarest trigram. Queries are matched
+/// fuzzily: names containing the query rank highest, followed by names containing its characters in order.
+///
+/// When a module's symbols are replaced, its previous symbols are only marked as dead, and the list is compacted once most of it is dead
+class SymbolIndex
+{
+    struct Entry
+    {
+        InternedId module;
+        /// The entry is live if this is the current generation of its module
+        uint32_t generation = 0;
+        IndexedSymbol symbol;
+        std::string lowerName;
+    };
+
+    std::vector<Entry> entries;
+    /// The characters in the name of each entry, see `characterMask`. Kept apart from the entries so that scanning them stays in cache
+    std::vector<uint64_t> masks;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams;
+    /// The current generation of each module, indexed by module id
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> liveCounts;
+    size_t liveEntries = 0;
+
+    std::mutex staleMutex;
+    std::unordered_set<InternedId> stale;
+
+    bool isLive(const Entry& entry) const;
+    void addEntry(Entry entry);
+    void compact();
+
+public:
+    /// Replaces the symbols declared by a module. The module is no longer stale
+    void setModule(InternedId module, const std::vector<IndexedSymbol>& symbols);
+    void removeModule(InternedId module);
+
+    /// Records that the module may have changed, so its symbols should be collected again. Safe to call from any thread
+    void invalidate(InternedId module);
+    /// Returns the modules invalidated since the last call, which have not had their symbols replaced since
+    std::vector<InternedId> takeStale();
+
+    void clear();
+
+    /// The number of live symbols
+    size_t size() const
+    {
+        return liveEntries;
+    }
+
+    /// Returns at most `limit` symbols matching the query, best matches first. An empty query matches every symbol
+    std::vector<SymbolMatch> search(std::string_view query, size_t limit) const;
+};
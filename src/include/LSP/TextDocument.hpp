@@ -1,29 +1,56 @@
 #pragma once
+#include <memory>
+
+#include "LSP/PositionIndex.hpp"
+#include "LSP/Rope.hpp"
 #include "LSP/Uri.hpp"
 #include "Luau/Location.h"
 #include "Protocol/Structures.hpp"
 #include "Protocol/DocumentSync.hpp"
 
-size_t lspLength(const std::string& Code);
+size_t lspLength(std::string_view Code);
 
+/// A text document is mutated through update() only until it is published as a TextDocumentSnapshot. Snapshots are never modified,
+/// so they may be read on any thread whilst newer versions of the document are created. Copying a document is cheap, as the copy
+/// shares its text and position index with the original
 class TextDocument
 {
 private:
     lsp::DocumentUri _uri;
     std::string _languageId;
     size_t _version;
-    std::string _content;
-    mutable std::optional<std::vector<size_t>> _lineOffsets = std::nullopt;
+    /// Edits are applied to the rope in O(log n), rather than rebuilding the whole text
+    Rope _content;
+    /// Built when a position is first converted after an edit. Only accessed atomically, as snapshots may build it from several threads
+    mutable std::shared_ptr<const PositionIndex> _positionIndex = nullptr;
+
+    const PositionIndex& positionIndex() const;
+    /// Converts a position by measuring the rope, for use whilst applying edits
+    size_t offsetAtUnindexed(const lsp::Position& position) const;
+    /// `cursor` carries state between conversions of sorted positions, see PositionIndex::toUnits
+    lsp::Position convertPosition(const PositionIndex& index, const Luau::Position& position, lsp::PositionEncodingKind encoding, size_t* cursor) const;
 
 public:
     TextDocument(lsp::DocumentUri uri, std::string languageId, size_t version, std::string content)
         : _uri(std::move(uri))
         , _languageId(std::move(languageId))
         , _version(version)
-        , _content(std::move(content))
+        , _content(content)
     {
     }
 
+    TextDocument(const TextDocument& other)
+        : _uri(other._uri)
+        , _languageId(other._languageId)
+        , _version(other._version)
+        , _content(other._content)
+        , _positionIndex(std::atomic_load(&other._positionIndex))
+    {
+    }
+    TextDocument(TextDocument&& other) noexcept = default;
+    TextDocument& operator=(const TextDocument& other) = delete;
+    TextDocument& operator=(TextDocument&& other) noexcept = default;
+
     const lsp::DocumentUri& uri() const
     {
         return _uri;
@@ -48,8 +75,17 @@ public:
     Luau::Position convertPosition(const lsp::Position& position) const;
     lsp::Position convertPosition(const Luau::Position& position) const;
 
+    /// Converts many positions at once. Positions sorted in document order (such as those collected by an AST walk)
+    /// are converted in a single forward sweep over the document. Unsorted positions are still converted correctly
+    std::vector<lsp::Position> convertPositions(const std::vector<Luau::Position>& positions) const;
+    /// Converts many locations at once, as convertPositions(). Locations should be sorted by their beginning
+    std::vector<lsp::Range> convertLocations(const std::vector<Luau::Location>& locations) const;
+
     void update(const std::vector<lsp::TextDocumentContentChangeEvent>& changes, size_t version);
 
+    /// Offsets of the start of every line. Computed on demand after each edit
     const std::vector<size_t>& getLineOffsets() const;
     size_t lineCount() const;
 };
+
+using TextDocumentSnapshot = std::shared_ptr<const TextDocument>;
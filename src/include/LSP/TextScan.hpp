@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+/// Vectorized searches over document text. These use AVX2 or SSE2 when the compiler targets them, and fall back to
+/// scanning eight bytes at a time otherwise. Each returns the index of the first matching byte, or text.size() if there is none
+namespace text_scan
+{
+/// Finds the first `\r` or `\n`
+size_t findLineBreak(std::string_view text);
+
+/// Finds the first byte which is not ASCII
+size_t findNonAscii(std::string_view text);
+
+/// Finds the first `\r`, `\n` or byte which is not ASCII
+size_t findLineBreakOrNonAscii(std::string_view text);
+} // namespace text_scan
@@ -0,0 +1,41 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// A fixed set of worker threads which run submitted tasks in the order they were submitted
+class ThreadPool
+{
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::deque<std::function<void()>> tasks;
+    bool stopped = false;
+
+    std::vector<std::thread> threads;
+
+    void workLoop();
+
+public:
+    /// Creates `threadCount` workers. A count of 0 uses one worker per hardware thread
+    explicit ThreadPool(size_t threadCount = 0);
+    /// Finishes all submitted tasks before joining the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const
+    {
+        return threads.size();
+    }
+
+    void submit(std::function<void()> task);
+
+    /// Runs `task(index, worker)` for every index in [0, count), spread across the workers, and blocks until all have finished.
+    /// `worker` is in [0, size()), and no two calls with the same worker run at the same time, so it can select per-worker state.
+    /// The first exception thrown by a task is rethrown once every task has finished
+    void parallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& task);
+};
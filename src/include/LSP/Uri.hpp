@@ -1,7 +1,6 @@
 // Based off https://github.com/microsoft/vscode-uri/blob/main/src/uri.ts
 #pragma once
 #include <filesystem>
-#include <regex>
 #include "nlohmann/json.hpp"
 using json = nlohmann::json;
 
@@ -63,6 +62,9 @@ public:
 
     static Uri parse(const std::string& value);
     static Uri file(const std::filesystem::path& fsPath);
+    /// The same as `Uri::parse(Uri::file(fsPath).toString())`, i.e. with the drive letter and authority normalised to lower-case,
+    /// but without encoding and decoding the path
+    static Uri normalisedFile(const std::filesystem::path& fsPath);
 
     operator std::filesystem::path()
     {
@@ -17,6 +17,8 @@ std::string convertToScriptPath(const std::string& path);
 std::string codeBlock(const std::string& language, const std::string& code);
 std::optional<std::string> readFile(const std::filesystem::path& filePath);
 std::optional<std::filesystem::path> getHomeDirectory();
+/// The per-user directory for cached data, following the conventions of the platform (e.g. XDG_CACHE_HOME)
+std::optional<std::filesystem::path> getCacheDirectory();
 std::filesystem::path resolvePath(const std::filesystem::path& path);
 bool isDataModel(const std::string& path);
 void trim_start(std::string& str);
@@ -0,0 +1,4 @@
+#pragma once
+
+/// The version of the language server. Updated by scripts/release.py
+#define LSP_VERSION "1.34.0"
@@ -9,21 +9,35 @@
 #include "Protocol/SignatureHelp.hpp"
 #include "Protocol/SemanticTokens.hpp"
 #include "Protocol/Extensions.hpp"
+#include "LSP/BackgroundScheduler.hpp"
 #include "LSP/Client.hpp"
+#include "LSP/GlobMatcher.hpp"
+#include "LSP/FileWalker.hpp"
+#include "LSP/DependencyGraph.hpp"
+#include "LSP/IdentifierIndex.hpp"
+#include "LSP/SymbolIndex.hpp"
+#include "LSP/IndexCache.hpp"
+#include "LSP/Interner.hpp"
+#include "LSP/MessageQueue.hpp"
+#include "LSP/ThreadPool.hpp"
 #include "LSP/WorkspaceFileResolver.hpp"
 #include "LSP/LuauExt.hpp"
 
 struct Reference
 {
-    Luau::ModuleName moduleName;
+    /// The module the reference is in, interned in `WorkspaceFolder::moduleNames`
+    InternedId moduleId;
     Luau::Location location;
 
     bool operator==(const Reference& other) const
     {
-        return moduleName == other.moduleName && location == other.location;
+        return moduleId == other.moduleId && location == other.location;
     }
 };
 
+/// Summarises a parsed module for the workspace index. The platform resolves the module's string requires
+IndexedModule indexModule(const Luau::SourceNode& sourceNode, const Luau::SourceModule& sourceModule, uint64_t contentHash, LSPPlatform& platform);
+
 class WorkspaceFolder
 {
 public:
@@ -34,7 +48,20 @@ public:
     WorkspaceFileResolver fileResolver;
     Luau::Frontend frontend;
     bool isConfigured = false;
+    /// Module names referred to by id in LSP-side structures, such as `Reference`
+    StringInterner moduleNames;
+    /// The require graph between the modules in the frontend, over ids in `moduleNames`. Modules are invalidated when their
+    /// source is read (i.e. when they are parsed), and the graph is synced with the frontend before it is queried
+    DependencyGraph dependencyGraph;
+    /// The names mentioned by each module, used to skip modules which cannot contain references to a name
+    IdentifierIndex identifierIndex;
+    /// The symbols declared by each module, searched by workspace symbols. Seeded whilst indexing the workspace, and modules
+    /// invalidated since are collected again before searching
+    SymbolIndex symbolIndex;
     std::optional<nlohmann::json> definitionsFileMetadata;
+    /// Where long-running work is scheduled so that it can be interleaved with interactive requests.
+    /// If not set, background work is run to completion immediately
+    BackgroundScheduler* scheduler = nullptr;
 
 public:
     WorkspaceFolder(const std::shared_ptr<Client>& client, std::string name, const lsp::DocumentUri& uri, std::optional<Luau::Config> defaultConfig)
@@ -50,6 +77,13 @@ public:
     {
         fileResolver.client = std::static_pointer_cast<BaseClient>(client);
         fileResolver.rootUri = uri;
+        fileResolver.onReadSource = [this](const Luau::ModuleName& name)
+        {
+            auto moduleId = moduleNames.intern(name);
+            dependencyGraph.invalidate(moduleId);
+            identifierIndex.invalidate(moduleId);
+            symbolIndex.invalidate(moduleId);
+        };
     }
 
     // Sets up the workspace folder after receiving configuration information
@@ -63,20 +97,45 @@ public:
     void onDidChangeWatchedFiles(const lsp::FileEvent& change);
 
     /// Whether the file has been marked as ignored by any of the ignored lists in the configuration
-    bool isIgnoredFile(const std::filesystem::path& path, const std::optional<ClientConfiguration>& givenConfig = std::nullopt);
+    bool isIgnoredFile(const std::filesystem::path& path);
     /// Whether the file has been marked as ignored for auto-importing
-    bool isIgnoredFileForAutoImports(const std::filesystem::path& path, const std::optional<ClientConfiguration>& givenConfig = std::nullopt);
+    bool isIgnoredFileForAutoImports(const std::filesystem::path& path);
     /// Whether the file has been specified in the configuration as a definitions file
-    bool isDefinitionFile(const std::filesystem::path& path, const std::optional<ClientConfiguration>& givenConfig = std::nullopt);
+    bool isDefinitionFile(const std::filesystem::path& path);
+    bool isDefinitionFile(const std::filesystem::path& path, const ClientConfiguration& config);
+
+    /// The Luau source files in the workspace, excluding directories matched by the ignore globs.
+    /// Walked once and then kept up to date from file change events when the client reports them
+    const std::vector<std::filesystem::path>& workspaceSourceFiles();
+    /// Compiles the ignore globs of the configuration. Ignored files are tested against them until the configuration next changes
+    void applyIgnoreGlobs(const ClientConfiguration& config);
 
     lsp::DocumentDiagnosticReport documentDiagnostics(const lsp::DocumentDiagnosticParams& params);
-    lsp::WorkspaceDiagnosticReport workspaceDiagnostics(const lsp::WorkspaceDiagnosticParams& params);
+    lsp::WorkspaceDiagnosticReport workspaceDiagnostics(
+        const lsp::WorkspaceDiagnosticParams& params, const LSPCancellationToken& cancellationToken = nullptr);
+    /// The files which workspace diagnostics are computed for
+    std::vector<Uri> workspaceDiagnosticsFiles(const ClientConfiguration& config);
+    /// Computes the workspace diagnostics report for a single file.
+    /// Returns std::nullopt if the source module could not be retrieved
+    std::optional<lsp::WorkspaceDocumentDiagnosticReport> workspaceDocumentDiagnostics(const Uri& uri, const ClientConfiguration& config);
+    /// Type checks the files (and their dependencies) ahead of computing their workspace diagnostics reports, checking modules which do
+    /// not depend on each other on separate threads. The reports are then computed in order from the results
+    void checkWorkspaceFiles(
+        const std::vector<Uri>& files, const ClientConfiguration& config, const LSPCancellationToken& cancellationToken = nullptr);
     void recomputeDiagnostics(const ClientConfiguration& config);
     void pushDiagnostics(const lsp::DocumentUri& uri, const size_t version);
 
     void clearDiagnosticsForFile(const lsp::DocumentUri& uri);
 
     void indexFiles(const ClientConfiguration& config);
+    /// Runs any indexing still pending in the background to completion. Used by features which need the full require graph
+    void finishIndexing(const LSPCancellationToken& cancellationToken = nullptr);
+
+    /// Schedules a resumable task on the background scheduler, keyed to this workspace.
+    /// A pending task of the same kind is replaced
+    void runInBackground(const std::string& kind, BackgroundTask task);
+    /// The prefix of the keys of all background tasks belonging to this workspace
+    std::string backgroundTaskPrefix() const;
 
     Luau::CheckResult checkSimple(const Luau::ModuleName& moduleName, bool runLintChecks = false);
     void checkStrict(const Luau::ModuleName& moduleName, bool forAutocomplete = true);
@@ -84,20 +143,38 @@ public:
     const Luau::ModulePtr getModule(const Luau::ModuleName& moduleName, bool forAutocomplete = false) const;
 
 private:
+    /// The ignore globs of the configuration, compiled. Recompiled whenever the configured patterns change
+    GlobMatcher ignoreGlobs;
+    GlobMatcher autoImportIgnoreGlobs;
+    /// The options the workspace source files are found with, built from the configuration alongside the ignore globs
+    FileWalkerOptions sourceFileOptions;
+    WorkspaceFiles sourceFiles;
+
+    /// Whether the client sends file change events, so that `sourceFiles` can be kept up to date between walks
+    bool isWatchingSourceFiles() const;
+    /// The threads modules are type checked on for workspace diagnostics. Created when first needed
+    std::unique_ptr<ThreadPool> checkPool;
+
     void registerTypes();
     void endAutocompletion(const lsp::CompletionParams& params);
     void suggestImports(const Luau::ModuleName& moduleName, const Luau::Position& position, const ClientConfiguration& config,
         const TextDocument& textDocument, std::vector<lsp::CompletionItem>& result, bool completingTypeReferencePrefix = true);
     lsp::WorkspaceEdit computeOrganiseRequiresEdit(const lsp::DocumentUri& uri);
+    /// Brings the dependency graph up to date with the modules parsed since it was last synced
+    void syncDependencyGraph();
     std::vector<Luau::ModuleName> findReverseDependencies(const Luau::ModuleName& moduleName);
+    /// Whether the module mentions the name anywhere, parsing and indexing it first if needed
+    bool moduleMentions(const Luau::ModuleName& moduleName, std::string_view name);
 
 public:
     std::vector<std::string> getComments(const Luau::ModuleName& moduleName, const Luau::Location& node);
     std::optional<std::string> getDocumentationForType(const Luau::TypeId ty);
     std::optional<std::string> getDocumentationForAutocompleteEntry(const std::string& name, const Luau::AutocompleteEntry& entry,
         const std::vector<Luau::AstNode*>& ancestry, const Luau::ModuleName& moduleName);
-    std::vector<Reference> findAllReferences(const Luau::TypeId ty, std::optional<Luau::Name> property = std::nullopt);
-    std::vector<Reference> findAllTypeReferences(const Luau::ModuleName& moduleName, const Luau::Name& typeName);
+    std::vector<Reference> findAllReferences(
+        const Luau::TypeId ty, std::optional<Luau::Name> property = std::nullopt, const LSPCancellationToken& cancellationToken = nullptr);
+    std::vector<Reference> findAllTypeReferences(
+        const Luau::ModuleName& moduleName, const Luau::Name& typeName, const LSPCancellationToken& cancellationToken = nullptr);
 
     std::vector<lsp::CompletionItem> completion(const lsp::CompletionParams& params);
 
@@ -114,13 +191,14 @@ public:
 
     std::optional<lsp::Location> gotoTypeDefinition(const lsp::TypeDefinitionParams& params);
 
-    lsp::ReferenceResult references(const lsp::ReferenceParams& params);
-    lsp::RenameResult rename(const lsp::RenameParams& params);
+    lsp::ReferenceResult references(const lsp::ReferenceParams& params, const LSPCancellationToken& cancellationToken = nullptr);
+    lsp::RenameResult rename(const lsp::RenameParams& params, const LSPCancellationToken& cancellationToken = nullptr);
     lsp::InlayHintResult inlayHint(const lsp::InlayHintParams& params);
     std::vector<lsp::FoldingRange> foldingRange(const lsp::FoldingRangeParams& params);
 
     std::vector<lsp::CallHierarchyItem> prepareCallHierarchy(const lsp::CallHierarchyPrepareParams& params);
-    std::vector<lsp::CallHierarchyIncomingCall> callHierarchyIncomingCalls(const lsp::CallHierarchyIncomingCallsParams& params);
+    std::vector<lsp::CallHierarchyIncomingCall> callHierarchyIncomingCalls(
+        const lsp::CallHierarchyIncomingCallsParams& params, const LSPCancellationToken& cancellationToken = nullptr);
     std::vector<lsp::CallHierarchyOutgoingCall> callHierarchyOutgoingCalls(const lsp::CallHierarchyOutgoingCallsParams& params);
 
     std::optional<std::vector<lsp::DocumentSymbol>> documentSymbol(const lsp::DocumentSymbolParams& params);
@@ -1,12 +1,16 @@
 #pragma once
 #include <optional>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 #include "Luau/FileResolver.h"
 #include "Luau/StringUtils.h"
 #include "Luau/Config.h"
 #include "LSP/Client.hpp"
+#include "LSP/FileSystemCache.hpp"
 #include "LSP/Uri.hpp"
 #include "LSP/TextDocument.hpp"
 #include "Platform/LSPPlatform.hpp"
@@ -15,23 +19,21 @@
 // A wrapper around a text document pointer
 // A text document might be temporarily created for the purposes of this function
 // in which case it should be deleted once the ptr goes out of scope.
-// I don't think we can use a unique_ptr here, because a managed text document is not owned
+// Either a snapshot of a managed text document, or a temporary document created from the file on disk
 // NOTE: document may still be nil!
 struct TextDocumentPtr
 {
 private:
-    const TextDocument* document = nullptr;
-    bool isTemporary = false;
+    TextDocumentSnapshot document = nullptr;
 
 public:
-    explicit TextDocumentPtr(const TextDocument* document)
-        : document(document)
+    explicit TextDocumentPtr(TextDocumentSnapshot document)
+        : document(std::move(document))
     {
     }
 
     explicit TextDocumentPtr(const lsp::DocumentUri& uri, const std::string& languageId, const std::string& content)
-        : document(new TextDocument(uri, languageId, 0, content))
-        , isTemporary(true)
+        : document(std::make_shared<TextDocument>(uri, languageId, 0, content))
     {
     }
 
@@ -42,29 +44,12 @@ public:
 
     const TextDocument* operator->() const
     {
-        return document;
+        return document.get();
     }
 
-    ~TextDocumentPtr()
+    const TextDocument* get() const
     {
-        if (isTemporary)
-            delete document;
-    }
-
-    TextDocumentPtr(const TextDocumentPtr& other) = delete;
-    TextDocumentPtr& operator=(const TextDocumentPtr& other) = delete;
-
-    TextDocumentPtr(TextDocumentPtr&& other) noexcept
-        : document(std::exchange(other.document, nullptr))
-        , isTemporary(std::exchange(other.isTemporary, false))
-    {
-    }
-
-    TextDocumentPtr& operator=(TextDocumentPtr&& other) noexcept
-    {
-        std::swap(document, other.document);
-        std::swap(isTemporary, other.isTemporary);
-        return *this;
+        return document.get();
     }
 };
 
@@ -73,6 +58,8 @@ struct WorkspaceFileResolver
     , Luau::ConfigResolver
 {
 private:
+    /// Configs are read whilst modules are parsed on worker threads. Held by pointer so that the resolver stays movable
+    std::unique_ptr<std::mutex> configCacheMutex = std::make_unique<std::mutex>();
     mutable std::unordered_map<std::string, Luau::Config> configCache{};
 
 public:
@@ -82,8 +69,14 @@ public:
 
     LSPPlatform* platform = nullptr;
 
-    // Currently opened files where content is managed by client
-    mutable std::unordered_map</* DocumentUri */ std::string, TextDocument> managedFiles{};
+    /// File system lookups made whilst resolving modules. Cleared when watched files are created or deleted
+    std::unique_ptr<FileSystemCache> fileSystem = std::make_unique<FileSystemCache>();
+
+    /// Called whenever the source of a module is read, which happens whenever it is parsed. Called from worker threads whilst indexing
+    std::function<void(const Luau::ModuleName&)> onReadSource;
+
+    // Currently opened files where content is managed by client. Each edit replaces the snapshot with a new version
+    mutable std::unordered_map</* DocumentUri */ std::string, TextDocumentSnapshot> managedFiles{};
 
     WorkspaceFileResolver()
     {
@@ -98,9 +91,14 @@ public:
     static std::string normalisedUriString(const lsp::DocumentUri& uri);
 
     /// The file is managed by the client, so FS will be out of date
+    /// The returned document is only valid until the document is next edited. Use getTextDocumentSnapshot() to hold onto a version
     const TextDocument* getTextDocument(const lsp::DocumentUri& uri) const;
     const TextDocument* getTextDocumentFromModuleName(const Luau::ModuleName& name) const;
 
+    /// The current version of a managed document, which stays readable (from any thread) regardless of later edits
+    TextDocumentSnapshot getTextDocumentSnapshot(const lsp::DocumentUri& uri) const;
+    TextDocumentSnapshot getTextDocumentSnapshotFromModuleName(const Luau::ModuleName& name) const;
+
     TextDocumentPtr getOrCreateTextDocumentFromModuleName(const Luau::ModuleName& name);
 
     // Return the corresponding module name from a file Uri
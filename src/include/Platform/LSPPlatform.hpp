@@ -59,6 +59,20 @@ public:
 
     [[nodiscard]] virtual std::optional<std::string> readSourceCode(const Luau::ModuleName& name, const std::filesystem::path& path) const;
 
+    /// Identifies the state besides the configuration which module resolution depends on (such as a sourcemap),
+    /// so that resolved requires which were persisted can be discarded once it changes
+    [[nodiscard]] virtual std::string getModuleResolutionKey() const
+    {
+        return "";
+    }
+
+    /// Whether modules can be type checked on several threads at once. Platforms whose type checking hooks (such as
+    /// `prepareModuleScope` or magic functions) modify state shared between modules should return false
+    [[nodiscard]] virtual bool supportsParallelTypeChecking(const ClientConfiguration& config) const
+    {
+        return true;
+    }
+
     std::optional<Luau::ModuleInfo> resolveStringRequire(const Luau::ModuleInfo* context, const std::string& requiredString);
     virtual std::optional<Luau::ModuleInfo> resolveModule(const Luau::ModuleInfo* context, Luau::AstExpr* node);
 
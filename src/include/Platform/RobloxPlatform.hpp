@@ -138,6 +138,13 @@ private:
     mutable std::unordered_map<std::string, SourceNodePtr> realPathsToSourceNodes{};
     mutable std::unordered_map<Luau::ModuleName, SourceNodePtr> virtualPathsToSourceNodes{};
 
+    /// Hash of the contents the sourcemap was last loaded from
+    uint64_t sourceMapHash = 0;
+
+    /// Resolves the path with std::filesystem::weakly_canonical (through the file system cache) and normalises its drive letter.
+    /// Returns std::nullopt if the path could not be canonicalised
+    std::optional<std::filesystem::path> canonicaliseRealPath(const std::filesystem::path& path) const;
+
     std::optional<SourceNodePtr> getSourceNodeFromVirtualPath(const Luau::ModuleName& name) const;
     std::optional<SourceNodePtr> getSourceNodeFromRealPath(const std::string& name) const;
 
@@ -177,10 +184,17 @@ public:
 
     std::optional<Luau::ModuleInfo> resolveModule(const Luau::ModuleInfo* context, Luau::AstExpr* node) override;
 
+    std::string getModuleResolutionKey() const override
+    {
+        return std::to_string(sourceMapHash);
+    }
+
     void updateSourceNodeMap(const std::string& sourceMapContents);
 
     void handleSourcemapUpdate(Luau::Frontend& frontend, const Luau::GlobalTypes& globals, bool expressiveTypes);
 
+    bool supportsParallelTypeChecking(const ClientConfiguration& config) const override;
+
     std::optional<Luau::AutocompleteEntryMap> completionCallback(const std::string& tag, std::optional<const Luau::ClassType*> ctx,
         std::optional<std::string> contents, const Luau::ModuleName& moduleName) override;
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "Protocol/Structures.hpp"
 #include <string>
+#include <unordered_map>
 
 namespace lsp
 {
@@ -28,4 +29,29 @@ struct CompilerRemarksParams
 NLOHMANN_DEFINE_OPTIONAL(CompilerRemarksParams, textDocument, optimizationLevel)
 
 using CompilerRemarksResult = std::string;
+
+/// Latencies are in milliseconds, and are approximate (within ~12.5%)
+struct LatencyStatistics
+{
+    double p50 = 0;
+    double p95 = 0;
+    double p99 = 0;
+    double max = 0;
+};
+NLOHMANN_DEFINE_OPTIONAL(LatencyStatistics, p50, p95, p99, max)
+
+struct MethodStatistics
+{
+    size_t count = 0;
+    LatencyStatistics latency{};
+    size_t bytesIn = 0;
+    size_t bytesOut = 0;
+};
+NLOHMANN_DEFINE_OPTIONAL(MethodStatistics, count, latency, bytesIn, bytesOut)
+
+struct StatsResult
+{
+    std::unordered_map<std::string /* method */, MethodStatistics> methods{};
+};
+NLOHMANN_DEFINE_OPTIONAL(StatsResult, methods)
 } // namespace lsp
@@ -1,6 +1,9 @@
 #pragma once
+#include <optional>
 #include <string>
 
+#include "Protocol/Base.hpp"
+
 namespace lsp
 {
 enum struct MessageType
@@ -24,4 +27,57 @@ struct ShowMessageParams
     std::string message;
 };
 NLOHMANN_DEFINE_OPTIONAL(ShowMessageParams, type, message)
+
+struct WorkDoneProgressCreateParams
+{
+    /**
+     * The token to be used to report progress.
+     */
+    ProgressToken token = "";
+};
+NLOHMANN_DEFINE_OPTIONAL(WorkDoneProgressCreateParams, token)
+
+struct WorkDoneProgressBegin
+{
+    std::string kind = "begin";
+    /**
+     * Mandatory title of the progress operation. Used to briefly inform about
+     * the kind of operation being performed.
+     */
+    std::string title;
+    /**
+     * Controls if a cancel button should show to allow the user to cancel the
+     * long running operation.
+     */
+    std::optional<bool> cancellable = std::nullopt;
+    /**
+     * Optional, more detailed associated progress message.
+     */
+    std::optional<std::string> message = std::nullopt;
+    /**
+     * Optional progress percentage to display (value 100 is considered 100%).
+     */
+    std::optional<unsigned int> percentage = std::nullopt;
+};
+NLOHMANN_DEFINE_OPTIONAL(WorkDoneProgressBegin, kind, title, cancellable, message, percentage)
+
+struct WorkDoneProgressReport
+{
+    std::string kind = "report";
+    std::optional<bool> cancellable = std::nullopt;
+    std::optional<std::string> message = std::nullopt;
+    std::optional<unsigned int> percentage = std::nullopt;
+};
+NLOHMANN_DEFINE_OPTIONAL(WorkDoneProgressReport, kind, cancellable, message, percentage)
+
+struct WorkDoneProgressEnd
+{
+    std::string kind = "end";
+    /**
+     * Optional, a final message indicating to for example indicate the outcome
+     * of the operation.
+     */
+    std::optional<std::string> message = std::nullopt;
+};
+NLOHMANN_DEFINE_OPTIONAL(WorkDoneProgressEnd, kind, message)
 } // namespace lsp
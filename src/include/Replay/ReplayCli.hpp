@@ -0,0 +1,6 @@
+#pragma once
+#include "argparse/argparse.hpp"
+#include "LSP/LanguageServer.hpp"
+
+/// Replays a recorded session through the server, and reports per-method latencies, CPU time and peak memory usage
+int replaySession(const argparse::ArgumentParser& program, LanguageServer& server);
@@ -1,11 +1,15 @@
 #include "Flags.hpp"
 #include "LSP/LanguageServer.hpp"
 #include "LSP/DocumentationParser.hpp"
+#include "LSP/Version.hpp"
 #include "Analyze/AnalyzeCli.hpp"
 #include "Analyze/CliConfigurationParser.hpp"
+#include "Replay/ReplayCli.hpp"
 #include "Luau/ExperimentalFlags.h"
 #include "argparse/argparse.hpp"
 
+#include <fstream>
+
 #ifdef _WIN32
 #include <io.h>
 #include <fcntl.h>
@@ -28,23 +32,10 @@ static void displayFlags()
     }
 }
 
-int startLanguageServer(const argparse::ArgumentParser& program)
+/// Sets up a language server using the arguments shared by the `lsp` and `replay` commands.
+/// Returns nullptr if the arguments are invalid
+static std::unique_ptr<LanguageServer> createLanguageServer(const argparse::ArgumentParser& program)
 {
-    // Debug loop: set a breakpoint inside while loop to attach debugger before init
-    if (program.is_used("--delay-startup"))
-    {
-        auto d = 4;
-        while (d == 4)
-        {
-            d = 4;
-        }
-    }
-
-#ifdef _WIN32
-    _setmode(_fileno(stdin), _O_BINARY);
-    _setmode(_fileno(stdout), _O_BINARY);
-#endif
-
     auto definitionsFiles = program.get<std::vector<std::filesystem::path>>("--definitions");
     auto documentationFiles = program.get<std::vector<std::filesystem::path>>("--docs");
     std::optional<std::filesystem::path> baseLuaurc = program.present<std::filesystem::path>("--base-luaurc");
@@ -59,13 +50,13 @@ int startLanguageServer(const argparse::ArgumentParser& program)
             if (error)
             {
                 std::cerr << baseLuaurc->generic_string() << ": " << *error << "\n";
-                return 1;
+                return nullptr;
             }
         }
         else
         {
             std::cerr << "Failed to read base .luaurc configuration at '" << baseLuaurc->generic_string() << "'\n";
-            return 1;
+            return nullptr;
         }
     }
 
@@ -84,17 +75,63 @@ int startLanguageServer(const argparse::ArgumentParser& program)
         else
         {
             std::cerr << "Failed to read base LSP settings at '" << settingsPath->generic_string() << "'\n";
-            return 1;
+            return nullptr;
         }
     }
 
-    LanguageServer server(client, defaultConfig);
+    return std::make_unique<LanguageServer>(client, defaultConfig);
+}
+
+int startLanguageServer(const argparse::ArgumentParser& program)
+{
+    // Debug loop: set a breakpoint inside while loop to attach debugger before init
+    if (program.is_used("--delay-startup"))
+    {
+        auto d = 4;
+        while (d == 4)
+        {
+            d = 4;
+        }
+    }
+
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    auto server = createLanguageServer(program);
+    if (!server)
+        return 1;
+
+    if (auto recordPath = program.present<std::filesystem::path>("--record"))
+    {
+        auto recording = std::make_unique<std::ofstream>(*recordPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!*recording)
+        {
+            std::cerr << "Failed to open session recording file at '" << recordPath->generic_string() << "'\n";
+            return 1;
+        }
+        server->setRecorder(std::make_unique<SessionRecorder>(std::move(recording)));
+    }
 
     // Begin input loop
-    server.processInputLoop();
+    server->processInputLoop();
+    Client::flushOutput();
 
     // If we received a shutdown request before exiting, exit normally. Otherwise, it is an abnormal exit
-    return server.requestedShutdown() ? 0 : 1;
+    return server->requestedShutdown() ? 0 : 1;
+}
+
+int startReplay(const argparse::ArgumentParser& program)
+{
+    // The replayed server behaves as if connected to a client which ignores all of its output
+    Client::discardOutput();
+
+    auto server = createLanguageServer(program);
+    if (!server)
+        return 1;
+
+    return replaySession(program, *server);
 }
 
 void processFFlags(const argparse::ArgumentParser& program)
@@ -143,7 +180,7 @@ int main(int argc, char** argv)
         return 1;
     };
 
-    argparse::ArgumentParser program("luau-lsp", "1.34.0");
+    argparse::ArgumentParser program("luau-lsp", LSP_VERSION);
     program.set_assign_chars(":=");
 
     // Global arguments
@@ -196,6 +233,10 @@ int main(int argc, char** argv)
         .default_value<std::vector<std::string>>({})
         .append()
         .metavar("GLOB");
+    analyze_command.add_argument("--respect-gitignore")
+        .help("skip files ignored by .gitignore files when searching directories")
+        .default_value(false)
+        .implicit_value(true);
     analyze_command.add_argument("--base-luaurc")
         .help("path to a .luaurc file which acts as the base default configuration")
         .action(file_path_parser)
@@ -204,36 +245,59 @@ int main(int argc, char** argv)
     analyze_command.add_argument("--settings").help("path to LSP-style settings").action(file_path_parser).metavar("PATH");
     analyze_command.add_argument("files").help("files to perform analysis on").remaining();
 
-    // Language server arguments
-    argparse::ArgumentParser lsp_command("lsp");
-    lsp_command.add_description("Start the language server");
-    lsp_command.add_epilog("This will start up a server which listens to LSP messages on stdin, and responds on stdout");
-    lsp_command.add_parents(parent_parser);
-    lsp_command.add_argument("--definitions")
+    // Arguments shared by commands which start a language server
+    argparse::ArgumentParser server_parser("-", "0.0", argparse::default_arguments::none);
+    server_parser.add_argument("--definitions")
         .help("path to a Luau definitions file to load into the global namespace")
         .action(file_path_parser)
         .default_value<std::vector<std::filesystem::path>>({})
         .append()
         .metavar("PATH");
-    lsp_command.add_argument("--docs", "--documentation")
+    server_parser.add_argument("--docs", "--documentation")
         .help("path to a Luau documentation database for loaded definitions")
         .action(file_path_parser)
         .default_value<std::vector<std::filesystem::path>>({})
         .append()
         .metavar("PATH");
-    lsp_command.add_argument("--base-luaurc")
+    server_parser.add_argument("--base-luaurc")
         .help("path to a .luaurc file which acts as the base default configuration")
         .action(file_path_parser)
         .metavar("PATH");
-    lsp_command.add_argument("--settings").help("path to LSP settings to use as default").action(file_path_parser).metavar("PATH");
+    server_parser.add_argument("--settings").help("path to LSP settings to use as default").action(file_path_parser).metavar("PATH");
+
+    // Language server arguments
+    argparse::ArgumentParser lsp_command("lsp");
+    lsp_command.add_description("Start the language server");
+    lsp_command.add_epilog("This will start up a server which listens to LSP messages on stdin, and responds on stdout");
+    lsp_command.add_parents(parent_parser);
+    lsp_command.add_parents(server_parser);
     lsp_command.add_argument("--delay-startup")
         .help("debug flag to halt startup to allow connection of a debugger")
         .default_value(false)
         .implicit_value(true);
+    lsp_command.add_argument("--record")
+        .help("record all messages received from the client into a file, which can be replayed using `luau-lsp replay`")
+        .action(file_path_parser)
+        .metavar("PATH");
+
+    // Replay arguments
+    argparse::ArgumentParser replay_command("replay");
+    replay_command.add_description("Replay a session recorded using `luau-lsp lsp --record`, and report performance statistics");
+    replay_command.add_epilog("Messages are handled one at a time, and all background work is completed before the next message, so that "
+                              "replays of the same recording are comparable");
+    replay_command.add_parents(parent_parser);
+    replay_command.add_parents(server_parser);
+    replay_command.add_argument("--workspace")
+        .help("path to a local copy of the recorded workspace. The recorded workspace folder is remapped to this path")
+        .action(file_path_parser)
+        .metavar("PATH");
+    replay_command.add_argument("--json").help("output the report as JSON").default_value(false).implicit_value(true);
+    replay_command.add_argument("recording").help("path to the recorded session").action(file_path_parser);
 
     program.add_parents(parent_parser);
     program.add_subparser(analyze_command);
     program.add_subparser(lsp_command);
+    program.add_subparser(replay_command);
 
     try
     {
@@ -263,9 +327,14 @@ int main(int argc, char** argv)
         processFFlags(analyze_command);
         return startAnalyze(analyze_command);
     }
+    else if (program.is_subcommand_used("replay"))
+    {
+        processFFlags(replay_command);
+        return startReplay(replay_command);
+    }
 
     // No sub-command specified
-    std::cerr << "Specify a particular mode to run the program (analyze/lsp)" << '\n';
+    std::cerr << "Specify a particular mode to run the program (analyze/lsp/replay)" << '\n';
     std::cerr << program;
     return 1;
 }
@@ -202,7 +202,8 @@ std::vector<lsp::CallHierarchyItem> WorkspaceFolder::prepareCallHierarchy(const
         return {};
 }
 
-std::vector<lsp::CallHierarchyIncomingCall> WorkspaceFolder::callHierarchyIncomingCalls(const lsp::CallHierarchyIncomingCallsParams& params)
+std::vector<lsp::CallHierarchyIncomingCall> WorkspaceFolder::callHierarchyIncomingCalls(
+    const lsp::CallHierarchyIncomingCallsParams& params, const LSPCancellationToken& cancellationToken)
 {
     auto moduleName = fileResolver.getModuleName(params.item.uri);
 
@@ -212,6 +213,9 @@ std::vector<lsp::CallHierarchyIncomingCall> WorkspaceFolder::callHierarchyIncomi
         throw JsonRpcException(lsp::ErrorCode::RequestFailed, "No text document available for " + params.item.uri.toString());
     auto position = textDocument->convertPosition(params.item.selectionRange.start);
 
+    // Incoming calls are found by walking the require graph, so wait for indexing to complete to avoid partial results
+    finishIndexing(cancellationToken);
+
     // Find the definition of the original function, to determine the appropriate TypeId to lookup
     auto sourceModule = frontend.getSourceModule(moduleName);
     auto module = getModule(moduleName, /* forAutocomplete: */ true);
@@ -236,6 +240,8 @@ std::vector<lsp::CallHierarchyIncomingCall> WorkspaceFolder::callHierarchyIncomi
     // For each module, search for callers
     for (const auto& dependentModuleName : dependents)
     {
+        throwIfCancelled(cancellationToken);
+
         auto dependentSourceModule = frontend.getSourceModule(dependentModuleName);
         auto dependentModule = getModule(dependentModuleName, /* forAutocomplete: */ true);
         if (!dependentSourceModule || !dependentModule)
@@ -277,7 +283,6 @@ std::vector<lsp::CallHierarchyIncomingCall> WorkspaceFolder::callHierarchyIncomi
             }
 
             std::vector<lsp::Range> convertedRanges{};
-            convertedRanges.reserve(matchingCalls.size());
 
             if (auto refTextDocument = fileResolver.getOrCreateTextDocumentFromModuleName(dependentModuleName))
             {
@@ -295,9 +300,11 @@ std::vector<lsp::CallHierarchyIncomingCall> WorkspaceFolder::callHierarchyIncomi
                     item.selectionRange = {{0, 0}, {0, 0}};
                 }
 
+                std::vector<Luau::Location> callLocations;
+                callLocations.reserve(matchingCalls.size());
                 for (const auto& call : matchingCalls)
-                    convertedRanges.emplace_back(lsp::Range{
-                        refTextDocument->convertPosition(call->func->location.begin), refTextDocument->convertPosition(call->func->location.end)});
+                    callLocations.emplace_back(call->func->location);
+                convertedRanges = refTextDocument->convertLocations(callLocations);
             }
             else
                 return;
@@ -383,11 +390,11 @@ std::vector<lsp::CallHierarchyOutgoingCall> WorkspaceFolder::callHierarchyOutgoi
             else
                 continue;
 
-            std::vector<lsp::Range> convertedRanges{};
-            convertedRanges.reserve(exprs.size());
+            std::vector<Luau::Location> callLocations;
+            callLocations.reserve(exprs.size());
             for (const auto& expr : exprs)
-                convertedRanges.emplace_back(
-                    lsp::Range{textDocument->convertPosition(expr->location.begin), textDocument->convertPosition(expr->location.end)});
+                callLocations.emplace_back(expr->location);
+            auto convertedRanges = textDocument->convertLocations(callLocations);
 
             lsp::CallHierarchyOutgoingCall outgoingCall{item, convertedRanges};
             result.emplace_back(outgoingCall);
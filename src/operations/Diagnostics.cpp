@@ -4,6 +4,19 @@
 #include "LSP/LuauExt.hpp"
 #include "Luau/TimeTrace.h"
 
+#include <algorithm>
+
+/// The number of files type checked together for workspace diagnostics before their reports are computed. Larger batches keep more
+/// threads busy, whilst smaller ones let interactive requests be handled in between sooner
+static constexpr size_t kWorkspaceCheckBatchSize = 64;
+
+/// The files in the check batch starting at `start`
+static std::vector<Uri> checkBatch(const std::vector<Uri>& files, size_t start)
+{
+    auto end = std::min(files.size(), start + kWorkspaceCheckBatchSize);
+    return std::vector<Uri>(files.begin() + static_cast<std::ptrdiff_t>(start), files.begin() + static_cast<std::ptrdiff_t>(end));
+}
+
 lsp::DocumentDiagnosticReport WorkspaceFolder::documentDiagnostics(const lsp::DocumentDiagnosticParams& params)
 {
     LUAU_TIMETRACE_SCOPE("WorkspaceFolder::documentDiagnostics", "LSP");
@@ -48,7 +61,7 @@ lsp::DocumentDiagnosticReport WorkspaceFolder::documentDiagnostics(const lsp::Do
         else
         {
             auto fileName = platform->resolveToRealPath(error.moduleName);
-            if (!fileName || isIgnoredFile(*fileName, config))
+            if (!fileName || isIgnoredFile(*fileName))
                 continue;
             auto textDocument = fileResolver.getTextDocumentFromModuleName(error.moduleName);
             auto diagnostic = createTypeErrorDiagnostic(error, &fileResolver, textDocument);
@@ -83,7 +96,8 @@ lsp::DocumentDiagnosticReport WorkspaceFolder::documentDiagnostics(const lsp::Do
     return report;
 }
 
-lsp::WorkspaceDiagnosticReport WorkspaceFolder::workspaceDiagnostics(const lsp::WorkspaceDiagnosticParams& params)
+lsp::WorkspaceDiagnosticReport WorkspaceFolder::workspaceDiagnostics(
+    const lsp::WorkspaceDiagnosticParams& params, const LSPCancellationToken& cancellationToken)
 {
     LUAU_TIMETRACE_SCOPE("WorkspaceFolder::workspaceDiagnostics", "LSP");
     if (!isConfigured)
@@ -99,20 +113,30 @@ lsp::WorkspaceDiagnosticReport WorkspaceFolder::workspaceDiagnostics(const lsp::
         return workspaceReport;
 
     auto config = client->getConfiguration(rootUri);
+    auto files = workspaceDiagnosticsFiles(config);
+    checkWorkspaceFiles(files, config, cancellationToken);
 
-    // Find a list of files to compute diagnostics for
+    for (const auto& uri : files)
+    {
+        throwIfCancelled(cancellationToken);
+
+        if (auto documentReport = workspaceDocumentDiagnostics(uri, config))
+            workspaceReport.items.emplace_back(std::move(*documentReport));
+    }
+
+    return workspaceReport;
+}
+
+std::vector<Uri> WorkspaceFolder::workspaceDiagnosticsFiles(const ClientConfiguration& config)
+{
+    // The workspace file list is kept up to date from file change events, so the disk does not need to be walked on every pull
     std::vector<Uri> files{};
-    for (std::filesystem::recursive_directory_iterator next(this->rootUri.fsPath(), std::filesystem::directory_options::skip_permission_denied), end;
-        next != end; ++next)
+    for (const auto& path : workspaceSourceFiles())
     {
         try
         {
-            if (next->is_regular_file() && next->path().has_extension() && !isDefinitionFile(next->path(), config))
-            {
-                auto ext = next->path().extension();
-                if (ext == ".lua" || ext == ".luau")
-                    files.push_back(Uri::file(next->path()));
-            }
+            if (!isDefinitionFile(path, config))
+                files.push_back(Uri::file(path));
         }
         catch (const std::filesystem::filesystem_error& e)
         {
@@ -120,58 +144,104 @@ lsp::WorkspaceDiagnosticReport WorkspaceFolder::workspaceDiagnostics(const lsp::
         }
     }
 
-    for (auto uri : files)
+    return files;
+}
+
+std::optional<lsp::WorkspaceDocumentDiagnosticReport> WorkspaceFolder::workspaceDocumentDiagnostics(
+    const Uri& uri, const ClientConfiguration& config)
+{
+    auto moduleName = fileResolver.getModuleName(uri);
+    auto document = fileResolver.getTextDocument(uri);
+
+    lsp::WorkspaceDocumentDiagnosticReport documentReport;
+    documentReport.uri = uri;
+    documentReport.kind = lsp::DocumentDiagnosticReportKind::Full;
+    if (document)
+        documentReport.version = document->version();
+
+    // If we don't have workspace diagnostics enabled, or we are are ignoring this file
+    // Then provide an empty report to clear the file diagnostics
+    if (!config.diagnostics.workspace || isIgnoredFile(uri))
+        return documentReport;
+
+    // Compute new check result
+    Luau::CheckResult cr = checkSimple(moduleName, /* runLintChecks: */ true);
+
+    // If there was an error retrieving the source module, disregard this file
+    // TODO: should we file a diagnostic?
+    if (!frontend.getSourceModule(moduleName))
+        return std::nullopt;
+
+    // Report Type Errors
+    // Only report errors for the current file
+    for (auto& error : cr.errors)
     {
-        auto moduleName = fileResolver.getModuleName(uri);
-        auto document = fileResolver.getTextDocument(uri);
-
-        lsp::WorkspaceDocumentDiagnosticReport documentReport;
-        documentReport.uri = uri;
-        documentReport.kind = lsp::DocumentDiagnosticReportKind::Full;
-        if (document)
-            documentReport.version = document->version();
-
-        // If we don't have workspace diagnostics enabled, or we are are ignoring this file
-        // Then provide an empty report to clear the file diagnostics
-        if (!config.diagnostics.workspace || isIgnoredFile(uri, config))
+        if (error.moduleName == moduleName)
         {
-            workspaceReport.items.emplace_back(documentReport);
-            continue;
+            auto diagnostic = createTypeErrorDiagnostic(error, &fileResolver, document);
+            documentReport.items.emplace_back(diagnostic);
         }
+    }
 
-        // Compute new check result
-        Luau::CheckResult cr = checkSimple(moduleName, /* runLintChecks: */ true);
+    // Report Lint Warnings
+    for (auto& error : cr.lintResult.errors)
+    {
+        auto diagnostic = createLintDiagnostic(error, document);
+        diagnostic.severity = lsp::DiagnosticSeverity::Error; // Report this as an error instead
+        documentReport.items.emplace_back(diagnostic);
+    }
+    for (auto& error : cr.lintResult.warnings)
+        documentReport.items.emplace_back(createLintDiagnostic(error, document));
 
-        // If there was an error retrieving the source module, disregard this file
-        // TODO: should we file a diagnostic?
-        if (!frontend.getSourceModule(moduleName))
-            continue;
+    return documentReport;
+}
 
-        // Report Type Errors
-        // Only report errors for the current file
-        for (auto& error : cr.errors)
-        {
-            if (error.moduleName == moduleName)
-            {
-                auto diagnostic = createTypeErrorDiagnostic(error, &fileResolver, document);
-                documentReport.items.emplace_back(diagnostic);
-            }
-        }
+void WorkspaceFolder::checkWorkspaceFiles(
+    const std::vector<Uri>& files, const ClientConfiguration& config, const LSPCancellationToken& cancellationToken)
+{
+    LUAU_TIMETRACE_SCOPE("WorkspaceFolder::checkWorkspaceFiles", "LSP");
+    if (!config.diagnostics.workspace)
+        return;
+
+    std::vector<Luau::ModuleName> moduleNames;
+    for (const auto& uri : files)
+        if (!isIgnoredFile(uri))
+            moduleNames.push_back(fileResolver.getModuleName(uri));
+
+    if (moduleNames.empty())
+        return;
+
+    // The frontend works out which modules are ready to check from the require graph, and hands each to the executor once all of
+    // its dependencies have been checked. Without an executor, the modules are checked one at a time on this thread
+    std::function<void(std::function<void()> task)> executeTask;
+    if (platform->supportsParallelTypeChecking(config))
+    {
+        if (!checkPool)
+            checkPool = std::make_unique<ThreadPool>();
 
-        // Report Lint Warnings
-        for (auto& error : cr.lintResult.errors)
+        executeTask = [this](std::function<void()> task)
         {
-            auto diagnostic = createLintDiagnostic(error, document);
-            diagnostic.severity = lsp::DiagnosticSeverity::Error; // Report this as an error instead
-            documentReport.items.emplace_back(diagnostic);
-        }
-        for (auto& error : cr.lintResult.warnings)
-            documentReport.items.emplace_back(createLintDiagnostic(error, document));
+            checkPool->submit(std::move(task));
+        };
+    }
 
-        workspaceReport.items.emplace_back(documentReport);
+    frontend.queueModuleCheck(moduleNames);
+    try
+    {
+        frontend.checkQueuedModules(Luau::FrontendOptions{/* retainFullTypeGraphs: */ false, /* forAutocomplete: */ false, /* runLintChecks: */ true},
+            executeTask,
+            [&cancellationToken](size_t, size_t)
+            {
+                return !cancellationToken || !cancellationToken->requested();
+            });
+    }
+    catch (Luau::InternalCompilerError& err)
+    {
+        // See checkSimple. Modules left unchecked are checked again one at a time when their reports are computed
+        client->sendLogMessage(lsp::MessageType::Warning, std::string("Luau InternalCompilerError caught whilst checking workspace: ") + err.what());
     }
 
-    return workspaceReport;
+    throwIfCancelled(cancellationToken);
 }
 
 lsp::DocumentDiagnosticReport LanguageServer::documentDiagnostic(const lsp::DocumentDiagnosticParams& params)
@@ -213,22 +283,34 @@ void WorkspaceFolder::recomputeDiagnostics(const ClientConfiguration& config)
     if ((!client->capabilities.textDocument || !client->capabilities.textDocument->diagnostic))
     {
         // Recompute workspace diagnostics if requested
+        // This is done in the background a batch of files at a time, so that interactive requests are not held up
         if (config.diagnostics.workspace)
         {
-            auto diagnostics = workspaceDiagnostics({});
-            for (const auto& report : diagnostics.items)
-            {
-                if (report.kind == lsp::DocumentDiagnosticReportKind::Full)
+            if (isNullWorkspace())
+                return;
+
+            auto files = std::make_shared<std::vector<Uri>>(workspaceDiagnosticsFiles(config));
+            runInBackground("diagnostics",
+                [this, files, config, index = size_t(0)]() mutable
                 {
-                    client->publishDiagnostics(lsp::PublishDiagnosticsParams{report.uri, report.version, report.items});
-                }
-            }
+                    if (index >= files->size())
+                        return false;
+
+                    if (index % kWorkspaceCheckBatchSize == 0)
+                        checkWorkspaceFiles(checkBatch(*files, index), config);
+
+                    auto report = workspaceDocumentDiagnostics(files->at(index++), config);
+                    if (report && report->kind == lsp::DocumentDiagnosticReportKind::Full)
+                        client->publishDiagnostics(lsp::PublishDiagnosticsParams{report->uri, report->version, report->items});
+
+                    return index < files->size();
+                });
         }
         // Recompute diagnostics for all currently opened files
         else
         {
             for (const auto& [_, document] : fileResolver.managedFiles)
-                pushDiagnostics(document.uri(), document.version());
+                pushDiagnostics(document->uri(), document->version());
         }
     }
     else
@@ -238,27 +320,100 @@ void WorkspaceFolder::recomputeDiagnostics(const ClientConfiguration& config)
     }
 }
 
-lsp::PartialResponse<lsp::WorkspaceDiagnosticReport> LanguageServer::workspaceDiagnostic(const lsp::WorkspaceDiagnosticParams& params)
+void LanguageServer::workspaceDiagnostic(
+    const id_type& id, const lsp::WorkspaceDiagnosticParams& params, const LSPCancellationToken& cancellationToken)
 {
-    lsp::WorkspaceDiagnosticReport fullReport;
+    struct WorkspaceFiles
+    {
+        WorkspaceFolderPtr workspace;
+        ClientConfiguration config;
+        std::vector<Uri> files;
+    };
 
+    auto pending = std::make_shared<std::vector<WorkspaceFiles>>();
     for (auto& workspace : workspaceFolders)
     {
-        auto report = workspace->workspaceDiagnostics(params);
-        fullReport.items.insert(fullReport.items.end(), std::make_move_iterator(report.items.begin()), std::make_move_iterator(report.items.end()));
-    }
+        if (!workspace->isConfigured)
+        {
+            lsp::DiagnosticServerCancellationData cancellationData{/*retriggerRequest: */ true};
+            throw JsonRpcException(lsp::ErrorCode::ServerCancelled, "server not yet received configuration for diagnostics", cancellationData);
+        }
 
-    client->workspaceDiagnosticsToken = params.partialResultToken;
-    if (params.partialResultToken)
-    {
-        // Send the initial report as a partial result, and allow streaming of further results
-        client->sendProgress({params.partialResultToken.value(), fullReport});
-        return std::nullopt;
-    }
-    else
-    {
-        return fullReport;
+        // Don't compute any workspace diagnostics for null workspace
+        if (workspace->isNullWorkspace())
+            continue;
+
+        auto config = client->getConfiguration(workspace->rootUri);
+        auto files = workspace->workspaceDiagnosticsFiles(config);
+        pending->push_back(WorkspaceFiles{workspace, std::move(config), std::move(files)});
     }
+
+    // This request has partial request support.
+    // If a partial result token is given, each file's report is streamed as a progress notification and the request is left open
+    // so that further results can be streamed. Otherwise, the reports are collected and sent as a single response once complete
+    auto partialResultToken = params.partialResultToken;
+    client->workspaceDiagnosticsToken = partialResultToken;
+    if (partialResultToken)
+        client->workspaceDiagnosticsRequestId = id;
+
+    // Files are checked as resumable background steps, so that interactive requests can be handled in between batches.
+    // The request is only finished by the last step, so its latency and output are counted from there
+    auto fullReport = std::make_shared<lsp::WorkspaceDiagnosticReport>();
+    backgroundScheduler.schedule("workspace/diagnostic:" + json(id).dump(),
+        deferResponse(
+            [this, id, pending, partialResultToken, cancellationToken, fullReport, workspaceIndex = size_t(0), fileIndex = size_t(0)]() mutable
+            {
+                // The streamed request has since been terminated or replaced by a newer request
+                if (partialResultToken && client->workspaceDiagnosticsToken != partialResultToken)
+                    return false;
+
+                try
+                {
+                    throwIfCancelled(cancellationToken);
+
+                    while (workspaceIndex < pending->size() && fileIndex >= pending->at(workspaceIndex).files.size())
+                    {
+                        workspaceIndex++;
+                        fileIndex = 0;
+                    }
+
+                    if (workspaceIndex < pending->size())
+                    {
+                        auto& [workspace, config, files] = pending->at(workspaceIndex);
+
+                        // Files are checked a batch at a time, in parallel, and then one report is computed per step from the results.
+                        // Reports are sent in file order, no matter the order the checks finish in
+                        if (fileIndex % kWorkspaceCheckBatchSize == 0)
+                            workspace->checkWorkspaceFiles(checkBatch(files, fileIndex), config, cancellationToken);
+
+                        if (auto documentReport = workspace->workspaceDocumentDiagnostics(files.at(fileIndex++), config))
+                        {
+                            if (partialResultToken)
+                                client->sendProgress(
+                                    {*partialResultToken, lsp::WorkspaceDiagnosticReportPartialResult{{std::move(*documentReport)}}});
+                            else
+                                fullReport->items.emplace_back(std::move(*documentReport));
+                        }
+
+                        if (workspaceIndex + 1 < pending->size() || fileIndex < files.size())
+                            return true;
+                    }
+                }
+                catch (const JsonRpcException& e)
+                {
+                    if (partialResultToken)
+                    {
+                        client->workspaceDiagnosticsRequestId = std::nullopt;
+                        client->workspaceDiagnosticsToken = std::nullopt;
+                    }
+                    client->sendError(id, e);
+                    return false;
+                }
+
+                if (!partialResultToken)
+                    client->sendResponse(id, std::move(*fullReport));
+                return false;
+            }));
 }
 
 void Client::terminateWorkspaceDiagnostics(bool retriggerRequest)
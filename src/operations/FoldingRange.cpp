@@ -4,7 +4,8 @@ struct FoldingRangeVisitor : public Luau::AstVisitor
 {
     lsp::ClientCapabilities capabilities;
     const TextDocument* textDocument;
-    std::vector<lsp::FoldingRange> ranges{};
+    std::vector<Luau::Location> locations{};
+    std::vector<std::optional<lsp::FoldingRangeKind>> kinds{};
 
     explicit FoldingRangeVisitor(lsp::ClientCapabilities capabilities, const TextDocument* textDocument)
         : capabilities(std::move(capabilities))
@@ -14,29 +15,43 @@ struct FoldingRangeVisitor : public Luau::AstVisitor
 
     void addFoldingRange(const Luau::Position& start, const Luau::Position& end, std::optional<lsp::FoldingRangeKind> kind = std::nullopt)
     {
-        lsp::FoldingRange range{};
-
-        auto startPosition = textDocument->convertPosition(start);
-        auto endPosition = textDocument->convertPosition(end);
+        locations.emplace_back(start, end);
+        kinds.emplace_back(kind);
+    }
 
-        range.kind = kind;
-        range.startLine = startPosition.line;
-        range.startCharacter = startPosition.character;
+    /// Converts all the collected ranges at once, which is cheaper than converting them whilst visiting
+    std::vector<lsp::FoldingRange> getRanges() const
+    {
+        bool lineFoldingOnly =
+            capabilities.textDocument && capabilities.textDocument->foldingRange && capabilities.textDocument->foldingRange->lineFoldingOnly;
+        auto convertedRanges = textDocument->convertLocations(locations);
 
-        // We want to keep the closing token visible to make it clear what range is being folded
-        // but if the client only supports line folding only, we need to use the previous line
-        if (capabilities.textDocument && capabilities.textDocument->foldingRange && capabilities.textDocument->foldingRange->lineFoldingOnly &&
-            endPosition.line > startPosition.line)
+        std::vector<lsp::FoldingRange> ranges;
+        ranges.reserve(convertedRanges.size());
+        for (size_t i = 0; i < convertedRanges.size(); i++)
         {
-            range.endLine = endPosition.line - 1;
-        }
-        else
-        {
-            range.endLine = endPosition.line;
-            range.endCharacter = endPosition.character;
-        }
+            const auto& [startPosition, endPosition] = convertedRanges[i];
+            lsp::FoldingRange range{};
+
+            range.kind = kinds[i];
+            range.startLine = startPosition.line;
+            range.startCharacter = startPosition.character;
 
-        ranges.push_back(range);
+            // We want to keep the closing token visible to make it clear what range is being folded
+            // but if the client only supports line folding only, we need to use the previous line
+            if (lineFoldingOnly && endPosition.line > startPosition.line)
+            {
+                range.endLine = endPosition.line - 1;
+            }
+            else
+            {
+                range.endLine = endPosition.line;
+                range.endCharacter = endPosition.character;
+            }
+
+            ranges.push_back(range);
+        }
+        return ranges;
     }
 
     bool visit(Luau::AstExprCall* call) override
@@ -139,6 +154,5 @@ std::vector<lsp::FoldingRange> WorkspaceFolder::foldingRange(const lsp::FoldingR
         }
     }
 
-
-    return visitor.ranges;
+    return visitor.getRanges();
 }
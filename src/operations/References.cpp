@@ -20,41 +20,114 @@ static bool isSameTable(const Luau::TypeId a, const Luau::TypeId b)
     return false;
 }
 
-// Find all reverse dependencies of the top-level module
-// NOTE: this function is quite expensive as it requires a BFS
-// TODO: this comes from `markDirty`
+void WorkspaceFolder::syncDependencyGraph()
+{
+    auto setDependencies = [this](InternedId moduleId, const Luau::SourceNode& node)
+    {
+        std::vector<InternedId> dependencies;
+        dependencies.reserve(node.requireSet.size());
+        for (const auto& dependency : node.requireSet)
+            dependencies.push_back(moduleNames.intern(dependency));
+        dependencyGraph.setDependencies(moduleId, std::move(dependencies));
+    };
+
+    if (!dependencyGraph.isPopulated())
+    {
+        dependencyGraph.takeStale();
+        for (const auto& [name, node] : frontend.sourceNodes)
+            setDependencies(moduleNames.intern(name), *node);
+        dependencyGraph.markPopulated();
+        return;
+    }
+
+    for (auto moduleId : dependencyGraph.takeStale())
+    {
+        auto it = frontend.sourceNodes.find(moduleNames.lookup(moduleId));
+        if (it != frontend.sourceNodes.end())
+            setDependencies(moduleId, *it->second);
+        else
+            dependencyGraph.setDependencies(moduleId, {});
+    }
+}
+
+// Find all reverse dependencies of the top-level module, including the module itself
 std::vector<Luau::ModuleName> WorkspaceFolder::findReverseDependencies(const Luau::ModuleName& moduleName)
 {
+    syncDependencyGraph();
+
     std::vector<Luau::ModuleName> dependents{};
-    std::unordered_map<Luau::ModuleName, std::vector<Luau::ModuleName>> reverseDeps;
-    for (const auto& module : frontend.sourceNodes)
+    for (auto moduleId : dependencyGraph.transitiveDependents(moduleNames.intern(moduleName)))
+        dependents.push_back(moduleNames.lookup(moduleId));
+    return dependents;
+}
+
+/// Collects the names mentioned in a module, for the identifier index
+struct IdentifierCollector : public Luau::AstVisitor
+{
+    std::vector<std::string_view> identifiers;
+
+    bool visit(Luau::AstExprLocal* node) override
     {
-        for (const auto& dep : module.second->requireSet)
-            reverseDeps[dep].push_back(module.first);
+        identifiers.emplace_back(node->local->name.value);
+        return true;
     }
-    std::vector<Luau::ModuleName> queue{moduleName};
-    while (!queue.empty())
+
+    bool visit(Luau::AstExprGlobal* node) override
     {
-        Luau::ModuleName next = std::move(queue.back());
-        queue.pop_back();
+        identifiers.emplace_back(node->name.value);
+        return true;
+    }
 
-        // TODO: maybe do a set-lookup instead?
-        if (contains(dependents, next))
-            continue;
+    bool visit(Luau::AstExprIndexName* node) override
+    {
+        identifiers.emplace_back(node->index.value);
+        return true;
+    }
 
-        dependents.push_back(next);
+    bool visit(Luau::AstExprConstantString* node) override
+    {
+        identifiers.emplace_back(node->value.data, node->value.size);
+        return true;
+    }
 
-        if (0 == reverseDeps.count(next))
-            continue;
+    bool visit(Luau::AstType* node) override
+    {
+        return true;
+    }
 
-        const std::vector<Luau::ModuleName>& dependents = reverseDeps[next];
-        queue.insert(queue.end(), dependents.begin(), dependents.end());
+    bool visit(Luau::AstTypeReference* node) override
+    {
+        identifiers.emplace_back(node->name.value);
+        if (node->prefix)
+            identifiers.emplace_back(node->prefix->value);
+        return true;
     }
-    return dependents;
+};
+
+bool WorkspaceFolder::moduleMentions(const Luau::ModuleName& moduleName, std::string_view name)
+{
+    // Make sure the source module is up to date. This does nothing if the module has not changed since it was last parsed
+    frontend.parse(moduleName);
+    identifierIndex.dropStale();
+
+    InternedId moduleId = moduleNames.intern(moduleName);
+    if (!identifierIndex.isIndexed(moduleId))
+    {
+        auto sourceModule = frontend.getSourceModule(moduleName);
+        if (!sourceModule || !sourceModule->root)
+            return true;
+
+        IdentifierCollector collector;
+        sourceModule->root->visit(&collector);
+        identifierIndex.setModule(moduleId, collector.identifiers);
+    }
+
+    return identifierIndex.mentions(moduleId, name);
 }
 
 // Find all references across all files for the usage of TableType, or a property on a TableType
-std::vector<Reference> WorkspaceFolder::findAllReferences(Luau::TypeId ty, std::optional<Luau::Name> property)
+std::vector<Reference> WorkspaceFolder::findAllReferences(
+    Luau::TypeId ty, std::optional<Luau::Name> property, const LSPCancellationToken& cancellationToken)
 {
     ty = Luau::follow(ty);
     auto ttv = Luau::get<Luau::TableType>(ty);
@@ -71,6 +144,13 @@ std::vector<Reference> WorkspaceFolder::findAllReferences(Luau::TypeId ty, std::
     // For every module, search for its referencing
     for (const auto& moduleName : dependents)
     {
+        throwIfCancelled(cancellationToken);
+        InternedId moduleId = moduleNames.intern(moduleName);
+
+        // References to a property always mention its name, so there is no need to typecheck modules which don't
+        if (property && !moduleMentions(moduleName, *property))
+            continue;
+
         // Run the typechecker over the dependency modules
         checkStrict(moduleName);
         auto module = getModule(moduleName, /* forAutocomplete: */ true);
@@ -87,7 +167,7 @@ std::vector<Reference> WorkspaceFolder::findAllReferences(Luau::TypeId ty, std::
                 {
                     auto possibleParentTy = module->astTypes.find(indexName->expr);
                     if (possibleParentTy && isSameTable(ty, Luau::follow(*possibleParentTy)))
-                        references.push_back(Reference{moduleName, indexName->indexLocation});
+                        references.push_back(Reference{moduleId, indexName->indexLocation});
                 }
                 else if (auto table = expr->as<Luau::AstExprTable>(); table && isSameTable(ty, Luau::follow(referencedTy)))
                 {
@@ -98,7 +178,7 @@ std::vector<Reference> WorkspaceFolder::findAllReferences(Luau::TypeId ty, std::
                             if (auto propName = item.key->as<Luau::AstExprConstantString>())
                             {
                                 if (propName->value.data == property.value())
-                                    references.push_back(Reference{moduleName, item.key->location});
+                                    references.push_back(Reference{moduleId, item.key->location});
                             }
                         }
                     }
@@ -107,7 +187,7 @@ std::vector<Reference> WorkspaceFolder::findAllReferences(Luau::TypeId ty, std::
             else
             {
                 if (isSameTable(ty, Luau::follow(referencedTy)))
-                    references.push_back(Reference{moduleName, expr->location});
+                    references.push_back(Reference{moduleId, expr->location});
             }
         }
     }
@@ -120,7 +200,8 @@ std::vector<Reference> WorkspaceFolder::findAllReferences(Luau::TypeId ty, std::
             auto [baseTy, prop] = propInformation.value();
             if (prop.location)
             {
-                auto reference = Reference{Luau::getDefinitionModuleName(baseTy).value_or(ttv->definitionModuleName), prop.location.value()};
+                auto reference = Reference{
+                    moduleNames.intern(Luau::getDefinitionModuleName(baseTy).value_or(ttv->definitionModuleName)), prop.location.value()};
                 if (!contains(references, reference))
                     references.push_back(reference);
             }
@@ -131,7 +212,8 @@ std::vector<Reference> WorkspaceFolder::findAllReferences(Luau::TypeId ty, std::
 }
 
 // Find all references of an exported type
-std::vector<Reference> WorkspaceFolder::findAllTypeReferences(const Luau::ModuleName& moduleName, const Luau::Name& typeName)
+std::vector<Reference> WorkspaceFolder::findAllTypeReferences(
+    const Luau::ModuleName& moduleName, const Luau::Name& typeName, const LSPCancellationToken& cancellationToken)
 {
     std::vector<Reference> result;
 
@@ -140,10 +222,11 @@ std::vector<Reference> WorkspaceFolder::findAllTypeReferences(const Luau::Module
     if (!sourceModule)
         return {};
 
+    InternedId moduleId = moduleNames.intern(moduleName);
     auto references = findTypeReferences(*sourceModule, typeName, std::nullopt);
     result.reserve(references.size() + 1);
     for (auto& location : references)
-        result.emplace_back(Reference{moduleName, location});
+        result.emplace_back(Reference{moduleId, location});
 
     // Find the actual declaration location
     checkStrict(moduleName);
@@ -153,7 +236,7 @@ std::vector<Reference> WorkspaceFolder::findAllTypeReferences(const Luau::Module
 
     if (auto location = module->getModuleScope()->typeAliasNameLocations.find(typeName);
         location != module->getModuleScope()->typeAliasNameLocations.end())
-        result.emplace_back(Reference{moduleName, location->second});
+        result.emplace_back(Reference{moduleId, location->second});
 
     // Find all cross-module references
     auto reverseDependencies = findReverseDependencies(moduleName);
@@ -163,6 +246,12 @@ std::vector<Reference> WorkspaceFolder::findAllTypeReferences(const Luau::Module
         if (dependencyModuleName == moduleName)
             continue;
 
+        throwIfCancelled(cancellationToken);
+
+        // A module can only refer to the type by name
+        if (!moduleMentions(dependencyModuleName, typeName))
+            continue;
+
         // Run the typechecker over the dependency module
         checkStrict(dependencyModuleName);
         auto sourceModule = frontend.getSourceModule(dependencyModuleName);
@@ -183,39 +272,54 @@ std::vector<Reference> WorkspaceFolder::findAllTypeReferences(const Luau::Module
             if (importName.empty())
                 continue;
 
+            InternedId dependencyModuleId = moduleNames.intern(dependencyModuleName);
             auto references = findTypeReferences(*sourceModule, typeName, importName);
             result.reserve(result.size() + references.size());
             for (auto& location : references)
-                result.emplace_back(Reference{dependencyModuleName, location});
+                result.emplace_back(Reference{dependencyModuleId, location});
         }
     }
 
     return result;
 }
 
-static std::vector<lsp::Location> processReferences(WorkspaceFileResolver& fileResolver, const std::vector<Reference>& references)
+static void appendLocations(
+    std::vector<lsp::Location>& result, const TextDocument* textDocument, const lsp::DocumentUri& uri, const std::vector<Luau::Location>& locations)
 {
-    std::vector<lsp::Location> result{};
+    result.reserve(result.size() + locations.size());
+    for (auto& range : textDocument->convertLocations(locations))
+        result.emplace_back(lsp::Location{uri, range});
+}
 
+static std::vector<lsp::Location> processReferences(
+    WorkspaceFileResolver& fileResolver, const StringInterner& moduleNames, const std::vector<Reference>& references)
+{
+    // Group the references by module, so that each module's text document is only created (possibly reading the file from disk) once,
+    // and its positions are converted together. Modules are kept in the order they first appear in the references
+    std::vector<InternedId> moduleOrder;
+    std::unordered_map<InternedId, std::vector<Luau::Location>> locationsByModule;
     for (const auto& reference : references)
     {
-        if (auto refTextDocument = fileResolver.getTextDocumentFromModuleName(reference.moduleName))
-        {
-            result.emplace_back(lsp::Location{refTextDocument->uri(),
-                {refTextDocument->convertPosition(reference.location.begin), refTextDocument->convertPosition(reference.location.end)}});
-        }
-        else
-        {
-            if (auto filePath = fileResolver.platform->resolveToRealPath(reference.moduleName))
+        auto& locations = locationsByModule[reference.moduleId];
+        if (locations.empty())
+            moduleOrder.push_back(reference.moduleId);
+        locations.push_back(reference.location);
+    }
+
+    std::vector<lsp::Location> result{};
+    result.reserve(references.size());
+
+    for (const auto& moduleId : moduleOrder)
+    {
+        auto& locations = locationsByModule[moduleId];
+        std::sort(locations.begin(), locations.end(),
+            [](const Luau::Location& a, const Luau::Location& b)
             {
-                if (auto source = fileResolver.readSource(reference.moduleName))
-                {
-                    auto refTextDocument = TextDocument{Uri::file(*filePath), "luau", 0, source->source};
-                    result.emplace_back(lsp::Location{refTextDocument.uri(),
-                        {refTextDocument.convertPosition(reference.location.begin), refTextDocument.convertPosition(reference.location.end)}});
-                }
-            }
-        }
+                return a.begin < b.begin;
+            });
+
+        if (auto refTextDocument = fileResolver.getOrCreateTextDocumentFromModuleName(moduleNames.lookup(moduleId)))
+            appendLocations(result, refTextDocument.get(), refTextDocument->uri(), locations);
     }
 
     return result;
@@ -342,9 +446,7 @@ bool handleIfTypeReferenceByName(Luau::AstNode* node, Luau::AstArray<Luau::AstGe
     FindTypeParameterUsages visitor(name);
     node->visit(&visitor);
 
-    for (auto& location : visitor.result)
-        result.emplace_back(
-            lsp::Location{textDocument->uri(), {textDocument->convertPosition(location.begin), textDocument->convertPosition(location.end)}});
+    appendLocations(result, textDocument, textDocument->uri(), visitor.result);
 
     return true;
 }
@@ -381,14 +483,12 @@ bool handleIfTypeReferenceByPosition(Luau::AstNode* node, Luau::AstArray<Luau::A
     FindTypeParameterUsages visitor(name);
     node->visit(&visitor);
 
-    for (auto& location : visitor.result)
-        result.emplace_back(
-            lsp::Location{textDocument->uri(), {textDocument->convertPosition(location.begin), textDocument->convertPosition(location.end)}});
+    appendLocations(result, textDocument, textDocument->uri(), visitor.result);
 
     return true;
 }
 
-lsp::ReferenceResult WorkspaceFolder::references(const lsp::ReferenceParams& params)
+lsp::ReferenceResult WorkspaceFolder::references(const lsp::ReferenceParams& params, const LSPCancellationToken& cancellationToken)
 {
     auto moduleName = fileResolver.getModuleName(params.textDocument.uri);
     auto textDocument = fileResolver.getTextDocument(params.textDocument.uri);
@@ -396,6 +496,9 @@ lsp::ReferenceResult WorkspaceFolder::references(const lsp::ReferenceParams& par
         throw JsonRpcException(lsp::ErrorCode::RequestFailed, "No managed text document for " + params.textDocument.uri.toString());
     auto position = textDocument->convertPosition(params.position);
 
+    // References are found by walking the require graph, so wait for indexing to complete to avoid partial results
+    finishIndexing(cancellationToken);
+
     // Run the type checker to ensure we are up to date
     // We check for autocomplete here since autocomplete has stricter types
     checkStrict(moduleName);
@@ -424,12 +527,7 @@ lsp::ReferenceResult WorkspaceFolder::references(const lsp::ReferenceParams& par
         // TODO: what if this symbol is returned! need to handle that so we can find cross-file references
         auto references = findSymbolReferences(*sourceModule, symbol);
 
-        result.reserve(references.size());
-        for (auto& location : references)
-        {
-            result.emplace_back(
-                lsp::Location{params.textDocument.uri, {textDocument->convertPosition(location.begin), textDocument->convertPosition(location.end)}});
-        }
+        appendLocations(result, textDocument, params.textDocument.uri, references);
 
         return result;
     }
@@ -444,8 +542,8 @@ lsp::ReferenceResult WorkspaceFolder::references(const lsp::ReferenceParams& par
             if (possibleParentTy)
             {
                 auto parentTy = Luau::follow(*possibleParentTy);
-                auto references = findAllReferences(parentTy, indexName->index.value);
-                return processReferences(fileResolver, references);
+                auto references = findAllReferences(parentTy, indexName->index.value, cancellationToken);
+                return processReferences(fileResolver, moduleNames, references);
             }
         }
         else if (auto constantString = expr->as<Luau::AstExprConstantString>())
@@ -460,9 +558,9 @@ lsp::ReferenceResult WorkspaceFolder::references(const lsp::ReferenceParams& par
                     auto possibleTableTy = module->astTypes.find(tbl);
                     if (possibleTableTy)
                     {
-                        auto references =
-                            findAllReferences(Luau::follow(*possibleTableTy), Luau::Name(constantString->value.data, constantString->value.size));
-                        return processReferences(fileResolver, references);
+                        auto references = findAllReferences(Luau::follow(*possibleTableTy),
+                            Luau::Name(constantString->value.data, constantString->value.size), cancellationToken);
+                        return processReferences(fileResolver, moduleNames, references);
                     }
                 }
             }
@@ -485,18 +583,15 @@ lsp::ReferenceResult WorkspaceFolder::references(const lsp::ReferenceParams& par
         if (typeDefinition->exported)
         {
             // Type may potentially be used in other files, so we need to handle this globally
-            auto references = findAllTypeReferences(moduleName, typeDefinition->name.value);
-            return processReferences(fileResolver, references);
+            auto references = findAllTypeReferences(moduleName, typeDefinition->name.value, cancellationToken);
+            return processReferences(fileResolver, moduleNames, references);
             ;
         }
         else
         {
             // Include all usages of the type
             auto references = findTypeReferences(*sourceModule, typeDefinition->name.value, std::nullopt);
-            result.reserve(references.size() + 1);
-            for (auto& location : references)
-                result.emplace_back(lsp::Location{
-                    params.textDocument.uri, {textDocument->convertPosition(location.begin), textDocument->convertPosition(location.end)}});
+            appendLocations(result, textDocument, params.textDocument.uri, references);
 
 
             // Include the type definition
@@ -513,8 +608,8 @@ lsp::ReferenceResult WorkspaceFolder::references(const lsp::ReferenceParams& par
             if (auto importedModuleName = module->getModuleScope()->importedModules.find(prefix.value().value);
                 importedModuleName != module->getModuleScope()->importedModules.end())
             {
-                auto references = findAllTypeReferences(importedModuleName->second, reference->name.value);
-                return processReferences(fileResolver, references);
+                auto references = findAllTypeReferences(importedModuleName->second, reference->name.value, cancellationToken);
+                return processReferences(fileResolver, moduleNames, references);
             }
 
             return std::nullopt;
@@ -551,10 +646,7 @@ lsp::ReferenceResult WorkspaceFolder::references(const lsp::ReferenceParams& par
             }
 
             auto references = findTypeReferences(*sourceModule, reference->name.value, std::nullopt);
-            result.reserve(references.size() + 1);
-            for (auto& location : references)
-                result.emplace_back(lsp::Location{
-                    params.textDocument.uri, {textDocument->convertPosition(location.begin), textDocument->convertPosition(location.end)}});
+            appendLocations(result, textDocument, params.textDocument.uri, references);
 
             // Find the actual declaration location
             auto scope = Luau::findScopeAtPosition(*module, position);
@@ -591,8 +683,8 @@ lsp::ReferenceResult WorkspaceFolder::references(const lsp::ReferenceParams& par
     return std::nullopt;
 }
 
-lsp::ReferenceResult LanguageServer::references(const lsp::ReferenceParams& params)
+lsp::ReferenceResult LanguageServer::references(const lsp::ReferenceParams& params, const LSPCancellationToken& cancellationToken)
 {
     auto workspace = findWorkspace(params.textDocument.uri);
-    return workspace->references(params);
+    return workspace->references(params, cancellationToken);
 }
@@ -21,7 +21,7 @@ static bool isGlobalBinding(const WorkspaceFolder* workspaceFolder, const lsp::R
     return false;
 }
 
-lsp::RenameResult WorkspaceFolder::rename(const lsp::RenameParams& params)
+lsp::RenameResult WorkspaceFolder::rename(const lsp::RenameParams& params, const LSPCancellationToken& cancellationToken)
 {
     // Verify the new name is valid (is an identifier)
     if (params.newName.length() == 0)
@@ -38,7 +38,7 @@ lsp::RenameResult WorkspaceFolder::rename(const lsp::RenameParams& params)
     referenceParams.textDocument = params.textDocument;
     referenceParams.position = params.position;
     referenceParams.context.includeDeclaration = true;
-    auto references = this->references(referenceParams);
+    auto references = this->references(referenceParams, cancellationToken);
 
     if (!references)
         throw JsonRpcException(lsp::ErrorCode::RequestFailed, "Unable to find symbol to rename");
@@ -59,8 +59,8 @@ lsp::RenameResult WorkspaceFolder::rename(const lsp::RenameParams& params)
     return result;
 }
 
-lsp::RenameResult LanguageServer::rename(const lsp::RenameParams& params)
+lsp::RenameResult LanguageServer::rename(const lsp::RenameParams& params, const LSPCancellationToken& cancellationToken)
 {
     auto workspace = findWorkspace(params.textDocument.uri);
-    return workspace->rename(params);
+    return workspace->rename(params, cancellationToken);
 }
@@ -370,13 +370,20 @@ std::vector<size_t> packTokens(const TextDocument* textDocument, std::vector<Sem
     std::vector<size_t> result{};
     result.reserve(tokens.size() * 5); // Each token will take up 5 slots in the result
 
+    // Convert all the positions in one sweep over the document
+    std::vector<Luau::Location> locations;
+    locations.reserve(tokens.size());
+    for (const auto& token : tokens)
+        locations.emplace_back(token.start, token.end);
+    auto ranges = textDocument->convertLocations(locations);
+
     size_t lastLine = 0;
     size_t lastChar = 0;
 
-    for (auto& token : tokens)
+    for (size_t i = 0; i < tokens.size(); i++)
     {
-        auto start = textDocument->convertPosition(token.start);
-        auto end = textDocument->convertPosition(token.end);
+        const auto& token = tokens[i];
+        const auto& [start, end] = ranges[i];
 
         auto line = start.line;
         auto startChar = start.character;
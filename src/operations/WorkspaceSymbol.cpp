@@ -1,5 +1,7 @@
+#include <unordered_map>
 #include <utility>
 
+#include "LSP/IndexCache.hpp"
 #include "LSP/LanguageServer.hpp"
 #include "LSP/Workspace.hpp"
 
@@ -8,89 +10,44 @@
 
 struct WorkspaceSymbolsVisitor : public Luau::AstVisitor
 {
-    const TextDocument* textDocument;
-    const std::string query;
-    std::vector<lsp::WorkspaceSymbol> symbols{};
+    std::vector<IndexedSymbol> symbols{};
 
-    explicit WorkspaceSymbolsVisitor(const TextDocument* textDocument, std::string query)
-        : textDocument(textDocument)
-        , query(std::move(toLower(query)))
+    void createLocalSymbol(Luau::AstLocal* local)
     {
-    }
-
-    bool matchesQuery(std::string symbolName)
-    {
-        return query.empty() || toLower(symbolName).find(query);
-    }
-
-    void createLocalSymbol(Luau::AstLocal* local, std::optional<std::string> containerName)
-    {
-        lsp::WorkspaceSymbol symbol;
-        symbol.name = local->name.value;
-        if (!matchesQuery(symbol.name))
-            return;
-
-        symbol.kind = lsp::SymbolKind::Variable;
-        symbol.location = {
-            textDocument->uri(), {textDocument->convertPosition(local->location.begin), textDocument->convertPosition(local->location.end)}};
-        symbol.containerName = std::move(containerName);
-        symbols.push_back(symbol);
+        symbols.push_back(IndexedSymbol{local->name.value, lsp::SymbolKind::Variable, local->location});
     }
 
     bool visit(Luau::AstStatLocal* local) override
     {
         for (size_t i = 0; i < local->vars.size; ++i)
-            createLocalSymbol(local->vars.data[i], std::nullopt);
+            createLocalSymbol(local->vars.data[i]);
         return false;
     }
 
     bool visit(Luau::AstStatFunction* function) override
     {
-        lsp::WorkspaceSymbol symbol;
-        symbol.name = Luau::toString(function->name);
-        trim(symbol.name);
-        if (!matchesQuery(symbol.name))
-            return true;
-
-        symbol.kind = function->func->self ? lsp::SymbolKind::Method : lsp::SymbolKind::Function;
-        symbol.location = {textDocument->uri(),
-            {textDocument->convertPosition(function->name->location.begin), textDocument->convertPosition(function->name->location.end)}};
-
+        std::string name = Luau::toString(function->name);
+        trim(name);
 
         // TODO: should we create symbols for the function parameters?
         // are they useful at the workspace level?
-
-        symbols.push_back(symbol);
+        symbols.push_back(
+            IndexedSymbol{std::move(name), function->func->self ? lsp::SymbolKind::Method : lsp::SymbolKind::Function, function->name->location});
         return true;
     }
 
     bool visit(Luau::AstStatLocalFunction* function) override
     {
-        lsp::WorkspaceSymbol symbol;
-        symbol.name = Luau::toString(function->name);
-        if (!matchesQuery(symbol.name))
-            return true;
-
-        symbol.kind = function->func->self ? lsp::SymbolKind::Method : lsp::SymbolKind::Function;
-        symbol.location = {textDocument->uri(),
-            {textDocument->convertPosition(function->name->location.begin), textDocument->convertPosition(function->name->location.end)}};
         // TODO: should we create symbols for the function parameters?
         // are they useful at the workspace level?
-        symbols.push_back(symbol);
+        symbols.push_back(IndexedSymbol{
+            Luau::toString(function->name), function->func->self ? lsp::SymbolKind::Method : lsp::SymbolKind::Function, function->name->location});
         return true;
     }
 
     bool visit(Luau::AstStatTypeAlias* alias) override
     {
-        lsp::WorkspaceSymbol symbol;
-        symbol.name = alias->name.value;
-        if (!matchesQuery(symbol.name))
-            return false;
-
-        symbol.kind = lsp::SymbolKind::Interface;
-        symbol.location = {
-            textDocument->uri(), {textDocument->convertPosition(alias->nameLocation.begin), textDocument->convertPosition(alias->nameLocation.end)}};
-        symbols.push_back(symbol);
+        symbols.push_back(IndexedSymbol{alias->name.value, lsp::SymbolKind::Interface, alias->nameLocation});
         return false;
     }
 
@@ -103,34 +60,101 @@ struct WorkspaceSymbolsVisitor : public Luau::AstVisitor
     }
 };
 
-std::optional<std::vector<lsp::WorkspaceSymbol>> WorkspaceFolder::workspaceSymbol(const lsp::WorkspaceSymbolParams& params)
+/// Finds the string passed to each `require("...")` call
+struct StringRequireVisitor : public Luau::AstVisitor
 {
-    std::vector<lsp::WorkspaceSymbol> result;
+    std::vector<std::string> requiredStrings{};
 
-    for (const auto& [moduleName, sourceModule] : frontend.sourceModules)
+    bool visit(Luau::AstExprCall* call) override
     {
-        frontend.parse(moduleName);
+        if (auto global = call->func->as<Luau::AstExprGlobal>(); global && global->name == "require" && call->args.size >= 1)
+            if (auto string = call->args.data[0]->as<Luau::AstExprConstantString>())
+                requiredStrings.emplace_back(string->value.data, string->value.size);
+        return true;
+    }
+};
+
+IndexedModule indexModule(const Luau::SourceNode& sourceNode, const Luau::SourceModule& sourceModule, uint64_t contentHash, LSPPlatform& platform)
+{
+    IndexedModule result;
+    result.contentHash = contentHash;
+    result.requireLocations = sourceNode.requireLocations;
+
+    if (!sourceModule.root)
+        return result;
+
+    for (Luau::AstStat* stat : sourceModule.root->body)
+        if (auto alias = stat->as<Luau::AstStatTypeAlias>(); alias && alias->exported)
+            result.exportedTypes.emplace_back(alias->name.value);
 
-        // Find relevant text document
-        if (auto textDocument = fileResolver.getTextDocumentFromModuleName(moduleName))
+    WorkspaceSymbolsVisitor visitor;
+    visitor.visit(sourceModule.root);
+    result.symbols = std::move(visitor.symbols);
+
+    StringRequireVisitor requireVisitor;
+    sourceModule.root->visit(&requireVisitor);
+    Luau::ModuleInfo context{sourceNode.name};
+    for (auto& requiredString : requireVisitor.requiredStrings)
+    {
+        auto resolved = platform.resolveStringRequire(&context, requiredString);
+        result.stringRequires.emplace_back(std::move(requiredString), resolved ? resolved->name : "");
+    }
+
+    return result;
+}
+
+/// The most symbols returned for a query. Clients filter and rank the results themselves as the query is typed, so the best matches are
+/// enough and sending every symbol in a large workspace for a short query only slows the client down
+static constexpr size_t kMaxWorkspaceSymbols = 256;
+
+std::optional<std::vector<lsp::WorkspaceSymbol>> WorkspaceFolder::workspaceSymbol(const lsp::WorkspaceSymbolParams& params)
+{
+    // Bring modules which have been re-parsed or loaded since they were indexed up to date. Modules which are only known
+    // from the index cache have their symbols from their summary, so they do not need to be parsed here
+    for (auto moduleId : symbolIndex.takeStale())
+    {
+        const auto& moduleName = moduleNames.lookup(moduleId);
+        if (!frontend.sourceNodes.count(moduleName))
         {
-            WorkspaceSymbolsVisitor visitor{textDocument, params.query};
-            visitor.visit(sourceModule->root);
-            result.insert(result.end(), std::make_move_iterator(visitor.symbols.begin()), std::make_move_iterator(visitor.symbols.end()));
+            symbolIndex.removeModule(moduleId);
+            continue;
         }
-        else
+
+        frontend.parse(moduleName);
+        auto sourceModule = frontend.getSourceModule(moduleName);
+        if (!sourceModule || !sourceModule->root)
         {
-            if (auto filePath = platform->resolveToRealPath(moduleName))
-            {
-                if (auto source = fileResolver.readSource(moduleName))
-                {
-                    auto textDocument = TextDocument{Uri::file(*filePath), "luau", 0, source->source};
-                    WorkspaceSymbolsVisitor visitor{&textDocument, params.query};
-                    visitor.visit(sourceModule->root);
-                    result.insert(result.end(), std::make_move_iterator(visitor.symbols.begin()), std::make_move_iterator(visitor.symbols.end()));
-                }
-            }
+            symbolIndex.removeModule(moduleId);
+            continue;
         }
+
+        WorkspaceSymbolsVisitor visitor;
+        visitor.visit(sourceModule->root);
+        symbolIndex.setModule(moduleId, visitor.symbols);
+    }
+
+    auto matches = symbolIndex.search(params.query, kMaxWorkspaceSymbols);
+
+    // Each module's text document is needed to convert positions, so it is only created once for all of its symbols
+    std::unordered_map<InternedId, TextDocumentPtr> textDocuments;
+    std::vector<lsp::WorkspaceSymbol> result;
+    result.reserve(matches.size());
+    for (auto& match : matches)
+    {
+        auto it = textDocuments.find(match.module);
+        if (it == textDocuments.end())
+            it = textDocuments.emplace(match.module, fileResolver.getOrCreateTextDocumentFromModuleName(moduleNames.lookup(match.module))).first;
+
+        const auto& textDocument = it->second;
+        if (!textDocument)
+            continue;
+
+        lsp::WorkspaceSymbol workspaceSymbol;
+        workspaceSymbol.name = std::move(match.symbol.name);
+        workspaceSymbol.kind = match.symbol.kind;
+        workspaceSymbol.location = {textDocument->uri(),
+            {textDocument->convertPosition(match.symbol.location.begin), textDocument->convertPosition(match.symbol.location.end)}};
+        result.push_back(std::move(workspaceSymbol));
     }
 
     return result;
@@ -23,7 +23,7 @@ std::unique_ptr<LSPPlatform> LSPPlatform::getPlatform(
 
 std::optional<std::string> LSPPlatform::readSourceCode(const Luau::ModuleName& name, const std::filesystem::path& path) const
 {
-    if (auto textDocument = fileResolver->getTextDocumentFromModuleName(name))
+    if (auto textDocument = fileResolver->getTextDocumentSnapshotFromModuleName(name))
         return textDocument->getText();
 
     if (path.extension() == ".lua" || path.extension() == ".luau")
@@ -87,11 +87,10 @@ std::optional<Luau::ModuleInfo> LSPPlatform::resolveStringRequire(const Luau::Mo
         }
     }
 
-    std::error_code ec;
-    filePath = std::filesystem::weakly_canonical(filePath, ec);
+    filePath = fileResolver->fileSystem->weaklyCanonical(filePath).value_or(std::filesystem::path{});
 
     // Handle "init.luau" files in a directory
-    if (std::filesystem::is_directory(filePath, ec))
+    if (fileResolver->fileSystem->isDirectory(filePath))
     {
         filePath /= "init";
     }
@@ -100,7 +99,7 @@ std::optional<Luau::ModuleInfo> LSPPlatform::resolveStringRequire(const Luau::Mo
     if (filePath.extension() != ".luau" && filePath.extension() != ".lua")
     {
         auto fullFilePath = filePath.string() + ".luau";
-        if (!std::filesystem::exists(fullFilePath))
+        if (!fileResolver->fileSystem->exists(fullFilePath))
             // fall back to .lua if a module with .luau doesn't exist
             filePath = filePath.string() + ".lua";
         else
@@ -108,7 +107,7 @@ std::optional<Luau::ModuleInfo> LSPPlatform::resolveStringRequire(const Luau::Mo
     }
 
     // URI-ify the file path so that its normalised (in particular, the drive letter)
-    auto uri = Uri::parse(Uri::file(filePath).toString());
+    auto uri = Uri::normalisedFile(filePath);
 
     return Luau::ModuleInfo{fileResolver->getModuleName(uri)};
 }
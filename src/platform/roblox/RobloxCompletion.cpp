@@ -382,7 +382,7 @@ void RobloxPlatform::handleSuggestImports(const TextDocument& textDocument, cons
             if (path == module.name || node->className != "ModuleScript" || importsVisitor.containsRequire(name))
                 continue;
             if (auto scriptFilePath = getRealPathFromSourceNode(node);
-                scriptFilePath && workspaceFolder->isIgnoredFileForAutoImports(*scriptFilePath, config))
+                scriptFilePath && workspaceFolder->isIgnoredFileForAutoImports(*scriptFilePath))
                 continue;
 
             std::string requirePath;
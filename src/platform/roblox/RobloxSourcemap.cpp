@@ -1,6 +1,7 @@
 #include "Luau/TypeFwd.h"
 #include "Platform/RobloxPlatform.hpp"
 
+#include "LSP/IndexCache.hpp"
 #include "LSP/Workspace.hpp"
 #include "Luau/BuiltinDefinitions.h"
 #include "Luau/ConstraintSolver.h"
@@ -295,6 +296,9 @@ bool RobloxPlatform::updateSourceMapFromContents(const std::string& sourceMapCon
     workspaceFolder->client->sendTrace("Sourcemap file read successfully");
 
     workspaceFolder->frontend.clear();
+    workspaceFolder->dependencyGraph.clear();
+    workspaceFolder->identifierIndex.clear();
+    workspaceFolder->symbolIndex.clear();
     updateSourceNodeMap(sourceMapContents);
 
     workspaceFolder->client->sendTrace("Loaded sourcemap nodes");
@@ -368,6 +372,7 @@ void RobloxPlatform::updateSourceNodeMap(const std::string& sourceMapContents)
 {
     realPathsToSourceNodes.clear();
     virtualPathsToSourceNodes.clear();
+    sourceMapHash = hashIndexContent(sourceMapContents);
 
     try
     {
@@ -489,6 +494,12 @@ void RobloxPlatform::handleSourcemapUpdate(Luau::Frontend& frontend, const Luau:
     };
 }
 
+bool RobloxPlatform::supportsParallelTypeChecking(const ClientConfiguration& config) const
+{
+    // With expressive types, checking a module creates the types of the instances it refers to in the shared `instanceTypes` arena
+    return !config.diagnostics.strictDatamodelTypes && !FFlag::LuauSolverV2;
+}
+
 std::optional<SourceNodePtr> RobloxPlatform::getSourceNodeFromVirtualPath(const Luau::ModuleName& name) const
 {
     if (virtualPathsToSourceNodes.find(name) == virtualPathsToSourceNodes.end())
@@ -496,15 +507,20 @@ std::optional<SourceNodePtr> RobloxPlatform::getSourceNodeFromVirtualPath(const
     return virtualPathsToSourceNodes.at(name);
 }
 
-std::optional<SourceNodePtr> RobloxPlatform::getSourceNodeFromRealPath(const std::string& name) const
+std::optional<std::filesystem::path> RobloxPlatform::canonicaliseRealPath(const std::filesystem::path& path) const
 {
-    std::error_code ec;
-    auto canonicalName = std::filesystem::weakly_canonical(name, ec);
-    if (ec.value() != 0)
-        canonicalName = name;
+    auto canonicalName = fileResolver->fileSystem->weaklyCanonical(path);
+    if (!canonicalName)
+        return std::nullopt;
+
     // URI-ify the file path so that its normalised (in particular, the drive letter)
-    canonicalName = Uri::parse(Uri::file(canonicalName).toString()).fsPath();
-    auto strName = canonicalName.generic_string();
+    return Uri::normalisedFile(*canonicalName).fsPath();
+}
+
+std::optional<SourceNodePtr> RobloxPlatform::getSourceNodeFromRealPath(const std::string& name) const
+{
+    auto canonicalName = canonicaliseRealPath(name);
+    auto strName = (canonicalName ? *canonicalName : Uri::normalisedFile(name).fsPath()).generic_string();
     if (realPathsToSourceNodes.find(strName) == realPathsToSourceNodes.end())
         return std::nullopt;
     return realPathsToSourceNodes.at(strName);
@@ -522,12 +538,9 @@ std::optional<std::filesystem::path> RobloxPlatform::getRealPathFromSourceNode(c
     // TODO: make sure this is correct once we make sourcemap.json generic
     if (auto filePath = sourceNode->getScriptFilePath())
     {
-        std::error_code ec;
-        auto canonicalName = std::filesystem::weakly_canonical(fileResolver->rootUri.fsPath() / *filePath, ec);
-        if (ec.value() != 0)
-            canonicalName = *filePath;
-        // URI-ify the file path so that its normalised (in particular, the drive letter)
-        return Uri::parse(Uri::file(canonicalName).toString()).fsPath();
+        if (auto canonicalName = canonicaliseRealPath(fileResolver->rootUri.fsPath() / *filePath))
+            return canonicalName;
+        return Uri::normalisedFile(*filePath).fsPath();
     }
 
     return std::nullopt;
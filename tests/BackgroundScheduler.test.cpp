@@ -0,0 +1,132 @@
+#include "doctest.h"
+#include "LSP/BackgroundScheduler.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+static BackgroundTask makeCountingTask(std::vector<std::string>& log, const std::string& name, size_t steps)
+{
+    return [&log, name, steps, index = size_t(0)]() mutable
+    {
+        log.push_back(name + std::to_string(index++));
+        return index < steps;
+    };
+}
+
+TEST_SUITE_BEGIN("BackgroundScheduler");
+
+TEST_CASE("tasks_run_a_single_step_at_a_time")
+{
+    std::vector<std::string> log;
+    BackgroundScheduler scheduler;
+    scheduler.schedule("a", makeCountingTask(log, "a", 3));
+
+    scheduler.runStep();
+    CHECK_EQ(log, std::vector<std::string>{"a0"});
+    CHECK_FALSE(scheduler.empty());
+
+    scheduler.runStep();
+    scheduler.runStep();
+    CHECK_EQ(log, std::vector<std::string>{"a0", "a1", "a2"});
+    CHECK(scheduler.empty());
+}
+
+TEST_CASE("multiple_tasks_are_interleaved")
+{
+    std::vector<std::string> log;
+    BackgroundScheduler scheduler;
+    scheduler.schedule("a", makeCountingTask(log, "a", 2));
+    scheduler.schedule("b", makeCountingTask(log, "b", 3));
+    scheduler.runAll();
+
+    CHECK_EQ(log, std::vector<std::string>{"a0", "b0", "a1", "b1", "b2"});
+}
+
+TEST_CASE("scheduling_an_existing_key_replaces_the_pending_task")
+{
+    std::vector<std::string> log;
+    BackgroundScheduler scheduler;
+    scheduler.schedule("a", makeCountingTask(log, "old", 3));
+    scheduler.schedule("b", makeCountingTask(log, "b", 1));
+    scheduler.runStep();
+    scheduler.schedule("a", makeCountingTask(log, "new", 1));
+    CHECK_EQ(scheduler.size(), 2);
+
+    scheduler.runAll();
+    CHECK_EQ(log, std::vector<std::string>{"old0", "b0", "new0"});
+}
+
+TEST_CASE("a_task_rescheduled_whilst_running_is_not_resumed")
+{
+    std::vector<std::string> log;
+    BackgroundScheduler scheduler;
+    scheduler.schedule("a",
+        [&]()
+        {
+            log.push_back("old");
+            scheduler.schedule("a", makeCountingTask(log, "new", 1));
+            return true;
+        });
+
+    scheduler.runAll();
+    CHECK_EQ(log, std::vector<std::string>{"old", "new0"});
+}
+
+TEST_CASE("cancel_removes_tasks_by_key_prefix")
+{
+    std::vector<std::string> log;
+    BackgroundScheduler scheduler;
+    scheduler.schedule("file:///a|index", makeCountingTask(log, "a", 1));
+    scheduler.schedule("file:///a|diagnostics", makeCountingTask(log, "a", 1));
+    scheduler.schedule("file:///b|index", makeCountingTask(log, "b", 1));
+
+    scheduler.cancel("file:///a|");
+    CHECK_EQ(scheduler.size(), 1);
+
+    scheduler.runAll();
+    CHECK_EQ(log, std::vector<std::string>{"b0"});
+}
+
+TEST_CASE("a_throwing_task_is_dropped")
+{
+    BackgroundScheduler scheduler;
+    scheduler.schedule("a",
+        []() -> bool
+        {
+            throw std::runtime_error("failed");
+        });
+
+    CHECK_THROWS_AS(scheduler.runStep(), std::runtime_error);
+    CHECK(scheduler.empty());
+}
+
+TEST_CASE("a_task_can_be_stepped_by_key")
+{
+    std::vector<std::string> log;
+    BackgroundScheduler scheduler;
+    scheduler.schedule("a", makeCountingTask(log, "a", 1));
+    scheduler.schedule("b", makeCountingTask(log, "b", 2));
+    scheduler.schedule("c", makeCountingTask(log, "c", 1));
+
+    CHECK(scheduler.runStep("b"));
+    CHECK_FALSE(scheduler.runStep("b"));
+    CHECK_FALSE(scheduler.runStep("missing"));
+    CHECK_EQ(log, std::vector<std::string>{"b0", "b1"});
+
+    scheduler.runAll();
+    CHECK_EQ(log, std::vector<std::string>{"b0", "b1", "a0", "c0"});
+}
+
+TEST_CASE("stepping_by_key_keeps_the_task_in_place")
+{
+    std::vector<std::string> log;
+    BackgroundScheduler scheduler;
+    scheduler.schedule("a", makeCountingTask(log, "a", 2));
+    scheduler.schedule("b", makeCountingTask(log, "b", 1));
+
+    CHECK(scheduler.runStep("a"));
+    scheduler.runStep();
+    CHECK_EQ(log, std::vector<std::string>{"a0", "a1"});
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,48 @@
+#include "doctest.h"
+#include "LSP/BoundedCache.hpp"
+
+#include <string>
+
+TEST_SUITE_BEGIN("BoundedCache");
+
+TEST_CASE("stores and replaces values")
+{
+    BoundedCache<std::string, int> cache(4);
+    CHECK_FALSE(cache.get("a"));
+
+    cache.put("a", 1);
+    cache.put("b", 2);
+    CHECK_EQ(cache.get("a"), 1);
+    CHECK_EQ(cache.get("b"), 2);
+
+    cache.put("a", 3);
+    CHECK_EQ(cache.get("a"), 3);
+    CHECK_EQ(cache.size(), 2);
+}
+
+TEST_CASE("evicts the least recently used entry once full")
+{
+    BoundedCache<std::string, int> cache(2);
+    cache.put("a", 1);
+    cache.put("b", 2);
+
+    // Using "a" makes "b" the least recently used
+    CHECK_EQ(cache.get("a"), 1);
+    cache.put("c", 3);
+
+    CHECK_EQ(cache.size(), 2);
+    CHECK_EQ(cache.get("a"), 1);
+    CHECK_FALSE(cache.get("b"));
+    CHECK_EQ(cache.get("c"), 3);
+}
+
+TEST_CASE("clear removes every entry")
+{
+    BoundedCache<std::string, int> cache(2);
+    cache.put("a", 1);
+    cache.clear();
+    CHECK_EQ(cache.size(), 0);
+    CHECK_FALSE(cache.get("a"));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,87 @@
+#include "doctest.h"
+#include "LSP/DependencyGraph.hpp"
+
+#include <algorithm>
+
+static std::vector<uint32_t> ids(std::vector<InternedId> modules, bool sorted = true)
+{
+    std::vector<uint32_t> result;
+    for (auto module : modules)
+        result.push_back(module.value);
+    if (sorted)
+        std::sort(result.begin(), result.end());
+    return result;
+}
+
+TEST_SUITE_BEGIN("DependencyGraph");
+
+TEST_CASE("transitive dependents follow requires in reverse")
+{
+    // 0 <- 1 <- 2 <- 3, and 0 <- 4
+    DependencyGraph graph;
+    graph.setDependencies({1}, {{0}});
+    graph.setDependencies({2}, {{1}});
+    graph.setDependencies({3}, {{2}, {1}});
+    graph.setDependencies({4}, {{0}});
+
+    auto dependents = graph.transitiveDependents({0});
+    CHECK_EQ(dependents.front().value, 0);
+    CHECK_EQ(ids(dependents), std::vector<uint32_t>{0, 1, 2, 3, 4});
+    CHECK_EQ(ids(graph.transitiveDependents({2})), std::vector<uint32_t>{2, 3});
+    CHECK_EQ(ids(graph.transitiveDependents({4})), std::vector<uint32_t>{4});
+
+    // Modules which have never been seen have no dependents
+    CHECK_EQ(ids(graph.transitiveDependents({10})), std::vector<uint32_t>{10});
+}
+
+TEST_CASE("cycles are visited once")
+{
+    DependencyGraph graph;
+    graph.setDependencies({0}, {{1}});
+    graph.setDependencies({1}, {{2}});
+    graph.setDependencies({2}, {{0}});
+
+    CHECK_EQ(ids(graph.transitiveDependents({1})), std::vector<uint32_t>{0, 1, 2});
+    CHECK_EQ(ids(graph.transitiveDependents({1})), std::vector<uint32_t>{0, 1, 2});
+}
+
+TEST_CASE("replacing dependencies updates the reverse edges")
+{
+    DependencyGraph graph;
+    graph.setDependencies({1}, {{0}, {2}, {0}});
+    CHECK_EQ(ids(graph.directDependencies({1})), std::vector<uint32_t>{0, 2});
+    CHECK_EQ(ids(graph.directDependents({0})), std::vector<uint32_t>{1});
+
+    graph.setDependencies({1}, {{2}, {3}});
+    CHECK(graph.directDependents({0}).empty());
+    CHECK_EQ(ids(graph.directDependents({2})), std::vector<uint32_t>{1});
+    CHECK_EQ(ids(graph.directDependents({3})), std::vector<uint32_t>{1});
+
+    graph.setDependencies({1}, {});
+    CHECK(graph.directDependents({2}).empty());
+    CHECK(graph.directDependents({3}).empty());
+    CHECK_EQ(ids(graph.transitiveDependents({3})), std::vector<uint32_t>{3});
+}
+
+TEST_CASE("invalidated modules are taken once")
+{
+    DependencyGraph graph;
+    CHECK_FALSE(graph.isPopulated());
+    graph.markPopulated();
+
+    graph.invalidate({5});
+    graph.invalidate({3});
+    for (size_t i = 0; i < 1000; i++)
+        graph.invalidate({5});
+    CHECK_EQ(ids(graph.takeStale()), std::vector<uint32_t>{3, 5});
+    CHECK(graph.takeStale().empty());
+
+    graph.setDependencies({1}, {{0}});
+    graph.invalidate({1});
+    graph.clear();
+    CHECK_FALSE(graph.isPopulated());
+    CHECK(graph.takeStale().empty());
+    CHECK(graph.directDependents({0}).empty());
+}
+
+TEST_SUITE_END();
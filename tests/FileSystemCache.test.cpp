@@ -0,0 +1,76 @@
+#include "doctest.h"
+#include "LSP/FileSystemCache.hpp"
+
+#include <fstream>
+
+TEST_SUITE_BEGIN("FileSystemCache");
+
+struct TemporaryDirectory
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "luau-lsp-file-system-cache-test";
+
+    TemporaryDirectory()
+    {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path / "folder");
+        std::ofstream(path / "folder" / "init.luau") << "return {}";
+    }
+
+    ~TemporaryDirectory()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+};
+
+TEST_CASE("answers lookups like std::filesystem")
+{
+    TemporaryDirectory directory;
+    FileSystemCache fileSystem;
+
+    CHECK(fileSystem.exists(directory.path / "folder"));
+    CHECK(fileSystem.isDirectory(directory.path / "folder"));
+    CHECK(fileSystem.exists(directory.path / "folder" / "init.luau"));
+    CHECK_FALSE(fileSystem.isDirectory(directory.path / "folder" / "init.luau"));
+    CHECK_FALSE(fileSystem.exists(directory.path / "missing.luau"));
+    CHECK_FALSE(fileSystem.isDirectory(directory.path / "missing"));
+
+    CHECK_EQ(fileSystem.weaklyCanonical(directory.path / "folder" / ".." / "folder" / "init.luau"),
+        std::filesystem::weakly_canonical(directory.path / "folder" / "init.luau"));
+    CHECK_EQ(fileSystem.weaklyCanonical(directory.path / "missing" / ".." / "other.luau"),
+        std::filesystem::weakly_canonical(directory.path / "other.luau"));
+}
+
+TEST_CASE("lookups are cached until cleared")
+{
+    TemporaryDirectory directory;
+    FileSystemCache fileSystem;
+    auto file = directory.path / "created.luau";
+
+    CHECK_FALSE(fileSystem.exists(file));
+    std::ofstream(file) << "return {}";
+    CHECK_FALSE(fileSystem.exists(file));
+
+    fileSystem.clear();
+    CHECK(fileSystem.exists(file));
+}
+
+TEST_CASE("lookups go to the disk when caching is turned off")
+{
+    TemporaryDirectory directory;
+    FileSystemCache fileSystem;
+    auto file = directory.path / "created.luau";
+
+    CHECK_FALSE(fileSystem.exists(file));
+    fileSystem.setCaching(false);
+
+    std::ofstream(file) << "return {}";
+    CHECK(fileSystem.exists(file));
+    CHECK_FALSE(fileSystem.isDirectory(file));
+    CHECK_EQ(fileSystem.weaklyCanonical(file), std::filesystem::weakly_canonical(file));
+
+    std::filesystem::remove(file);
+    CHECK_FALSE(fileSystem.exists(file));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,150 @@
+#include "doctest.h"
+#include "LSP/FileWalker.hpp"
+#include "LSP/ThreadPool.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+TEST_SUITE_BEGIN("FileWalker");
+
+struct TemporaryWorkspace
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "luau-lsp-file-walker-test";
+
+    TemporaryWorkspace()
+    {
+        std::filesystem::remove_all(path);
+        for (const auto& file : {"init.luau", "src/a.lua", "src/b.luau", "src/readme.md", "src/nested/c.luau", "Packages/_Index/dep/init.lua",
+                 "build/out.luau", "src/generated.luau"})
+            write(file, "return {}");
+    }
+
+    ~TemporaryWorkspace()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+
+    void write(const std::filesystem::path& relativePath, const std::string& contents) const
+    {
+        std::filesystem::create_directories((path / relativePath).parent_path());
+        std::ofstream(path / relativePath) << contents;
+    }
+
+    std::vector<std::string> relative(const std::vector<std::filesystem::path>& files) const
+    {
+        std::vector<std::string> result;
+        for (const auto& file : files)
+            result.push_back(file.lexically_relative(path).generic_string());
+        return result;
+    }
+};
+
+TEST_CASE("finds all source files")
+{
+    TemporaryWorkspace workspace;
+    FileWalkerOptions options;
+    options.threads = 4;
+
+    auto files = workspace.relative(findSourceFiles(workspace.path, options));
+    std::sort(files.begin(), files.end());
+    CHECK_EQ(files, std::vector<std::string>{"Packages/_Index/dep/init.lua", "build/out.luau", "init.luau", "src/a.lua", "src/b.luau",
+                        "src/generated.luau", "src/nested/c.luau"});
+}
+
+TEST_CASE("a walk can be advanced a few directories at a time")
+{
+    TemporaryWorkspace workspace;
+    FileWalkerOptions options;
+    options.ignoreGlobs = GlobMatcher({"**/_Index/**"});
+    ThreadPool pool(2);
+
+    SourceFileWalk walk(workspace.path, options);
+    size_t steps = 0;
+    while (walk.step(pool, 1))
+        steps++;
+    CHECK(walk.isDone());
+    CHECK_GT(steps, 1);
+
+    CHECK_EQ(workspace.relative(walk.takeFiles()), workspace.relative(findSourceFiles(workspace.path, options)));
+}
+
+TEST_CASE("directories matched by ignore globs are not walked")
+{
+    TemporaryWorkspace workspace;
+    FileWalkerOptions options;
+    options.ignoreGlobs = GlobMatcher({"**/_Index/**", "src/nested/*"});
+
+    auto files = workspace.relative(findSourceFiles(workspace.path, options));
+    CHECK_EQ(std::count(files.begin(), files.end(), "Packages/_Index/dep/init.lua"), 0);
+    CHECK_EQ(std::count(files.begin(), files.end(), "src/nested/c.luau"), 0);
+    CHECK_EQ(std::count(files.begin(), files.end(), "src/a.lua"), 1);
+}
+
+TEST_CASE("gitignore files are respected when enabled")
+{
+    TemporaryWorkspace workspace;
+    workspace.write(".gitignore", "# build output\nbuild/\n/Packages\n*.luau\n!init.luau\n");
+    workspace.write("src/.gitignore", "generated.luau\n");
+    workspace.write("src/nested/.gitignore", "!c.luau\n");
+
+    FileWalkerOptions options;
+    CHECK_EQ(findSourceFiles(workspace.path, options).size(), 7);
+
+    options.respectGitignore = true;
+    auto files = workspace.relative(findSourceFiles(workspace.path, options));
+    CHECK_EQ(files, std::vector<std::string>{"init.luau", "src/a.lua", "src/nested/c.luau"});
+}
+
+TEST_CASE("gitignore rules")
+{
+    GitignoreRules root(nullptr, "", "*.log\n/dist\nout/\ndocs/**/*.lua\n\\#literal\n");
+    CHECK(root.isIgnored("a.log", false));
+    CHECK(root.isIgnored("deep/dir/a.log", false));
+    CHECK(root.isIgnored("dist", true));
+    CHECK_FALSE(root.isIgnored("src/dist", true));
+    CHECK(root.isIgnored("src/out", true));
+    CHECK_FALSE(root.isIgnored("src/out", false));
+    CHECK(root.isIgnored("docs/a.lua", false));
+    CHECK(root.isIgnored("docs/x/y/a.lua", false));
+    CHECK(root.isIgnored("#literal", false));
+
+    auto parent = std::make_shared<GitignoreRules>(nullptr, "", "*.lua\n");
+    GitignoreRules child(parent, "src", "!keep.lua\n");
+    CHECK(child.isIgnored("src/other.lua", false));
+    CHECK_FALSE(child.isIgnored("src/keep.lua", false));
+    CHECK(child.isIgnored("keep.lua", false));
+}
+
+TEST_CASE("the file list is updated from file events")
+{
+    TemporaryWorkspace workspace;
+    FileWalkerOptions options;
+    options.ignoreGlobs = GlobMatcher({"**/_Index/**"});
+    WorkspaceFiles files;
+    CHECK_EQ(files.get(workspace.path, options).size(), 6);
+
+    // Changes on disk are not seen until an event arrives
+    workspace.write("src/new.luau", "return {}");
+    workspace.write("Packages/_Index/dep/new.luau", "return {}");
+    CHECK_EQ(files.get(workspace.path, options).size(), 6);
+
+    files.onCreated(workspace.path / "src" / "new.luau");
+    files.onCreated(workspace.path / "Packages" / "_Index" / "dep" / "new.luau");
+    files.onCreated(workspace.path / "src" / "notes.txt");
+    auto current = workspace.relative(files.get(workspace.path, options));
+    CHECK_EQ(current.size(), 7);
+    CHECK(std::is_sorted(current.begin(), current.end()));
+    CHECK_EQ(std::count(current.begin(), current.end(), "src/new.luau"), 1);
+
+    files.onDeleted(workspace.path / "src");
+    CHECK_EQ(workspace.relative(files.get(workspace.path, options)), std::vector<std::string>{"build/out.luau", "init.luau"});
+
+    // Different options walk the workspace again
+    options.ignoreGlobs = GlobMatcher();
+    CHECK_FALSE(files.isPopulated(workspace.path, options));
+    CHECK_EQ(files.get(workspace.path, options).size(), 9);
+    CHECK(files.isPopulated(workspace.path, options));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,69 @@
+#include "doctest.h"
+#include "LSP/GlobMatcher.hpp"
+#include "glob/glob.hpp"
+
+TEST_SUITE_BEGIN("GlobMatcher");
+
+TEST_CASE("matches like fnmatch_case")
+{
+    std::vector<std::string> patterns = {"**/_Index/**", "Packages/**", "*.spec.luau", "src/?ib/[a-c]*.luau", "[!x]y", "exact.luau"};
+    std::vector<std::string> paths = {
+        "Packages/_Index/roact/src/init.lua",
+        "Packages/Roact.lua",
+        "DevPackages/_Index/x.lua",
+        "src/module.spec.luau",
+        "src/module.luau",
+        "src/lib/alpha.luau",
+        "src/lib/delta.luau",
+        "src/lib/a",
+        "xy",
+        "ay",
+        "exact.luau",
+        "exact.luau.bak",
+        "",
+    };
+
+    for (const auto& pattern : patterns)
+    {
+        GlobMatcher matcher({pattern});
+        for (const auto& path : paths)
+        {
+            INFO("pattern: ", pattern, ", path: ", path);
+            CHECK_EQ(matcher.matches(path), glob::fnmatch_case(path, pattern));
+        }
+    }
+
+    GlobMatcher combined(patterns);
+    for (const auto& path : paths)
+    {
+        bool expected = false;
+        for (const auto& pattern : patterns)
+            expected |= glob::fnmatch_case(path, pattern);
+        INFO("path: ", path);
+        CHECK_EQ(combined.matches(path), expected);
+    }
+}
+
+TEST_CASE("empty matcher matches nothing")
+{
+    GlobMatcher matcher;
+    CHECK(matcher.empty());
+    CHECK_FALSE(matcher.matches("anything"));
+    CHECK_FALSE(matcher.matchesEverythingUnder("anything"));
+}
+
+TEST_CASE("matchesEverythingUnder prunes only fully ignored directories")
+{
+    GlobMatcher matcher({"**/_Index/**", "Packages/**", "*.spec.luau"});
+    CHECK(matcher.matchesEverythingUnder("Packages"));
+    CHECK(matcher.matchesEverythingUnder("Packages/nested"));
+    CHECK(matcher.matchesEverythingUnder("DevPackages/_Index"));
+    CHECK_FALSE(matcher.matchesEverythingUnder("DevPackages"));
+    CHECK_FALSE(matcher.matchesEverythingUnder("src"));
+
+    // Only files ending in .spec.luau are ignored, not everything in the directory
+    GlobMatcher specs({"tests/*.spec.luau"});
+    CHECK_FALSE(specs.matchesEverythingUnder("tests"));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,54 @@
+#include "doctest.h"
+#include "LSP/IdentifierIndex.hpp"
+
+TEST_SUITE_BEGIN("IdentifierIndex");
+
+TEST_CASE("modules mention the names they were indexed with")
+{
+    IdentifierIndex index;
+    CHECK_FALSE(index.isIndexed({0}));
+
+    index.setModule({0}, {"Point", "new", "x", "new"});
+    index.setModule({2}, {"Shape", "x"});
+
+    CHECK(index.isIndexed({0}));
+    CHECK_FALSE(index.isIndexed({1}));
+    CHECK(index.isIndexed({2}));
+
+    CHECK(index.mentions({0}, "new"));
+    CHECK(index.mentions({0}, "x"));
+    CHECK_FALSE(index.mentions({0}, "Shape"));
+    CHECK(index.mentions({2}, "Shape"));
+    CHECK_FALSE(index.mentions({2}, "missing"));
+    CHECK_FALSE(index.mentions({1}, "x"));
+
+    // Replacing an entry forgets the previous names
+    index.setModule({0}, {"y"});
+    CHECK_FALSE(index.mentions({0}, "new"));
+    CHECK(index.mentions({0}, "y"));
+}
+
+TEST_CASE("invalidated modules are dropped")
+{
+    IdentifierIndex index;
+    index.setModule({0}, {"a"});
+    index.setModule({1}, {"b"});
+
+    index.invalidate({1});
+    index.invalidate({7});
+    index.invalidate({1});
+    CHECK(index.isIndexed({1}));
+
+    index.dropStale();
+    CHECK(index.isIndexed({0}));
+    CHECK_FALSE(index.isIndexed({1}));
+
+    index.setModule({1}, {"c"});
+    index.dropStale();
+    CHECK(index.mentions({1}, "c"));
+
+    index.clear();
+    CHECK_FALSE(index.isIndexed({0}));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,112 @@
+#include "doctest.h"
+#include "LSP/IndexCache.hpp"
+
+#include <fstream>
+
+static std::filesystem::path cachePath()
+{
+    return std::filesystem::temp_directory_path() / "luau-lsp-test-index-cache.bin";
+}
+
+static IndexedModule exampleModule(uint64_t contentHash)
+{
+    IndexedModule module;
+    module.contentHash = contentHash;
+    module.requireLocations = {{"game/ReplicatedStorage/Shared", {{1, 14}, {1, 50}}}, {"game/ReplicatedStorage/Util", {{2, 12}, {2, 46}}}};
+    module.exportedTypes = {"Point", "Shape"};
+    module.symbols = {
+        {"Point", lsp::SymbolKind::Interface, {{4, 12}, {4, 17}}},
+        {"new", lsp::SymbolKind::Function, {{8, 9}, {8, 16}}},
+    };
+    module.stringRequires = {{"./Util", "/project/src/Util.luau"}, {"./Missing", ""}};
+    return module;
+}
+
+TEST_SUITE_BEGIN("IndexCache");
+
+TEST_CASE("hashIndexContent distinguishes content")
+{
+    CHECK_EQ(hashIndexContent("local x = 1"), hashIndexContent("local x = 1"));
+    CHECK_NE(hashIndexContent("local x = 1"), hashIndexContent("local x = 2"));
+    CHECK_NE(hashIndexContent("local value = 1\n"), hashIndexContent("local valve = 1\n"));
+    CHECK_NE(hashIndexContent(""), hashIndexContent(std::string_view("\0", 1)));
+}
+
+TEST_CASE("modules round trip through the cache")
+{
+    std::unordered_map<std::string, IndexedModule> modules;
+    modules["game/ReplicatedStorage/Shape"] = exampleModule(42);
+    modules["game/ReplicatedStorage/Shared"] = IndexedModule{7, {}, {}, {}};
+    for (size_t i = 0; i < 100; i++)
+        modules["game/ReplicatedStorage/Module" + std::to_string(i)] = exampleModule(i);
+
+    REQUIRE(IndexCache::save(cachePath(), "key", modules));
+    auto cache = IndexCache::load(cachePath(), "key");
+    CHECK_EQ(cache.size(), modules.size());
+
+    for (const auto& [name, expected] : modules)
+    {
+        auto module = cache.find(name, expected.contentHash);
+        REQUIRE(module);
+        CHECK_EQ(module->contentHash, expected.contentHash);
+        CHECK_EQ(module->requireLocations, expected.requireLocations);
+        CHECK_EQ(module->exportedTypes, expected.exportedTypes);
+        CHECK_EQ(module->symbols, expected.symbols);
+        CHECK_EQ(module->stringRequires, expected.stringRequires);
+    }
+
+    CHECK_FALSE(cache.find("game/ReplicatedStorage/Missing", 42));
+    CHECK_FALSE(cache.find("", 42));
+
+    std::filesystem::remove(cachePath());
+}
+
+TEST_CASE("entries for changed content are not returned")
+{
+    std::unordered_map<std::string, IndexedModule> modules;
+    modules["game/ReplicatedStorage/Shape"] = exampleModule(42);
+    REQUIRE(IndexCache::save(cachePath(), "key", modules));
+
+    auto cache = IndexCache::load(cachePath(), "key");
+    CHECK(cache.find("game/ReplicatedStorage/Shape", 42));
+    CHECK_FALSE(cache.find("game/ReplicatedStorage/Shape", 43));
+
+    std::filesystem::remove(cachePath());
+}
+
+TEST_CASE("a cache written with a different key is discarded")
+{
+    std::unordered_map<std::string, IndexedModule> modules;
+    modules["game/ReplicatedStorage/Shape"] = exampleModule(42);
+    REQUIRE(IndexCache::save(cachePath(), "1.34.0", modules));
+
+    CHECK_EQ(IndexCache::load(cachePath(), "1.35.0").size(), 0);
+    CHECK_EQ(IndexCache::load(cachePath(), "1.34.0").size(), 1);
+
+    std::filesystem::remove(cachePath());
+}
+
+TEST_CASE("missing and corrupt caches are empty")
+{
+    std::filesystem::remove(cachePath());
+    CHECK_EQ(IndexCache::load(cachePath(), "key").size(), 0);
+
+    std::unordered_map<std::string, IndexedModule> modules;
+    modules["game/ReplicatedStorage/Shape"] = exampleModule(42);
+    REQUIRE(IndexCache::save(cachePath(), "key", modules));
+
+    // Truncate the file
+    auto size = std::filesystem::file_size(cachePath());
+    std::filesystem::resize_file(cachePath(), size - 1);
+    CHECK_EQ(IndexCache::load(cachePath(), "key").size(), 0);
+
+    {
+        std::ofstream file(cachePath(), std::ios::binary | std::ios::trunc);
+        file << "not an index cache";
+    }
+    CHECK_EQ(IndexCache::load(cachePath(), "key").size(), 0);
+
+    std::filesystem::remove(cachePath());
+}
+
+TEST_SUITE_END();
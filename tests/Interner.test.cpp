@@ -0,0 +1,79 @@
+#include "doctest.h"
+#include "LSP/Interner.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_SUITE_BEGIN("StringInterner");
+
+TEST_CASE("interning the same string returns the same id")
+{
+    StringInterner interner;
+    auto a = interner.intern("game/ReplicatedStorage/Module");
+    auto b = interner.intern("game/ReplicatedStorage/Other");
+    std::string copy = "game/ReplicatedStorage/Module";
+
+    CHECK_EQ(interner.intern(copy), a);
+    CHECK_NE(a, b);
+    CHECK_EQ(interner.size(), 2);
+    CHECK_EQ(interner.lookup(a), "game/ReplicatedStorage/Module");
+    CHECK_EQ(interner.lookup(b), "game/ReplicatedStorage/Other");
+}
+
+TEST_CASE("ids are allocated densely in order of first use")
+{
+    StringInterner interner;
+    CHECK_EQ(interner.intern("a").value, 0);
+    CHECK_EQ(interner.intern("b").value, 1);
+    CHECK_EQ(interner.intern("a").value, 0);
+    CHECK_EQ(interner.intern("").value, 2);
+}
+
+TEST_CASE("find does not intern")
+{
+    StringInterner interner;
+    CHECK_FALSE(interner.find("missing"));
+    CHECK_EQ(interner.size(), 0);
+
+    auto id = interner.intern("present");
+    CHECK_EQ(interner.find("present"), id);
+}
+
+TEST_CASE("looked up strings stay valid as the interner grows")
+{
+    StringInterner interner;
+    const std::string& first = interner.lookup(interner.intern("first"));
+    for (size_t i = 0; i < 10000; i++)
+        interner.intern("module" + std::to_string(i));
+
+    CHECK_EQ(first, "first");
+    CHECK_EQ(interner.find("first")->value, 0);
+}
+
+TEST_CASE("concurrent interning agrees on ids")
+{
+    StringInterner interner;
+    constexpr size_t threadCount = 4;
+    constexpr size_t stringCount = 2000;
+
+    std::vector<std::vector<InternedId>> results(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t++)
+        threads.emplace_back(
+            [&, t]()
+            {
+                for (size_t i = 0; i < stringCount; i++)
+                    results[t].push_back(interner.intern("module" + std::to_string(i)));
+            });
+    for (auto& thread : threads)
+        thread.join();
+
+    CHECK_EQ(interner.size(), stringCount);
+    for (size_t t = 1; t < threadCount; t++)
+        CHECK(results[t] == results[0]);
+    for (size_t i = 0; i < stringCount; i++)
+        CHECK_EQ(interner.lookup(results[0][i]), "module" + std::to_string(i));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,78 @@
+#include "doctest.h"
+#include "LSP/JsonRpc.hpp"
+
+#include <sstream>
+
+TEST_SUITE_BEGIN("JsonRpc");
+
+TEST_CASE("parse_request_leaves_params_unparsed")
+{
+    auto message = json_rpc::parse(R"({"jsonrpc": "2.0", "id": 1, "method": "textDocument/hover", "params": {"textDocument": {"uri": "file:///a.luau"}, "position": {"line": 1, "character": 2}}})");
+
+    CHECK(message.is_request());
+    CHECK_EQ(message.id, json_rpc::id_type{1});
+    CHECK_EQ(message.method, "textDocument/hover");
+    CHECK_FALSE(message.params);
+    REQUIRE(message.rawParams);
+    CHECK_EQ(message.rawParams->find("position")->view(), R"({"line": 1, "character": 2})");
+    CHECK_EQ(message.rawParams->find("textDocument")->find("uri")->parse(), "file:///a.luau");
+    CHECK_FALSE(message.rawParams->find("range"));
+
+    auto params = message.parseParams();
+    REQUIRE(params);
+    CHECK_EQ(params->at("position").at("character"), 2);
+}
+
+TEST_CASE("parse_skips_nested_strings_and_escapes")
+{
+    auto message = json_rpc::parse(
+        R"({"method":"textDocument/didOpen","params":{"textDocument":{"text":"local x = \"}{\" -- ]\\","uri":"file:///a.luau","version":3}},"jsonrpc":"2.0"})");
+
+    CHECK(message.is_notification());
+    REQUIRE(message.rawParams);
+    auto textDocument = message.rawParams->find("textDocument");
+    REQUIRE(textDocument);
+    CHECK_EQ(textDocument->find("version")->parse(), 3);
+    CHECK_EQ(textDocument->find("text")->parse(), "local x = \"}{\" -- ]\\");
+}
+
+TEST_CASE("parse_response")
+{
+    auto result = json_rpc::parse(R"({"jsonrpc":"2.0","id":"abc","result":[1,2,3]})");
+    CHECK(result.is_response());
+    CHECK_EQ(result.id, json_rpc::id_type{"abc"});
+    CHECK_EQ(result.result, json{1, 2, 3});
+
+    auto error = json_rpc::parse(R"({"jsonrpc":"2.0","id":2,"error":{"code":-32601,"message":"not found"}})");
+    CHECK(error.is_response());
+    REQUIRE(error.error);
+    CHECK_EQ(error.error->code, lsp::ErrorCode::MethodNotFound);
+    CHECK_EQ(error.error->message, "not found");
+}
+
+TEST_CASE("parse_rejects_malformed_messages")
+{
+    CHECK_THROWS_AS(json_rpc::parse(R"({"id":1,"method":"initialize"})"), json_rpc::JsonRpcException);
+    CHECK_THROWS_AS(json_rpc::parse(R"({"jsonrpc":"1.0","id":1,"method":"initialize"})"), json_rpc::JsonRpcException);
+    CHECK_THROWS_AS(json_rpc::parse(R"({"jsonrpc":"2.0","params":{"a":[1,2})"), json_rpc::JsonRpcException);
+    CHECK_THROWS_AS(json_rpc::parse(R"([])"), json_rpc::JsonRpcException);
+}
+
+TEST_CASE("read_raw_message_frames_consecutive_messages")
+{
+    std::stringstream input;
+    input << "Content-Length: 13\r\n\r\n{\"first\":123}";
+    input << "Content-Type: application/vscode-jsonrpc; charset=utf-8\r\nContent-Length: 2\r\n\r\n{}";
+
+    std::string body;
+    REQUIRE(json_rpc::readRawMessage(input, body));
+    CHECK_EQ(body, "{\"first\":123}");
+
+    REQUIRE(json_rpc::readRawMessage(input, body));
+    CHECK_EQ(body, "{}");
+
+    CHECK_FALSE(json_rpc::readRawMessage(input, body));
+    CHECK_FALSE(input);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,119 @@
+#include "doctest.h"
+#include "LSP/JsonWriter.hpp"
+
+template<typename T>
+static json writeToJson(const T& value)
+{
+    std::string buffer;
+    JsonWriter writer(buffer);
+    write(writer, value);
+    return json::parse(buffer);
+}
+
+TEST_SUITE_BEGIN("JsonWriter");
+
+TEST_CASE("strings_are_escaped")
+{
+    std::string buffer;
+    JsonWriter writer(buffer);
+    writer.beginArray();
+    writer.value("quote \" backslash \\ newline \n tab \t control \x01 unicode \xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+    writer.value("invalid \xFF utf8 \xC3");
+    writer.endArray();
+
+    json expected = json::array({"quote \" backslash \\ newline \n tab \t control \x01 unicode \xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80", "invalid \xFF utf8 \xC3"});
+    CHECK_EQ(buffer, expected.dump(-1, ' ', false, json::error_handler_t::replace));
+}
+
+TEST_CASE("nested_containers_are_separated")
+{
+    std::string buffer;
+    JsonWriter writer(buffer);
+    writer.beginObject();
+    writer.key("a");
+    writer.beginArray();
+    writer.beginObject();
+    writer.endObject();
+    writer.beginArray();
+    writer.endArray();
+    writer.value(1);
+    writer.endArray();
+    writer.field("b", std::string("c"));
+    writer.key("d");
+    writer.value(nullptr);
+    writer.endObject();
+
+    CHECK_EQ(buffer, R"({"a":[{},[],1],"b":"c","d":null})");
+}
+
+TEST_CASE("completion_items_match_to_json")
+{
+    lsp::CompletionItem minimal;
+    minimal.label = "print";
+
+    lsp::CompletionItem full;
+    full.label = "GetService";
+    full.labelDetails = lsp::CompletionItemLabelDetails{"(service)", std::nullopt};
+    full.kind = lsp::CompletionItemKind::Method;
+    full.tags = std::vector{lsp::CompletionItemTag::Deprecated};
+    full.detail = "(self, className: string) -> Instance";
+    full.documentation = lsp::MarkupContent{lsp::MarkupKind::Markdown, "```luau\nfunction\n```"};
+    full.deprecated = true;
+    full.preselect = true;
+    full.sortText = "0";
+    full.insertText = "GetService(\"$1\")";
+    full.insertTextFormat = lsp::InsertTextFormat::Snippet;
+    full.insertTextMode = lsp::InsertTextMode::AsIs;
+    full.textEdit = lsp::TextEdit{{{1, 2}, {1, 5}}, "GetService"};
+    full.additionalTextEdits = {lsp::TextEdit{{{0, 0}, {0, 0}}, "local x = 1\n"}};
+    full.commitCharacters = std::vector<std::string>{".", "("};
+    full.command = lsp::Command{"Trigger Signature Help", "editor.action.triggerParameterHints"};
+
+    lsp::CompletionItem emptyLabelDetails;
+    emptyLabelDetails.label = "x";
+    emptyLabelDetails.labelDetails = lsp::CompletionItemLabelDetails{};
+
+    std::vector<lsp::CompletionItem> items{minimal, full, emptyLabelDetails};
+    CHECK_EQ(writeToJson(items), json(items));
+}
+
+TEST_CASE("semantic_tokens_match_to_json")
+{
+    lsp::SemanticTokens tokens{std::nullopt, {0, 5, 3, 1, 0, 1, 2, 4, 8, 2}};
+    CHECK_EQ(writeToJson(tokens), json(tokens));
+
+    tokens.resultId = "1";
+    CHECK_EQ(writeToJson(tokens), json(tokens));
+}
+
+TEST_CASE("workspace_diagnostic_report_matches_to_json")
+{
+    lsp::Diagnostic diagnostic;
+    diagnostic.range = {{3, 4}, {3, 10}};
+    diagnostic.severity = lsp::DiagnosticSeverity::Warning;
+    diagnostic.code = "LocalUnused";
+    diagnostic.source = "Luau";
+    diagnostic.message = "Variable 'x' is never used; prefix with '_' to silence";
+    diagnostic.tags = {lsp::DiagnosticTag::Unnecessary};
+
+    lsp::Diagnostic typeError;
+    typeError.range = {{0, 0}, {0, 1}};
+    typeError.severity = lsp::DiagnosticSeverity::Error;
+    typeError.code = 1000;
+    typeError.message = "Type 'number' could not be converted into 'string'";
+
+    lsp::WorkspaceDocumentDiagnosticReport full;
+    full.uri = Uri::parse("file:///project/src/init.luau");
+    full.version = 4;
+    full.resultId = "12";
+    full.items = {diagnostic, typeError};
+
+    lsp::WorkspaceDocumentDiagnosticReport unchanged;
+    unchanged.kind = lsp::DocumentDiagnosticReportKind::Unchanged;
+    unchanged.uri = Uri::parse("file:///project/src/other.luau");
+
+    lsp::WorkspaceDiagnosticReport report{{full, unchanged}};
+    CHECK_EQ(writeToJson(report), json(report));
+}
+
+TEST_SUITE_END();
@@ -24,4 +24,35 @@ TEST_CASE("language_server_handles_fflags_in_initialization_options")
     FFlag::DebugLuauTimeTracing.value = false;
 }
 
+TEST_CASE("language_server_records_method_statistics")
+{
+    auto client = std::make_shared<Client>();
+    LanguageServer server(client, std::nullopt);
+
+    server.onRequest(0, "initialize", lsp::InitializeParams{}, nullptr, /* contentLength: */ 128);
+    CHECK_THROWS_AS(server.onRequest(1, "luau-lsp/unknownMethod", std::nullopt), JsonRpcException);
+
+    auto stats = server.stats();
+    REQUIRE(stats.methods.find("initialize") != stats.methods.end());
+    CHECK_EQ(stats.methods.at("initialize").count, 1);
+    CHECK_EQ(stats.methods.at("initialize").bytesIn, 128);
+    CHECK(stats.methods.find("luau-lsp/unknownMethod") == stats.methods.end());
+}
+
+TEST_CASE("language_server_counts_output_of_requests_finished_in_the_background")
+{
+    auto client = std::make_shared<Client>();
+    LanguageServer server(client, std::nullopt);
+    server.onRequest(0, "initialize", lsp::InitializeParams{});
+
+    // Workspace diagnostics are computed, and responded to, by background steps after the handler returns
+    server.replayMessage(json_rpc::parse(R"({"jsonrpc":"2.0","id":1,"method":"workspace/diagnostic","params":{"previousResultIds":[]}})"));
+    Client::flushOutput();
+
+    auto stats = server.stats();
+    REQUIRE(stats.methods.find("workspace/diagnostic") != stats.methods.end());
+    CHECK_EQ(stats.methods.at("workspace/diagnostic").count, 1);
+    CHECK_GT(stats.methods.at("workspace/diagnostic").bytesOut, 0);
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,229 @@
+#include "doctest.h"
+#include "LSP/MessageQueue.hpp"
+
+static json_rpc::JsonRpcMessage makeRequest(int id, const std::string& method)
+{
+    return json_rpc::JsonRpcMessage{id, method, json::object(), std::nullopt, std::nullopt};
+}
+
+static json_rpc::JsonRpcMessage makeDocumentRequest(int id, const std::string& method, const std::string& uri)
+{
+    return json_rpc::JsonRpcMessage{id, method, json{{"textDocument", {{"uri", uri}}}}, std::nullopt, std::nullopt};
+}
+
+static json_rpc::JsonRpcMessage makeDidChange(const std::string& uri, size_t version)
+{
+    return json_rpc::JsonRpcMessage{
+        std::nullopt, "textDocument/didChange", json{{"textDocument", {{"uri", uri}, {"version", version}}}, {"contentChanges", json::array()}},
+        std::nullopt, std::nullopt};
+}
+
+TEST_SUITE_BEGIN("MessageQueue");
+
+TEST_CASE("messages_are_popped_in_order")
+{
+    MessageQueue queue;
+    queue.push(makeRequest(1, "textDocument/hover"));
+    queue.push(json_rpc::JsonRpcMessage{std::nullopt, "textDocument/didChange", json::object(), std::nullopt, std::nullopt});
+    queue.push(makeRequest(2, "textDocument/completion"));
+    queue.close();
+
+    auto first = queue.pop();
+    REQUIRE(first);
+    CHECK_EQ(first->message.method, "textDocument/hover");
+    CHECK(first->cancellationToken);
+
+    auto second = queue.pop();
+    REQUIRE(second);
+    CHECK_EQ(second->message.method, "textDocument/didChange");
+    CHECK_FALSE(second->cancellationToken);
+
+    auto third = queue.pop();
+    REQUIRE(third);
+    CHECK_EQ(third->message.method, "textDocument/completion");
+
+    CHECK_FALSE(queue.pop());
+}
+
+TEST_CASE("try_pop_does_not_block_on_an_empty_queue")
+{
+    MessageQueue queue;
+    CHECK_FALSE(queue.tryPop());
+
+    queue.push(makeRequest(1, "textDocument/hover"));
+    auto message = queue.tryPop();
+    REQUIRE(message);
+    CHECK_EQ(message->message.method, "textDocument/hover");
+    CHECK_FALSE(queue.tryPop());
+}
+
+TEST_CASE("queued_request_can_be_cancelled")
+{
+    MessageQueue queue;
+    queue.push(makeRequest(1, "textDocument/references"));
+    queue.push(makeRequest(2, "textDocument/hover"));
+
+    CHECK(queue.cancel(1));
+
+    auto first = queue.pop();
+    REQUIRE(first);
+    CHECK(first->cancellationToken->requested());
+    CHECK_THROWS_AS(throwIfCancelled(first->cancellationToken), json_rpc::JsonRpcException);
+
+    auto second = queue.pop();
+    REQUIRE(second);
+    CHECK_FALSE(second->cancellationToken->requested());
+    CHECK_NOTHROW(throwIfCancelled(second->cancellationToken));
+}
+
+TEST_CASE("in_flight_request_can_be_cancelled")
+{
+    MessageQueue queue;
+    queue.push(makeRequest(1, "workspace/diagnostic"));
+
+    auto inFlight = queue.pop();
+    REQUIRE(inFlight);
+    CHECK_FALSE(inFlight->cancellationToken->requested());
+
+    CHECK(queue.cancel(1));
+    CHECK(inFlight->cancellationToken->requested());
+}
+
+TEST_CASE("cancelling_a_completed_request_is_ignored")
+{
+    MessageQueue queue;
+    queue.push(makeRequest(1, "textDocument/hover"));
+    queue.pop(); // Handled and dropped
+
+    CHECK_FALSE(queue.cancel(1));
+    CHECK_FALSE(queue.cancel(42));
+}
+
+TEST_CASE("document_request_is_superseded_by_a_later_change")
+{
+    MessageQueue queue;
+    queue.push(makeDidChange("file:///a.luau", 1));
+    queue.push(makeDocumentRequest(1, "textDocument/semanticTokens/full", "file:///a.luau"));
+    queue.push(makeDocumentRequest(2, "textDocument/semanticTokens/full", "file:///b.luau"));
+    queue.push(makeDidChange("file:///a.luau", 2));
+
+    queue.pop(); // didChange
+    auto first = queue.pop();
+    REQUIRE(first);
+    CHECK(queue.isSuperseded(*first));
+
+    auto second = queue.pop();
+    REQUIRE(second);
+    CHECK_FALSE(queue.isSuperseded(*second));
+}
+
+TEST_CASE("document_request_is_superseded_by_the_same_request")
+{
+    MessageQueue queue;
+    queue.push(makeDocumentRequest(1, "textDocument/documentSymbol", "file:///a.luau"));
+    queue.push(makeDocumentRequest(2, "textDocument/foldingRange", "file:///a.luau"));
+    queue.push(makeDocumentRequest(3, "textDocument/documentSymbol", "file:///a.luau"));
+
+    auto first = queue.pop();
+    auto second = queue.pop();
+    auto third = queue.pop();
+    REQUIRE((first && second && third));
+
+    CHECK(queue.isSuperseded(*first));
+    CHECK_FALSE(queue.isSuperseded(*second));
+    CHECK_FALSE(queue.isSuperseded(*third));
+}
+
+TEST_CASE("inlay_hint_requests_over_different_ranges_are_not_coalesced")
+{
+    auto makeInlayHintRequest = [](int id, size_t line)
+    {
+        return json_rpc::JsonRpcMessage{id, "textDocument/inlayHint",
+            json{{"textDocument", {{"uri", "file:///a.luau"}}},
+                {"range", {{"start", {{"line", line}, {"character", 0}}}, {"end", {{"line", line + 50}, {"character", 0}}}}}},
+            std::nullopt, std::nullopt};
+    };
+
+    MessageQueue queue;
+    queue.push(makeInlayHintRequest(1, 0));
+    queue.push(makeInlayHintRequest(2, 100));
+
+    auto first = queue.pop();
+    REQUIRE(first);
+    CHECK_FALSE(queue.isSuperseded(*first));
+
+    queue.push(makeInlayHintRequest(3, 0));
+    CHECK(queue.isSuperseded(*first));
+}
+
+TEST_CASE("request_generations_are_dropped_once_dispatched")
+{
+    auto makeInlayHintRequest = [](int id, size_t line)
+    {
+        return json_rpc::JsonRpcMessage{id, "textDocument/inlayHint",
+            json{{"textDocument", {{"uri", "file:///a.luau"}}},
+                {"range", {{"start", {{"line", line}, {"character", 0}}}, {"end", {{"line", line + 50}, {"character", 0}}}}}},
+            std::nullopt, std::nullopt};
+    };
+
+    MessageQueue queue;
+    for (int i = 0; i < 100; i++)
+        queue.push(makeInlayHintRequest(i, static_cast<size_t>(i) * 10));
+    CHECK_EQ(queue.trackedDocumentCount(), 1);
+
+    while (auto message = queue.tryPop())
+        CHECK_FALSE(queue.isSuperseded(*message));
+    CHECK_EQ(queue.trackedDocumentCount(), 0);
+
+    // A request made again after the first was dispatched still supersedes it
+    queue.push(makeInlayHintRequest(100, 0));
+    auto request = queue.pop();
+    REQUIRE(request);
+    queue.push(makeInlayHintRequest(101, 0));
+    CHECK(queue.isSuperseded(*request));
+}
+
+TEST_CASE("document_state_is_dropped_on_close")
+{
+    MessageQueue queue;
+    queue.push(makeDidChange("file:///a.luau", 1));
+    queue.push(makeDocumentRequest(1, "textDocument/documentSymbol", "file:///a.luau"));
+    queue.push(makeDocumentRequest(2, "textDocument/documentSymbol", "file:///b.luau"));
+    CHECK_EQ(queue.trackedDocumentCount(), 2);
+
+    queue.push(json_rpc::JsonRpcMessage{
+        std::nullopt, "textDocument/didClose", json{{"textDocument", {{"uri", "file:///a.luau"}}}}, std::nullopt, std::nullopt});
+    CHECK_EQ(queue.trackedDocumentCount(), 1);
+}
+
+TEST_CASE("document_versions_are_read_from_unparsed_params")
+{
+    MessageQueue queue;
+    queue.push(json_rpc::parse(R"({"jsonrpc":"2.0","method":"textDocument/didOpen","params":{"textDocument":{"uri":"file:///a.luau","languageId":"luau","version":1,"text":"local x = 1"}}})"));
+    queue.push(json_rpc::parse(R"({"jsonrpc":"2.0","id":1,"method":"textDocument/documentColor","params":{"textDocument":{"uri":"file:///a.luau"}}})"));
+
+    queue.pop(); // didOpen
+    auto request = queue.pop();
+    REQUIRE(request);
+    REQUIRE(request->documentStamp);
+    CHECK_EQ(request->documentStamp->documentVersion, 1);
+    CHECK_FALSE(queue.isSuperseded(*request));
+
+    queue.push(json_rpc::parse(
+        R"({"jsonrpc":"2.0","method":"textDocument/didChange","params":{"textDocument":{"uri":"file:///a.luau","version":2},"contentChanges":[{"text":"local x = 2"}]}})"));
+    CHECK(queue.isSuperseded(*request));
+}
+
+TEST_CASE("position_requests_are_never_superseded")
+{
+    MessageQueue queue;
+    queue.push(makeDocumentRequest(1, "textDocument/hover", "file:///a.luau"));
+    queue.push(makeDidChange("file:///a.luau", 2));
+
+    auto first = queue.pop();
+    REQUIRE(first);
+    CHECK_FALSE(first->documentStamp);
+    CHECK_FALSE(queue.isSuperseded(*first));
+}
+
+TEST_SUITE_END();
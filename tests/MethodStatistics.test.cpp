@@ -0,0 +1,42 @@
+#include "doctest.h"
+#include "LSP/MethodStatistics.hpp"
+
+TEST_SUITE_BEGIN("MethodStatistics");
+
+TEST_CASE("histogram_buckets_are_within_error_bounds")
+{
+    for (uint64_t value : {0ULL, 1ULL, 3ULL, 4ULL, 7ULL, 8ULL, 100ULL, 1000ULL, 12345ULL, 1000000ULL, 987654321ULL})
+    {
+        auto approximate = LatencyHistogram::valueFor(LatencyHistogram::bucketFor(value));
+        CHECK_LE(double(approximate), double(value) * 1.125 + 1);
+        CHECK_GE(double(approximate), double(value) * 0.875);
+    }
+}
+
+TEST_CASE("histogram_percentiles")
+{
+    LatencyHistogram histogram;
+    CHECK_EQ(histogram.percentile(50), 0);
+
+    // 90 fast requests at 1ms, 9 at 10ms, and 1 outlier at 1s
+    for (int i = 0; i < 90; i++)
+        histogram.record(std::chrono::milliseconds(1));
+    for (int i = 0; i < 9; i++)
+        histogram.record(std::chrono::milliseconds(10));
+    histogram.record(std::chrono::seconds(1));
+
+    CHECK_EQ(histogram.count(), 100);
+    CHECK_EQ(histogram.max(), 1000000);
+
+    auto p50 = histogram.percentile(50);
+    CHECK_GE(p50, 875);
+    CHECK_LE(p50, 1125);
+
+    auto p95 = histogram.percentile(95);
+    CHECK_GE(p95, 8750);
+    CHECK_LE(p95, 11250);
+
+    CHECK_EQ(histogram.percentile(100), 1000000);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,38 @@
+#include "doctest.h"
+#include "LSP/OutputWriter.hpp"
+#include "LSP/JsonRpc.hpp"
+
+#include <sstream>
+
+TEST_SUITE_BEGIN("OutputWriter");
+
+TEST_CASE("messages_are_written_in_order")
+{
+    std::ostringstream output;
+    std::string expected;
+    {
+        OutputWriter writer(output, /* capacity: */ 4);
+        for (int i = 0; i < 100; i++)
+        {
+            json message{{"jsonrpc", "2.0"}, {"method", "$/logTrace"}, {"params", {{"message", std::to_string(i)}}}};
+            json_rpc::writeRawMessage(expected, message);
+            writer.push(std::move(message));
+        }
+
+        writer.flush();
+        CHECK_EQ(output.str(), expected);
+    }
+}
+
+TEST_CASE("queued_messages_are_written_on_destruction")
+{
+    std::ostringstream output;
+    {
+        OutputWriter writer(output);
+        writer.push(json{{"jsonrpc", "2.0"}, {"id", 1}, {"result", nullptr}});
+    }
+
+    CHECK_EQ(output.str(), "Content-Length: 38\r\n\r\n{\"id\":1,\"jsonrpc\":\"2.0\",\"result\":null}");
+}
+
+TEST_SUITE_END();
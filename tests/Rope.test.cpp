@@ -0,0 +1,133 @@
+#include "doctest.h"
+#include "LSP/Rope.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+static std::vector<size_t> lineStarts(const std::string& text)
+{
+    std::vector<size_t> result{0};
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if (text[i] == '\r' && i + 1 < text.size() && text[i + 1] == '\n')
+            i++;
+        if (text[i] == '\r' || text[i] == '\n')
+            result.push_back(i + 1);
+    }
+    return result;
+}
+
+static void checkMatches(const Rope& rope, const std::string& text)
+{
+    REQUIRE_EQ(rope.toString(), text);
+    REQUIRE_EQ(rope.size(), text.size());
+
+    auto starts = lineStarts(text);
+    REQUIRE_EQ(rope.lineCount(), starts.size());
+    for (size_t line = 0; line < starts.size(); line++)
+        REQUIRE_EQ(rope.lineStart(line), starts[line]);
+    CHECK_EQ(rope.lineStart(starts.size()), text.size());
+
+    for (size_t offset = 0; offset <= text.size(); offset++)
+    {
+        size_t expected = std::upper_bound(starts.begin(), starts.end(), offset) - starts.begin() - 1;
+        REQUIRE_EQ(rope.lineOf(offset), expected);
+    }
+}
+
+TEST_SUITE_BEGIN("Rope");
+
+TEST_CASE("empty_rope_has_a_single_line")
+{
+    Rope rope;
+    CHECK(rope.empty());
+    CHECK_EQ(rope.lineCount(), 1);
+    CHECK_EQ(rope.lineStart(0), 0);
+    CHECK_EQ(rope.lineOf(0), 0);
+    CHECK_EQ(rope.toString(), "");
+}
+
+TEST_CASE("line_breaks_are_counted_once_for_crlf")
+{
+    checkMatches(Rope("a\nb\r\nc\rd\n\re"), "a\nb\r\nc\rd\n\re");
+}
+
+TEST_CASE("offset_between_crlf_belongs_to_the_first_line")
+{
+    Rope rope("ab\r\ncd");
+    CHECK_EQ(rope.lineOf(3), 0);
+    CHECK_EQ(rope.lineOf(4), 1);
+}
+
+TEST_CASE("inserting_a_line_feed_after_a_carriage_return_joins_the_line_breaks")
+{
+    std::string text = std::string(Rope::MaxChunkSize - 1, 'a') + "\r" + std::string(Rope::MaxChunkSize, 'b');
+    Rope rope(text);
+    CHECK_EQ(rope.lineCount(), 2);
+
+    rope.replace(Rope::MaxChunkSize, 0, "\n");
+    text.insert(Rope::MaxChunkSize, "\n");
+    checkMatches(rope, text);
+    CHECK_EQ(rope.lineCount(), 2);
+
+    rope.replace(Rope::MaxChunkSize, 1, "");
+    text.erase(Rope::MaxChunkSize, 1);
+    checkMatches(rope, text);
+}
+
+TEST_CASE("substr_spans_chunks")
+{
+    std::string text;
+    for (size_t i = 0; i < 5000; i++)
+        text += char('a' + i % 26);
+
+    Rope rope(text);
+    CHECK_EQ(rope.substr(1000, 3000), text.substr(1000, 3000));
+    CHECK_EQ(rope.substr(4990), text.substr(4990));
+    CHECK_EQ(rope.substr(6000, 10), "");
+}
+
+TEST_CASE("copies_are_unaffected_by_later_edits")
+{
+    Rope rope("local x = 1\nlocal y = 2\n");
+    Rope copy = rope;
+
+    rope.replace(6, 1, "renamed");
+    CHECK_EQ(rope.toString(), "local renamed = 1\nlocal y = 2\n");
+    CHECK_EQ(copy.toString(), "local x = 1\nlocal y = 2\n");
+}
+
+TEST_CASE("random_edits_match_string_edits")
+{
+    std::mt19937 rng(42);
+    const std::string alphabet[] = {"a", "b", " ", "\n", "\r", "\r\n", "\xC3\xA9", "\xF0\x9F\x98\x80"};
+
+    auto randomText = [&](size_t length)
+    {
+        std::string result;
+        while (result.size() < length)
+            result += alphabet[rng() % std::size(alphabet)];
+        return result;
+    };
+
+    for (size_t iteration = 0; iteration < 20; iteration++)
+    {
+        std::string text = randomText(rng() % 4000);
+        Rope rope(text);
+
+        for (size_t edit = 0; edit < 50; edit++)
+        {
+            size_t offset = rng() % (text.size() + 1);
+            size_t length = std::min<size_t>(rng() % (edit % 10 == 0 ? 2000 : 8), text.size() - offset);
+            std::string inserted = randomText(rng() % (edit % 7 == 0 ? 2500 : 4));
+
+            rope.replace(offset, length, inserted);
+            text.replace(offset, length, inserted);
+        }
+
+        checkMatches(rope, text);
+    }
+}
+
+TEST_SUITE_END();
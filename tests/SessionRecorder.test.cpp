@@ -0,0 +1,51 @@
+#include "doctest.h"
+#include "LSP/SessionRecorder.hpp"
+
+#include <sstream>
+
+TEST_SUITE_BEGIN("SessionRecorder");
+
+TEST_CASE("recorded_messages_can_be_read_back")
+{
+    auto output = std::make_unique<std::stringstream>();
+    auto* stream = output.get();
+
+    SessionRecorder recorder(std::move(output));
+    recorder.record(R"({"jsonrpc":"2.0","id":1,"method":"initialize","params":{}})");
+    recorder.record("{\"jsonrpc\":\"2.0\",\n\"method\":\"initialized\"}");
+
+    std::stringstream input(stream->str());
+    RecordedMessage first;
+    REQUIRE(readRecordedMessage(input, first));
+    CHECK_EQ(first.body, R"({"jsonrpc":"2.0","id":1,"method":"initialize","params":{}})");
+
+    RecordedMessage second;
+    REQUIRE(readRecordedMessage(input, second));
+    CHECK_EQ(second.body, "{\"jsonrpc\":\"2.0\",\n\"method\":\"initialized\"}");
+    CHECK(second.timestamp >= first.timestamp);
+
+    RecordedMessage end;
+    CHECK_FALSE(readRecordedMessage(input, end));
+}
+
+TEST_CASE("recording_uses_protocol_framing_with_a_timestamp_header")
+{
+    std::stringstream input("Recorded-At: 1500\r\nContent-Length: 2\r\n\r\n{}");
+
+    RecordedMessage message;
+    REQUIRE(readRecordedMessage(input, message));
+    CHECK_EQ(message.timestamp.count(), 1500);
+    CHECK_EQ(message.body, "{}");
+}
+
+TEST_CASE("truncated_recording_ends_at_the_last_complete_message")
+{
+    std::stringstream input("Recorded-At: 10\r\nContent-Length: 2\r\n\r\n{}Recorded-At: 20\r\nContent-Length: 100\r\n\r\n{\"jsonrpc\"");
+
+    RecordedMessage message;
+    REQUIRE(readRecordedMessage(input, message));
+    CHECK_EQ(message.body, "{}");
+    CHECK_FALSE(readRecordedMessage(input, message));
+}
+
+TEST_SUITE_END();
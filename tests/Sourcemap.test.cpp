@@ -565,7 +565,7 @@ TEST_CASE_FIXTURE(Fixture, "sourcemap_path_matches_ignore_globs")
     )");
 #endif
     client->globalConfig.completion.imports.ignoreGlobs = {"**/_Index/**"};
-
+    workspace.applyIgnoreGlobs(client->globalConfig);
 
     auto rootNode = getRootSourceNode();
     auto filePath = dynamic_cast<RobloxPlatform*>(workspace.platform.get())->getRealPathFromSourceNode(rootNode);
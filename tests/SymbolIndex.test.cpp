@@ -0,0 +1,106 @@
+#include "doctest.h"
+#include "LSP/SymbolIndex.hpp"
+
+static std::vector<std::string> names(const std::vector<SymbolMatch>& matches)
+{
+    std::vector<std::string> result;
+    for (const auto& match : matches)
+        result.push_back(match.symbol.name);
+    return result;
+}
+
+static IndexedSymbol function(std::string name)
+{
+    return IndexedSymbol{std::move(name), lsp::SymbolKind::Function, {{1, 0}, {1, 10}}};
+}
+
+TEST_SUITE_BEGIN("SymbolIndex");
+
+TEST_CASE("names containing the query rank above fuzzy matches")
+{
+    SymbolIndex index;
+    index.setModule({0}, {function("getService"), function("GetServiceProvider"), function("targetService"), function("gsv")});
+    index.setModule({1}, {function("go_fast_service"), function("unrelated"), function("service")});
+
+    CHECK_EQ(names(index.search("service", 10)),
+        std::vector<std::string>{"service", "getService", "targetService", "go_fast_service", "GetServiceProvider"});
+    CHECK_EQ(names(index.search("GETSERVICE", 10)), std::vector<std::string>{"getService", "GetServiceProvider", "targetService"});
+
+    // Characters in order, preferring those at the start of words
+    CHECK_EQ(names(index.search("gsv", 10)), std::vector<std::string>{"gsv", "getService", "GetServiceProvider", "targetService", "go_fast_service"});
+    CHECK(index.search("xyz", 10).empty());
+}
+
+TEST_CASE("fuzzy matches only fill the slots left by names containing the query")
+{
+    SymbolIndex index;
+    index.setModule({0}, {function("fetchData"), function("fetchDataAsync"), function("f_e_t_c_h"), function("refetch")});
+
+    CHECK_EQ(names(index.search("fetch", 2)), std::vector<std::string>{"fetchData", "fetchDataAsync"});
+    CHECK_EQ(names(index.search("fetch", 4)), std::vector<std::string>{"fetchData", "fetchDataAsync", "refetch", "f_e_t_c_h"});
+}
+
+TEST_CASE("results are capped")
+{
+    SymbolIndex index;
+    std::vector<IndexedSymbol> symbols;
+    for (size_t i = 0; i < 100; i++)
+        symbols.push_back(function("handler" + std::to_string(i)));
+    index.setModule({0}, symbols);
+
+    CHECK_EQ(index.search("handler", 10).size(), 10);
+    CHECK_EQ(index.search("", 25).size(), 25);
+    CHECK_EQ(index.search("handler", 10).front().symbol.name, "handler0");
+}
+
+TEST_CASE("replacing a module's symbols hides the previous ones")
+{
+    SymbolIndex index;
+    index.setModule({0}, {function("oldName"), function("shared")});
+    index.setModule({1}, {function("shared")});
+    CHECK_EQ(index.size(), 3);
+
+    index.setModule({0}, {function("newName")});
+    CHECK_EQ(index.size(), 2);
+    CHECK(index.search("oldName", 10).empty());
+    CHECK_EQ(names(index.search("newName", 10)), std::vector<std::string>{"newName"});
+
+    auto shared = index.search("shared", 10);
+    REQUIRE_EQ(shared.size(), 1);
+    CHECK_EQ(shared[0].module.value, 1);
+
+    index.removeModule({1});
+    CHECK(index.search("shared", 10).empty());
+    CHECK_EQ(index.size(), 1);
+}
+
+TEST_CASE("dead symbols are compacted away")
+{
+    SymbolIndex index;
+    std::vector<IndexedSymbol> symbols;
+    for (size_t i = 0; i < 50; i++)
+        symbols.push_back(function("symbol" + std::to_string(i)));
+
+    for (size_t round = 0; round < 100; round++)
+        for (uint32_t module = 0; module < 10; module++)
+            index.setModule({module}, symbols);
+
+    CHECK_EQ(index.size(), 500);
+    CHECK_EQ(index.search("symbol42", 100).size(), 10);
+}
+
+TEST_CASE("stale modules are taken until their symbols are replaced")
+{
+    SymbolIndex index;
+    index.invalidate({2});
+    index.invalidate({3});
+    index.invalidate({2});
+    index.setModule({3}, {function("a")});
+
+    auto stale = index.takeStale();
+    REQUIRE_EQ(stale.size(), 1);
+    CHECK_EQ(stale[0].value, 2);
+    CHECK(index.takeStale().empty());
+}
+
+TEST_SUITE_END();
@@ -6,6 +6,10 @@
 #include "LSP/Uri.hpp"
 #include "LSP/IostreamHelpers.hpp"
 
+#include <algorithm>
+#include <random>
+#include <thread>
+
 TextDocument newDocument(const std::string& content)
 {
     return TextDocument(Uri::parse("file://foo/bar"), "text", 0, content);
@@ -151,6 +155,38 @@ TEST_CASE("lspLength")
     CHECK_EQ(lspLength("😂"), 1UL);
 }
 
+TEST_CASE("lspLength matches decoding one codepoint at a time")
+{
+    // Decodes in the same lenient way as lspLength, without the fast path for runs of ASCII
+    auto referenceLength = [](const std::string& text, bool utf16)
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < text.size();)
+        {
+            auto c = static_cast<unsigned char>(text[i]);
+            size_t length = c < 0x80 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : (c & 0xF8) == 0xF0 ? 4 : 1;
+            count += utf16 && length == 4 ? 2 : 1;
+            i += length;
+        }
+        return count;
+    };
+
+    const std::string pieces[] = {"a", "local ", "\n", "\xC3\xA9", "\xE2\x86\x92", "\xF0\x9F\x98\x80", "\x80", "\xFF", std::string(40, 'x')};
+    std::mt19937 rng(42);
+    for (size_t iteration = 0; iteration < 2000; iteration++)
+    {
+        std::string text;
+        for (size_t count = rng() % 30; count > 0; count--)
+            text += pieces[rng() % std::size(pieces)];
+
+        positionEncoding() = lsp::PositionEncodingKind::UTF16;
+        REQUIRE_EQ(lspLength(text), referenceLength(text, true));
+        positionEncoding() = lsp::PositionEncodingKind::UTF32;
+        REQUIRE_EQ(lspLength(text), referenceLength(text, false));
+    }
+    positionEncoding() = lsp::PositionEncodingKind::UTF16;
+}
+
 TEST_CASE("PositionToOffset")
 {
     auto document = newDocument(R"(0:0 = 0
@@ -292,6 +328,68 @@ TEST_CASE("OffsetToPosition")
     CHECK_EQ(document.positionAt(30), lsp::Position{2, 11}); // "out of bounds";
 }
 
+TEST_CASE("Luau position conversion")
+{
+    auto document = newDocument("local a = 1\r\nlocal 🡆 = \"→\"\nreturn");
+    positionEncoding() = lsp::PositionEncodingKind::UTF16;
+
+    for (size_t offset = 0; offset <= document.getText().size(); offset++)
+    {
+        auto position = document.positionAt(offset);
+        auto utf8Position = document.convertPosition(position);
+        CHECK_EQ(document.convertPosition(utf8Position), position);
+    }
+
+    CHECK_EQ(document.convertPosition(Luau::Position{1, 6}), lsp::Position{1, 6});
+    CHECK_EQ(document.convertPosition(Luau::Position{1, 10}), lsp::Position{1, 8});
+    CHECK_EQ(document.convertPosition(Luau::Position{1, 14}), lsp::Position{1, 12});
+    CHECK_EQ(document.convertPosition(Luau::Position{1, 15}), lsp::Position{1, 13}); // Inside a codepoint
+    CHECK_EQ(document.convertPosition(lsp::Position{1, 12}), Luau::Position{1, 14});
+    CHECK_EQ(document.convertPosition(lsp::Position{1, 13}), Luau::Position{1, 17});
+    // A column past the end of the line continues into the next line
+    CHECK_EQ(document.convertPosition(Luau::Position{0, 16}), lsp::Position{0, 16});
+    CHECK_EQ(document.convertPosition(Luau::Position{0, 23}), lsp::Position{0, 21});
+    CHECK_EQ(document.convertPosition(Luau::Position{0, 27}), lsp::Position{0, 25});
+}
+
+TEST_CASE("Batched conversion matches converting one at a time")
+{
+    auto document = newDocument("local a = \"→→\"\nlocal 🡆, b = 🡆, \"é\"\n\nreturn a");
+    positionEncoding() = lsp::PositionEncodingKind::UTF16;
+
+    std::vector<Luau::Position> positions;
+    for (unsigned int line = 0; line < 5; line++)
+        for (unsigned int column = 0; column < 24; column++)
+            positions.emplace_back(line, column);
+
+    auto checkPositions = [&](const std::vector<Luau::Position>& positions)
+    {
+        auto converted = document.convertPositions(positions);
+        REQUIRE_EQ(converted.size(), positions.size());
+        for (size_t i = 0; i < positions.size(); i++)
+            CHECK_EQ(converted[i], document.convertPosition(positions[i]));
+    };
+
+    checkPositions(positions);
+
+    // Unsorted positions are still converted correctly
+    std::reverse(positions.begin(), positions.end());
+    checkPositions(positions);
+    std::mt19937 rng(42);
+    std::shuffle(positions.begin(), positions.end(), rng);
+    checkPositions(positions);
+
+    // Locations whose ends are not in order
+    std::vector<Luau::Location> locations{{{0, 0}, {1, 20}}, {{0, 11}, {0, 14}}, {{1, 6}, {1, 10}}, {{1, 6}, {3, 8}}, {{1, 15}, {1, 17}}};
+    auto ranges = document.convertLocations(locations);
+    REQUIRE_EQ(ranges.size(), locations.size());
+    for (size_t i = 0; i < locations.size(); i++)
+    {
+        CHECK_EQ(ranges[i].start, document.convertPosition(locations[i].begin));
+        CHECK_EQ(ranges[i].end, document.convertPosition(locations[i].end));
+    }
+}
+
 TEST_SUITE_END();
 
 TEST_SUITE_BEGIN("Text Document Full Updates");
@@ -647,6 +745,21 @@ TEST_CASE("Invalid update ranges")
     // assertValidLineNumbers(document);
 }
 
+TEST_CASE("Incremental updates around non-ASCII characters")
+{
+    positionEncoding() = lsp::PositionEncodingKind::UTF16;
+    auto document = newDocument("local s = \"🡆\"\nlocal t = \"→\"\n");
+    CHECK_EQ(document.positionAt(16), lsp::Position{0, 14});
+
+    // Positions in the later changes are measured against the text left by the earlier ones
+    document.update({{lsp::Range{{0, 11}, {0, 13}}, "→→"}, {lsp::Range{{0, 13}, {0, 13}}, "🡆"}, {lsp::Range{{1, 11}, {1, 12}}, ""}}, 1);
+    CHECK_EQ(document.getText(), "local s = \"→→🡆\"\nlocal t = \"\"\n");
+    CHECK_EQ(document.positionAt(21), lsp::Position{0, 15});
+    CHECK_EQ(document.offsetAt(lsp::Position{0, 15}), 21);
+    CHECK_EQ(document.offsetAt(lsp::Position{1, 12}), 35);
+    assertValidLineNumbers(document);
+}
+
 TEST_CASE("Insert at the end of the file")
 {
     auto lm = newDocument("foo\nbar");
@@ -655,4 +768,68 @@ TEST_CASE("Insert at the end of the file")
     assertValidLineNumbers(lm);
 }
 
-TEST_SUITE_END();
\ No newline at end of file
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("Text Document Snapshots");
+
+TEST_CASE("Updating a copy leaves the original unchanged")
+{
+    auto original = newDocument("local a = 1\nlocal 🡆 = 2\n");
+    positionEncoding() = lsp::PositionEncodingKind::UTF16;
+    CHECK_EQ(original.positionAt(22), lsp::Position{1, 8});
+
+    TextDocument updated = original;
+    updated.update({{lsp::Range{{1, 6}, {1, 8}}, "b"}}, 1);
+
+    CHECK_EQ(updated.getText(), "local a = 1\nlocal b = 2\n");
+    CHECK_EQ(updated.positionAt(15), lsp::Position{1, 3});
+    CHECK_EQ(original.getText(), "local a = 1\nlocal 🡆 = 2\n");
+    CHECK_EQ(original.version(), 0);
+    CHECK_EQ(original.positionAt(22), lsp::Position{1, 8});
+}
+
+TEST_CASE("Snapshots can be read concurrently whilst new versions are created")
+{
+    positionEncoding() = lsp::PositionEncodingKind::UTF16;
+    std::string text;
+    for (size_t i = 0; i < 2000; i++)
+        text += "local value" + std::to_string(i) + " = \"→\"\n";
+
+    TextDocumentSnapshot snapshot = std::make_shared<TextDocument>(newDocument(text));
+
+    std::vector<std::thread> readers;
+    std::vector<int> consistent(4, 0);
+    for (size_t reader = 0; reader < consistent.size(); reader++)
+    {
+        readers.emplace_back(
+            [&, reader]
+            {
+                bool ok = snapshot->getText() == text;
+                for (size_t line = 0; line < 2000; line += 7)
+                {
+                    // Every line ends with a 3 byte (but single UTF-16 unit) character, then `"\n`
+                    auto lineText = snapshot->getLine(line);
+                    ok = ok && snapshot->positionAt(snapshot->getLineOffsets()[line] + lineText.size()) == lsp::Position{line, lineText.size() - 2};
+                }
+                consistent[reader] = ok;
+            });
+    }
+
+    TextDocumentSnapshot current = snapshot;
+    for (size_t version = 1; version <= 50; version++)
+    {
+        auto next = std::make_shared<TextDocument>(*current);
+        next->update({{lsp::Range{{0, 0}, {0, 0}}, "-- edit\n"}}, version);
+        current = std::move(next);
+    }
+
+    for (auto& thread : readers)
+        thread.join();
+
+    for (int ok : consistent)
+        CHECK(ok);
+    CHECK_EQ(current->lineCount(), 2051);
+    CHECK_EQ(snapshot->getText(), text);
+}
+
+TEST_SUITE_END();
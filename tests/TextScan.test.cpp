@@ -0,0 +1,89 @@
+#include "doctest.h"
+#include "LSP/TextScan.hpp"
+
+#include <random>
+#include <string>
+
+static size_t findReference(std::string_view text, bool lineBreaks, bool nonAscii)
+{
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        auto c = static_cast<unsigned char>(text[i]);
+        if ((lineBreaks && (c == '\r' || c == '\n')) || (nonAscii && c >= 0x80))
+            return i;
+    }
+    return text.size();
+}
+
+static void checkAllKernels(std::string_view text)
+{
+    REQUIRE_EQ(text_scan::findLineBreak(text), findReference(text, true, false));
+    REQUIRE_EQ(text_scan::findNonAscii(text), findReference(text, false, true));
+    REQUIRE_EQ(text_scan::findLineBreakOrNonAscii(text), findReference(text, true, true));
+}
+
+TEST_SUITE_BEGIN("TextScan");
+
+TEST_CASE("empty_text_has_no_matches")
+{
+    CHECK_EQ(text_scan::findLineBreak(""), 0);
+    CHECK_EQ(text_scan::findNonAscii(""), 0);
+    CHECK_EQ(text_scan::findLineBreakOrNonAscii(""), 0);
+}
+
+TEST_CASE("finds_a_match_at_every_position_of_a_block")
+{
+    // Covers every lane of the 32 byte, 16 byte and 8 byte steps, as well as the byte-at-a-time tail
+    for (size_t length = 1; length <= 80; length++)
+    {
+        for (size_t position = 0; position < length; position++)
+        {
+            for (char c : {'\r', '\n', '\x80', '\xFF', '\xC3'})
+            {
+                std::string text(length, 'a');
+                text[position] = c;
+                checkAllKernels(text);
+            }
+        }
+    }
+}
+
+TEST_CASE("bytes_adjacent_to_matches_are_not_matched")
+{
+    // Bytes which differ from `\r` or `\n` by one, or only in the high bit, could be confused by a word-at-a-time scan
+    for (char c : {'\x0B', '\x0C', '\x0E', '\x09', '\x8A', '\x8D', '\x7F', '\x00', '\x01'})
+    {
+        std::string text(64, c);
+        checkAllKernels(text);
+        text[40] = '\n';
+        checkAllKernels(text);
+    }
+}
+
+TEST_CASE("random_text_matches_reference")
+{
+    std::mt19937 rng(1234);
+    for (size_t iteration = 0; iteration < 5000; iteration++)
+    {
+        std::string text(rng() % 200, 'a');
+        // Sparse matches, so that most blocks are skipped entirely
+        for (char& c : text)
+        {
+            auto roll = rng() % 100;
+            if (roll == 0)
+                c = '\n';
+            else if (roll == 1)
+                c = '\r';
+            else if (roll == 2)
+                c = static_cast<char>(0x80 + rng() % 0x80);
+            else
+                c = static_cast<char>(rng() % 0x80);
+        }
+
+        // Scan from every alignment, so that unaligned loads are exercised
+        size_t start = rng() % (text.size() + 1);
+        checkAllKernels(std::string_view(text).substr(start));
+    }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,102 @@
+#include "doctest.h"
+#include "LSP/ThreadPool.hpp"
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+TEST_SUITE_BEGIN("ThreadPool");
+
+TEST_CASE("a thread count of 0 uses at least one thread")
+{
+    ThreadPool pool(0);
+    CHECK_GE(pool.size(), 1);
+}
+
+TEST_CASE("submitted tasks are run")
+{
+    ThreadPool pool(2);
+    std::promise<int> result;
+    pool.submit(
+        [&]()
+        {
+            result.set_value(42);
+        });
+    CHECK_EQ(result.get_future().get(), 42);
+}
+
+TEST_CASE("parallelFor runs every index exactly once")
+{
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> counts(1000);
+    pool.parallelFor(counts.size(),
+        [&](size_t index, size_t)
+        {
+            counts[index]++;
+        });
+
+    for (const auto& count : counts)
+        CHECK_EQ(count.load(), 1);
+}
+
+TEST_CASE("parallelFor never runs the same worker concurrently")
+{
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> active(pool.size());
+    std::atomic<bool> overlapped = false;
+    pool.parallelFor(2000,
+        [&](size_t, size_t worker)
+        {
+            REQUIRE_LT(worker, pool.size());
+            if (active[worker]++ != 0)
+                overlapped = true;
+            active[worker]--;
+        });
+
+    CHECK_FALSE(overlapped.load());
+}
+
+TEST_CASE("parallelFor with no work returns immediately")
+{
+    ThreadPool pool(2);
+    bool called = false;
+    pool.parallelFor(0,
+        [&](size_t, size_t)
+        {
+            called = true;
+        });
+    CHECK_FALSE(called);
+}
+
+TEST_CASE("parallelFor rethrows once all tasks have finished")
+{
+    ThreadPool pool(3);
+    std::atomic<size_t> completed = 0;
+    CHECK_THROWS_AS(pool.parallelFor(100,
+                        [&](size_t index, size_t)
+                        {
+                            completed++;
+                            if (index == 10)
+                                throw std::runtime_error("failed");
+                        }),
+        std::runtime_error);
+    CHECK_EQ(completed.load(), 100);
+}
+
+TEST_CASE("the pool finishes queued tasks before being destroyed")
+{
+    std::atomic<int> count = 0;
+    {
+        ThreadPool pool(1);
+        for (int i = 0; i < 100; i++)
+            pool.submit(
+                [&]()
+                {
+                    count++;
+                });
+    }
+    CHECK_EQ(count.load(), 100);
+}
+
+TEST_SUITE_END();
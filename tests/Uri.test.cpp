@@ -507,4 +507,35 @@ TEST_CASE("luau-lsp custom: encodeURIComponent #555")
             "file:///home/leoni/OneDrive/%D0%A0%D0%B0%D0%B1%D0%BE%D1%87%D0%B8%D0%B9%20%D1%81%D1%82%D0%BE%D0%BB/Creations/RobloxProjects/Nelsk"));
 }
 
+TEST_CASE("luau-lsp custom: parse keeps invalid percent escapes")
+{
+    auto value = Uri::parse("file:///c:/100%/%zz/%4/%41");
+    CHECK_EQ(value.path, "/c:/100%/%zz/%4/A");
+}
+
+TEST_CASE("luau-lsp custom: normalisedFile matches a round trip through a string")
+{
+    std::vector<std::string> paths = {
+        "C:/Users/Test/file.luau",
+        "/C:/Users/Test/file.luau",
+        "c:/Users/Test/file.luau",
+        "/home/user/my project/#file?.luau",
+        "/home/user/100%/file%20name.luau",
+        "//Server.Local/Share/Folder/file.luau",
+        "//User@Server/Share",
+        "",
+    };
+
+    for (const auto& path : paths)
+    {
+        auto expected = Uri::parse(Uri::file(path).toString());
+        auto actual = Uri::normalisedFile(path);
+        CHECK_EQ(actual.scheme, expected.scheme);
+        CHECK_EQ(actual.authority, expected.authority);
+        CHECK_EQ(actual.path, expected.path);
+        CHECK_EQ(actual.fsPath(), expected.fsPath());
+        CHECK_EQ(actual.toString(), expected.toString());
+    }
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,118 @@
+#include "doctest.h"
+#include "Fixture.h"
+
+#include "LSP/MessageQueue.hpp"
+
+/// More files than are type checked together in one workspace diagnostics batch
+static constexpr size_t kFileCount = 100;
+
+static std::string fileName(size_t index)
+{
+    return "module" + std::to_string(index) + ".luau";
+}
+
+/// Each module requires the one before it and the one at half its index, so the require graph is a DAG several levels deep.
+/// Every fifth module has a type error from a required value, and every seventh has an unused local
+static std::vector<Uri> openRequireGraph(Fixture& fixture)
+{
+    std::vector<Uri> files;
+    for (size_t i = 0; i < kFileCount; i++)
+    {
+        std::string source = "--!strict\n";
+        if (i > 0)
+        {
+            source += "local previous = require(\"/" + fileName(i - 1) + "\")\n";
+            source += "local half = require(\"/" + fileName(i / 2) + "\")\n";
+            source += (i % 5 == 0 ? "local value: string = previous.value + half.value\n" : "local value: number = previous.value + half.value\n");
+        }
+        else
+            source += "local value = 1\n";
+
+        if (i % 7 == 0)
+            source += "local unused = 1\n";
+
+        source += "return { value = value }\n";
+        files.push_back(fixture.newDocument(fileName(i), source));
+    }
+    return files;
+}
+
+static ClientConfiguration workspaceDiagnosticsConfiguration(bool parallel)
+{
+    auto config = Luau::LanguageServer::defaultTestClientConfiguration();
+    config.diagnostics.workspace = true;
+    // Expressive datamodel types share an arena between modules, so the Roblox platform checks them without an executor
+    config.diagnostics.strictDatamodelTypes = !parallel;
+    return config;
+}
+
+static std::vector<json> reports(Fixture& fixture, const std::vector<Uri>& files, const ClientConfiguration& config)
+{
+    std::vector<json> result;
+    for (const auto& uri : files)
+        if (auto report = fixture.workspace.workspaceDocumentDiagnostics(uri, config))
+            result.emplace_back(*report);
+    return result;
+}
+
+TEST_SUITE_BEGIN("WorkspaceDiagnostics");
+
+TEST_CASE("reports from batched checking match checking each file in turn")
+{
+    Fixture serial;
+    auto serialFiles = openRequireGraph(serial);
+    auto expected = reports(serial, serialFiles, workspaceDiagnosticsConfiguration(/* parallel: */ false));
+    REQUIRE_EQ(expected.size(), kFileCount);
+    CHECK_FALSE(expected[5]["items"].empty());
+    CHECK_FALSE(expected[7]["items"].empty());
+    CHECK(expected[1]["items"].empty());
+
+    for (bool parallel : {false, true})
+    {
+        CAPTURE(parallel);
+        auto config = workspaceDiagnosticsConfiguration(parallel);
+
+        Fixture batched;
+        auto files = openRequireGraph(batched);
+        batched.workspace.checkWorkspaceFiles(files, config);
+        CHECK(batched.workspace.frontend.moduleQueue.empty());
+
+        for (const auto& uri : files)
+            CHECK_FALSE(batched.workspace.frontend.isDirty(batched.workspace.fileResolver.getModuleName(uri)));
+
+        auto actual = reports(batched, files, config);
+        REQUIRE_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); i++)
+            CHECK_EQ(actual[i].dump(), expected[i].dump());
+    }
+}
+
+TEST_CASE("cancelling batched checking stops it part way")
+{
+    for (bool parallel : {false, true})
+    {
+        CAPTURE(parallel);
+
+        Fixture fixture;
+        auto files = openRequireGraph(fixture);
+
+        // The cancellation is only seen once the first module has been checked, as it would be if it arrived during the batch
+        auto cancellationToken = std::make_shared<Luau::FrontendCancellationToken>();
+        cancellationToken->cancel();
+
+        try
+        {
+            fixture.workspace.checkWorkspaceFiles(files, workspaceDiagnosticsConfiguration(parallel), cancellationToken);
+            FAIL("checking was not cancelled");
+        }
+        catch (const JsonRpcException& e)
+        {
+            CHECK_EQ(e.code, lsp::ErrorCode::RequestCancelled);
+        }
+
+        CHECK(fixture.workspace.frontend.moduleQueue.empty());
+        CHECK(fixture.workspace.frontend.isDirty(fixture.workspace.fileResolver.getModuleName(files.back())));
+    }
+}
+
+TEST_SUITE_END();
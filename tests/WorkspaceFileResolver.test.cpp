@@ -5,6 +5,8 @@
 #include "Luau/Ast.h"
 #include "Luau/FileResolver.h"
 
+#include <fstream>
+
 TEST_SUITE_BEGIN("WorkspaceFileResolverTests");
 
 TEST_CASE("resolveModule handles LocalPlayer PlayerScripts")
@@ -188,4 +190,26 @@ TEST_CASE_FIXTURE(Fixture, "string_require_resolves_relative_to_file")
     CHECK_EQ(Luau::toString(requireType(getModule(moduleName), "other")), "number");
 }
 
+TEST_CASE_FIXTURE(Fixture, "string require resolves a file created after it first failed to resolve")
+{
+    auto directory = std::filesystem::temp_directory_path() / "luau-lsp-created-require-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    std::ofstream(directory / "main.luau") << "return require(\"./created\")";
+
+    // The test client does not report file changes, so nothing would clear cached lookups of the missing file
+    Luau::ModuleInfo context{workspace.fileResolver.getModuleName(Uri::file(directory / "main.luau"))};
+    auto before = workspace.platform->resolveStringRequire(&context, "./created");
+    REQUIRE(before.has_value());
+    CHECK(endsWith(before->name, "/created.lua"));
+
+    std::ofstream(directory / "created.luau") << "return {}";
+    auto after = workspace.platform->resolveStringRequire(&context, "./created");
+    REQUIRE(after.has_value());
+    CHECK(endsWith(after->name, "/created.luau"));
+
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+}
+
 TEST_SUITE_END();